@@ -0,0 +1,42 @@
+#ifndef StPicoCharmEventHeader__h
+#define StPicoCharmEventHeader__h
+
+/* **************************************************
+ *  Compact per-event header used by the sparse
+ *  storage mode of StPicoCharmMaker.
+ *
+ *  One header is stored for every picoDst event in
+ *  tree "H". Candidate events (StPicoD0Event or
+ *  StPicoKPiXEvent) are stored only for events with
+ *  candidates, candidateEntry points to their entry
+ *  in the candidate tree of the same file, -1 if none.
+ *  eventSelection holds the StPicoD0Event::eEventSelection
+ *  bits of the production, 0 in files without them.
+ *
+ *  Authors:  **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include "Rtypes.h"
+
+struct StPicoCharmEventHeader
+{
+  Int_t    runId;
+  Int_t    eventId;
+  Int_t    nKaons;
+  Int_t    nPions;
+  Long64_t candidateEntry;
+  UInt_t   eventSelection;
+  Float_t  vz;
+  Float_t  vzVpd;
+
+  StPicoCharmEventHeader() : runId(-1), eventId(-1), nKaons(0), nPions(0), candidateEntry(-1),
+    eventSelection(0), vz(-999.), vzVpd(-999.) {}
+
+  static char const* leafList() { return "runId/I:eventId/I:nKaons/I:nPions/I:candidateEntry/L:eventSelection/i:vz/F:vzVpd/F"; }
+  static char const* treeName() { return "H"; }
+};
+#endif
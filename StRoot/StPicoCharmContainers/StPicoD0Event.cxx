@@ -1,18 +1,25 @@
 #include "StPicoDstMaker/StPicoEvent.h"
 #include "StPicoDstMaker/StPicoTrack.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
 
 #include "StPicoD0Event.h"
 #include "StKaonPion.h"
+#include "StPicoCharmEventHeader.h"
 
 ClassImp(StPicoD0Event)
 
-TClonesArray *StPicoD0Event::fgKaonPionArray = 0;
+//-----------------------------------------------------------------------
+StPicoD0Event::StPicoD0Event() : mRunId(-1), mEventId(-1), mKfVertex(), mVz(-999.), mVzVpd(-999.), mEventSelection(0), mNKaonPion(0), mNKaons(0), mNPions(0), mNDaughterTracks(0),
+   mKaonPionArray(new TClonesArray("StKaonPion")), mDaughterTrackArray(new TClonesArray("StPicoDaughterTrack"))
+{
+}
 
 //-----------------------------------------------------------------------
-StPicoD0Event::StPicoD0Event() : mRunId(-1), mEventId(-1), mKfVertex(), mNKaonPion(0), mNKaons(0), mNPions(0), mKaonPionArray(NULL)
+StPicoD0Event::~StPicoD0Event()
 {
-   if (!fgKaonPionArray) fgKaonPionArray = new TClonesArray("StKaonPion");
-   mKaonPionArray = fgKaonPionArray;
+   clear("C");
+   delete mKaonPionArray;
+   delete mDaughterTrackArray;
 }
 
 //-----------------------------------------------------------------------
@@ -21,24 +28,54 @@ void StPicoD0Event::addPicoEvent(StPicoEvent const & picoEvent, StThreeVectorF c
    // StPicoEvent variables
    mRunId = picoEvent.runId();
    mEventId = picoEvent.eventId();
+   mVz = picoEvent.primaryVertex().z();
+   mVzVpd = picoEvent.vzVpd();
 
    if(kfVertex) mKfVertex = *kfVertex;
    else mKfVertex.set(-999.,-999.,-999.);
 }
 
+//-----------------------------------------------------------------------
+void StPicoD0Event::addEventHeader(StPicoCharmEventHeader const& header)
+{
+   // used for events without candidates in sparse picoD0 files
+   mRunId = header.runId;
+   mEventId = header.eventId;
+   mNKaons = header.nKaons;
+   mNPions = header.nPions;
+   mVz = header.vz;
+   mVzVpd = header.vzVpd;
+   mEventSelection = header.eventSelection;
+}
+
 //-----------------------------------------------------------------------
 void StPicoD0Event::clear(char const *option)
 {
    mKaonPionArray->Clear(option);
+   mDaughterTrackArray->Clear(option);
    mRunId = -1;
    mEventId = -1;
    mKfVertex.set(-999.,-999.,-999.);
+   mVz = -999.;
+   mVzVpd = -999.;
+   mEventSelection = 0;
    mNKaonPion = 0;
    mNKaons = 0;
    mNPions = 0;
+   mNDaughterTracks = 0;
 }
 //---------------------------------------------------------------------
 void StPicoD0Event::addKaonPion(StKaonPion const& t)
 {
    new((*mKaonPionArray)[mNKaonPion++]) StKaonPion(t);
 }
+//---------------------------------------------------------------------
+void StPicoD0Event::addDaughterTrack(StPicoDaughterTrack const& t)
+{
+   new((*mDaughterTrackArray)[mNDaughterTracks++]) StPicoDaughterTrack(t);
+}
+//---------------------------------------------------------------------
+StPicoDaughterTrack const* StPicoD0Event::daughterTrack(unsigned short const idx) const
+{
+   return StPicoDaughterTrack::find(mDaughterTrackArray, mNDaughterTracks, idx);
+}
@@ -5,6 +5,10 @@
  *  A specialized class for storing eventwise D0
  *  candidates. 
  *
+ *  Optionally holds a StPicoDaughterTrack snapshot of
+ *  every kaon and pion used by the candidates, found by
+ *  daughterTrack(kaonIdx()) and daughterTrack(pionIdx()).
+ *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            **Mustafa Mustafa (mmustafa@lbl.gov)
  *
@@ -20,43 +24,70 @@ class StPicoEvent;
 #include "StThreeVectorF.hh"
 
 class StKaonPion;
+class StPicoDaughterTrack;
+struct StPicoCharmEventHeader;
 
 class StPicoD0Event : public TObject
 {
 public:
+   // event selection of the picoD0 production, for analyses without the picoDst
+   enum eEventSelection { kSelectionStored = 0x1, kGoodTrigger = 0x2 };
+
    StPicoD0Event();
-   ~StPicoD0Event(){ clear("C");}
+   ~StPicoD0Event();
    void    clear(char const *option = "");
    void    addPicoEvent(StPicoEvent const& picoEvent, StThreeVectorF const* kfVertex = NULL);
+   void    addEventHeader(StPicoCharmEventHeader const&);
    void    addKaonPion(StKaonPion const&);
+   void    addDaughterTrack(StPicoDaughterTrack const&); // in increasing picoDst index
    void    nKaons(int);
    void    nPions(int);
+   void    eventSelection(unsigned int bits); // kGoodTrigger, kSelectionStored is added
 
    Int_t   runId()   const;
    Int_t   eventId() const;
+   float   vz()      const;
+   float   vzVpd()   const;
+   unsigned int eventSelection() const;
+   bool    hasEventSelection() const; // false for picoD0 files before version 3
+   bool    isGoodTrigger() const;
    TClonesArray const* kaonPionArray()   const;
    int     nKaonPion()  const;
    int     nKaons() const;
    int     nPions() const;
    StThreeVectorF const& kfVertex() const;
 
+   TClonesArray const* daughterTrackArray() const;
+   int     nDaughterTracks() const;
+   StPicoDaughterTrack const* daughterTrack(unsigned short idx) const; // NULL if not stored
+
 private:
    // some variables below are kept in ROOT types to match the same ones in StPicoEvent
    Int_t   mRunId;           // run number
    Int_t   mEventId;         // event number
    StThreeVectorF mKfVertex;
+   Float_t mVz;              // primary vertex z
+   Float_t mVzVpd;
+   UInt_t  mEventSelection;  // eEventSelection bits
    int   mNKaonPion;       // number of stored pairs
    int   mNKaons;
    int   mNPions;
 
+   int   mNDaughterTracks;
+
+   // owned by each event, the events of parallel readers must not share them
    TClonesArray*        mKaonPionArray;
-   static TClonesArray* fgKaonPionArray;
+   TClonesArray*        mDaughterTrackArray;
+
+   StPicoD0Event(StPicoD0Event const&);
+   StPicoD0Event& operator=(StPicoD0Event const&);
 
-   ClassDef(StPicoD0Event, 1)
+   ClassDef(StPicoD0Event, 3)
 };
 
 inline void StPicoD0Event::nKaons(int n) { mNKaons = n; }
 inline void StPicoD0Event::nPions(int n) { mNPions = n; }
+inline void StPicoD0Event::eventSelection(unsigned int bits) { mEventSelection = kSelectionStored | bits; }
 
 inline TClonesArray const * StPicoD0Event::kaonPionArray()   const { return mKaonPionArray;}
 inline int   StPicoD0Event::nKaonPion()  const { return mNKaonPion;}
@@ -64,5 +95,12 @@ inline int   StPicoD0Event::nKaons()  const { return mNKaons;}
 inline int   StPicoD0Event::nPions()  const { return mNPions;}
 inline Int_t StPicoD0Event::runId()   const { return mRunId; }
 inline Int_t StPicoD0Event::eventId() const { return mEventId; }
+inline float StPicoD0Event::vz()      const { return mVz; }
+inline float StPicoD0Event::vzVpd()   const { return mVzVpd; }
+inline unsigned int StPicoD0Event::eventSelection() const { return mEventSelection; }
+inline bool  StPicoD0Event::hasEventSelection() const { return mEventSelection & kSelectionStored; }
+inline bool  StPicoD0Event::isGoodTrigger() const { return mEventSelection & kGoodTrigger; }
 inline StThreeVectorF const& StPicoD0Event::kfVertex() const { return mKfVertex; }
+inline TClonesArray const * StPicoD0Event::daughterTrackArray() const { return mDaughterTrackArray;}
+inline int   StPicoD0Event::nDaughterTracks() const { return mNDaughterTracks;}
 #endif
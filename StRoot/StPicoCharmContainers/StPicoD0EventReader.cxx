@@ -0,0 +1,121 @@
+#include "TFile.h"
+#include "TChain.h"
+#include "TTree.h"
+#include "TError.h"
+
+#include "StPicoCutsBase/StPicoChainReader.h"
+#include "StPicoD0Event.h"
+#include "StPicoD0EventReader.h"
+
+//-----------------------------------------------------------------------
+StPicoD0EventReader::StPicoD0EventReader() : mCandidateChain(NULL), mHeaderChain(NULL), mCandidateReader(NULL), mPicoD0Event(NULL), mHeader(),
+  mSparse(false), mFirstFile(true), mNEvents(0), mNEventsRead(0), mNCandidateEventsRead(0), mBytesRead(0)
+{
+  mCandidateChain = new TChain("T");
+  mHeaderChain = new TChain(StPicoCharmEventHeader::treeName());
+  mCandidateReader = new StPicoChainReader("picoD0 candidates");
+  mTimer.Reset();
+}
+//-----------------------------------------------------------------------
+StPicoD0EventReader::~StPicoD0EventReader()
+{
+  delete mCandidateReader;
+  delete mHeaderChain;
+  delete mCandidateChain;
+  delete mPicoD0Event;
+}
+//-----------------------------------------------------------------------
+void StPicoD0EventReader::addFile(char const* fileName)
+{
+  if(mFirstFile)
+  {
+    // the storage mode is decided by the first file, all files of a production share it
+    TFile* file = TFile::Open(fileName);
+    mSparse = file && file->Get(StPicoCharmEventHeader::treeName());
+    delete file;
+    mFirstFile = false;
+  }
+
+  mCandidateChain->Add(fileName);
+  if(mSparse) mHeaderChain->Add(fileName);
+}
+//-----------------------------------------------------------------------
+bool StPicoD0EventReader::init()
+{
+  if(!mCandidateChain->GetBranch("dEvent"))
+  {
+    Error("StPicoD0EventReader::init", "no dEvent branch in the picoD0 files");
+    return false;
+  }
+
+  mPicoD0Event = new StPicoD0Event();
+  mCandidateChain->GetBranch("dEvent")->SetAutoDelete(kFALSE);
+  mCandidateChain->SetBranchAddress("dEvent", &mPicoD0Event);
+
+  // loads all trees and fills the tree offsets used to resolve candidateEntry
+  Long64_t const nCandidateEvents = mCandidateChain->GetEntries();
+
+  if(mSparse)
+  {
+    mHeaderChain->SetBranchAddress("header", &mHeader);
+    mNEvents = mHeaderChain->GetEntries();
+  }
+  else mNEvents = nCandidateEvents;
+
+  mCandidateReader->init(mCandidateChain);
+
+  Info("StPicoD0EventReader::init", "%s storage, %lld events, %lld candidate events",
+       mSparse ? "sparse" : "dense", mNEvents, nCandidateEvents);
+
+  return true;
+}
+//-----------------------------------------------------------------------
+bool StPicoD0EventReader::readEvent(Long64_t const entry)
+{
+  mTimer.Start(kFALSE);
+
+  Int_t nBytes = 0;
+  if(!mSparse)
+  {
+    nBytes = mCandidateReader->getEntry(entry);
+    ++mNCandidateEventsRead;
+  }
+  else
+  {
+    nBytes = mHeaderChain->GetEntry(entry);
+
+    if(nBytes > 0 && mHeader.candidateEntry >= 0)
+    {
+      Long64_t const offset = mCandidateChain->GetTreeOffset()[mHeaderChain->GetTreeNumber()];
+      Int_t const nCandidateBytes = mCandidateReader->getEntry(offset + mHeader.candidateEntry);
+      nBytes = nCandidateBytes > 0 ? nBytes + nCandidateBytes : nCandidateBytes;
+      ++mNCandidateEventsRead;
+    }
+    else if(nBytes > 0)
+    {
+      mPicoD0Event->clear("C");
+      mPicoD0Event->addEventHeader(mHeader);
+    }
+  }
+
+  mTimer.Stop();
+
+  if(nBytes <= 0) return false;
+
+  ++mNEventsRead;
+  mBytesRead += nBytes;
+  return true;
+}
+//-----------------------------------------------------------------------
+void StPicoD0EventReader::printStats() const
+{
+  double const realTime = mTimer.RealTime();
+  TFile const* file = mCandidateChain->GetFile();
+
+  Info("StPicoD0EventReader", "%s storage: read %lld events (%lld candidate events), %.2f MB unzipped in %.2f s, %.1f events/s",
+       mSparse ? "sparse" : "dense", mNEventsRead, mNCandidateEventsRead, mBytesRead / 1024. / 1024., realTime,
+       realTime > 0 ? mNEventsRead / realTime : 0.);
+  if(file) Info("StPicoD0EventReader", "last file %s, size %lld bytes", file->GetName(), file->GetSize());
+
+  mCandidateReader->printStats();
+}
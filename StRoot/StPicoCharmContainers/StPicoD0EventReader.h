@@ -0,0 +1,68 @@
+#ifndef StPicoD0EventReader__h
+#define StPicoD0EventReader__h
+
+/* **************************************************
+ *  A reader for picoD0 files which hides the storage
+ *  mode of StPicoCharmMaker.
+ *
+ *  Dense files have one StPicoD0Event per picoDst event
+ *  in tree "T". Sparse files additionally have the event
+ *  header tree "H" and "T" holds only events with
+ *  candidates. In both cases readEvent(i) returns the
+ *  StPicoD0Event of the i-th picoDst event.
+ *
+ *  The candidate tree is read through a StPicoChainReader,
+ *  configure its cache and branches with chainReader()
+ *  before init().
+ *
+ *  Authors:  **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include "TStopwatch.h"
+#include "StPicoCharmEventHeader.h"
+
+class TChain;
+class StPicoChainReader;
+class StPicoD0Event;
+
+class StPicoD0EventReader
+{
+  public:
+   StPicoD0EventReader();
+   ~StPicoD0EventReader();
+
+   void addFile(char const* fileName);
+   bool init();
+
+   Long64_t getEntries() const;
+   bool readEvent(Long64_t entry);
+   bool isSparse() const;
+   StPicoD0Event const* event() const;
+   StPicoChainReader* chainReader() const;
+
+   void printStats() const;
+
+  private:
+   TChain* mCandidateChain;
+   TChain* mHeaderChain;
+   StPicoChainReader* mCandidateReader;
+   StPicoD0Event* mPicoD0Event;
+   StPicoCharmEventHeader mHeader;
+
+   bool mSparse;
+   bool mFirstFile;
+   Long64_t mNEvents;
+   Long64_t mNEventsRead;
+   Long64_t mNCandidateEventsRead;
+   Long64_t mBytesRead;
+   TStopwatch mTimer;
+};
+inline bool StPicoD0EventReader::isSparse() const { return mSparse; }
+inline StPicoD0Event const* StPicoD0EventReader::event() const { return mPicoD0Event; }
+inline Long64_t StPicoD0EventReader::getEntries() const { return mNEvents; }
+inline StPicoChainReader* StPicoD0EventReader::chainReader() const { return mCandidateReader; }
+#endif
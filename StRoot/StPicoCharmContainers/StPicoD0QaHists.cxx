@@ -17,7 +17,7 @@ StPicoD0QaHists::StPicoD0QaHists(std::string fileBaseName, std::string prescaleD
   mh2CosThetaVsPt(NULL), mh2DcaDaughtersVsPt(NULL),
   mh2InvariantMassVsPtUnlike(NULL), mh2InvariantMassVsPtLike(NULL)
 {
-  mPrescales = new StPicoPrescales(prescaleDirectoy);
+  mPrescales = StPicoPrescales::instance(prescaleDirectoy);
 
   mOutFile = new TFile(Form("%s.picoD0.hists.root",fileBaseName.c_str()),"RECREATE");
 
@@ -39,7 +39,7 @@ StPicoD0QaHists::StPicoD0QaHists(std::string fileBaseName, std::string prescaleD
 }
 StPicoD0QaHists::~StPicoD0QaHists()
 {
-  delete mPrescales;
+  // mPrescales is shared and owned by StPicoPrescales
   // note that histograms are owned by mOutFile. They will be destructed 
   // when the file is closed.
 }
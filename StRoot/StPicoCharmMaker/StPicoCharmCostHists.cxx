@@ -0,0 +1,71 @@
+#include <cmath>
+#include <algorithm>
+#include "TH1F.h"
+#include "TH2F.h"
+#include "TProfile.h"
+#include "TFile.h"
+
+#include "StPicoCharmCostHists.h"
+
+//-----------------------------------------------------------------------
+StPicoCharmCostHists::StPicoCharmCostHists(std::string fileBaseName) : mOutFile(NULL),
+  mh1GRefMult(NULL), mh1DeferredGRefMult(NULL),
+  mp1NKaonsVsGRefMult(NULL), mp1NPionsVsGRefMult(NULL), mp1NProtonsVsGRefMult(NULL),
+  mp1NPairsVsGRefMult(NULL), mp1NTripletsVsGRefMult(NULL), mp1EstimatedCostVsGRefMult(NULL),
+  mp1TimeVsGRefMult(NULL), mh2TimeVsGRefMult(NULL), mh2TimeVsNTriplets(NULL)
+{
+  mOutFile = new TFile(Form("%s.charmCost.hists.root",fileBaseName.c_str()),"RECREATE");
+
+  TH1::SetDefaultSumw2();
+  mh1GRefMult = new TH1F("mh1GRefMult","events;gRefMult;events",160,0,800);
+  mh1DeferredGRefMult = new TH1F("mh1DeferredGRefMult","events with deferred K#piX;gRefMult;events",160,0,800);
+  mp1NKaonsVsGRefMult = new TProfile("mp1NKaonsVsGRefMult","nKaonsVsGRefMult;gRefMult;<nKaons>",160,0,800);
+  mp1NPionsVsGRefMult = new TProfile("mp1NPionsVsGRefMult","nPionsVsGRefMult;gRefMult;<nPions>",160,0,800);
+  mp1NProtonsVsGRefMult = new TProfile("mp1NProtonsVsGRefMult","nProtonsVsGRefMult;gRefMult;<nProtons>",160,0,800);
+  mp1NPairsVsGRefMult = new TProfile("mp1NPairsVsGRefMult","nPairsVsGRefMult;gRefMult;<K#pi pairs tried>",160,0,800);
+  mp1NTripletsVsGRefMult = new TProfile("mp1NTripletsVsGRefMult","nTripletsVsGRefMult;gRefMult;<K#piX triplets tried>",160,0,800);
+  mp1EstimatedCostVsGRefMult = new TProfile("mp1EstimatedCostVsGRefMult","estimatedCostVsGRefMult;gRefMult;<estimated K#piX cost>",160,0,800);
+  mp1TimeVsGRefMult = new TProfile("mp1TimeVsGRefMult","timeVsGRefMult;gRefMult;<time> (ms)",160,0,800);
+  mh2TimeVsGRefMult = new TH2F("mh2TimeVsGRefMult","timeVsGRefMult;gRefMult;log_{10}(time/ms)",160,0,800,100,-2,4);
+  mh2TimeVsNTriplets = new TH2F("mh2TimeVsNTriplets","timeVsNTriplets;log_{10}(K#piX triplets tried);log_{10}(time/ms)",80,0,8,100,-2,4);
+}
+StPicoCharmCostHists::~StPicoCharmCostHists()
+{
+  // note that histograms are owned by mOutFile. They will be destructed 
+  // when the file is closed.
+}
+//-----------------------------------------------------------------------
+void StPicoCharmCostHists::addEvent(int const gRefMult, StCharmEventCost const& cost)
+{
+  double const timeMs = 1000. * cost.realTime;
+  double const logTime = std::log10(std::max(timeMs, 1e-3));
+
+  mh1GRefMult->Fill(gRefMult);
+  if(cost.deferred) mh1DeferredGRefMult->Fill(gRefMult);
+  mp1NKaonsVsGRefMult->Fill(gRefMult, cost.nKaons);
+  mp1NPionsVsGRefMult->Fill(gRefMult, cost.nPions);
+  mp1NProtonsVsGRefMult->Fill(gRefMult, cost.nProtons);
+  mp1NPairsVsGRefMult->Fill(gRefMult, cost.nPairs);
+  mp1NTripletsVsGRefMult->Fill(gRefMult, cost.nTriplets);
+  mp1EstimatedCostVsGRefMult->Fill(gRefMult, cost.estimatedCost);
+  mp1TimeVsGRefMult->Fill(gRefMult, timeMs);
+  mh2TimeVsGRefMult->Fill(gRefMult, logTime);
+  mh2TimeVsNTriplets->Fill(std::log10(std::max(cost.nTriplets, 1L)), logTime);
+}
+//---------------------------------------------------------------------
+void StPicoCharmCostHists::closeFile()
+{
+  mOutFile->cd();
+  mh1GRefMult->Write();
+  mh1DeferredGRefMult->Write();
+  mp1NKaonsVsGRefMult->Write();
+  mp1NPionsVsGRefMult->Write();
+  mp1NProtonsVsGRefMult->Write();
+  mp1NPairsVsGRefMult->Write();
+  mp1NTripletsVsGRefMult->Write();
+  mp1EstimatedCostVsGRefMult->Write();
+  mp1TimeVsGRefMult->Write();
+  mh2TimeVsGRefMult->Write();
+  mh2TimeVsNTriplets->Write();
+  mOutFile->Close();
+}
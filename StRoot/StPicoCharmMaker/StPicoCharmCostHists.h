@@ -0,0 +1,61 @@
+#ifndef StPicoCharmCostHists__h
+#define StPicoCharmCostHists__h
+
+/* **************************************************
+ *  A class to create and save the per-event
+ *  combinatorial cost of StPicoCharmMaker vs. gRefMult.
+ *
+ *  Authors:  **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <string>
+
+class TH1F;
+class TH2F;
+class TProfile;
+class TFile;
+
+struct StCharmEventCost
+{
+  int    nKaons;
+  int    nPions;
+  int    nProtons;
+  long   nPairs;        // Kπ pairs constructed
+  long   nTriplets;     // Kπ-X triplets constructed
+  double estimatedCost; // upper bound of triplets, see StPicoCharmMaker::estimateKPiXCost
+  double realTime;      // seconds spent in Make()
+  bool   deferred;      // three-body reconstruction deferred by the budget guard
+
+  StCharmEventCost() : nKaons(0), nPions(0), nProtons(0), nPairs(0), nTriplets(0),
+                       estimatedCost(0), realTime(0), deferred(false) {}
+};
+
+class StPicoCharmCostHists
+{
+  public:
+   StPicoCharmCostHists(std::string fileBaseName);
+   virtual ~StPicoCharmCostHists();
+   void addEvent(int gRefMult, StCharmEventCost const&);
+   void closeFile();
+
+  private:
+   StPicoCharmCostHists(){}
+
+   TFile* mOutFile;
+   TH1F* mh1GRefMult;
+   TH1F* mh1DeferredGRefMult;
+   TProfile* mp1NKaonsVsGRefMult;
+   TProfile* mp1NPionsVsGRefMult;
+   TProfile* mp1NProtonsVsGRefMult;
+   TProfile* mp1NPairsVsGRefMult;
+   TProfile* mp1NTripletsVsGRefMult;
+   TProfile* mp1EstimatedCostVsGRefMult;
+   TProfile* mp1TimeVsGRefMult;
+   TH2F* mh2TimeVsGRefMult;
+   TH2F* mh2TimeVsNTriplets;
+};
+#endif
@@ -1,20 +1,24 @@
 #include <vector>
 #include <cmath>
+#include <limits>
 #include <algorithm>
 #include <unordered_set>
 
 #include "TTree.h"
 #include "TFile.h"
 #include "TString.h"
+#include "TStopwatch.h"
 #include "StarClassLibrary/StThreeVectorF.hh"
 #include "StarClassLibrary/StLorentzVectorF.hh"
 #include "StarClassLibrary/StPhysicalHelixD.hh"
+#include "StarClassLibrary/SystemOfUnits.h"
 #include "StPicoDstMaker/StPicoDst.h"
 #include "StPicoDstMaker/StPicoDstMaker.h"
 #include "StPicoDstMaker/StPicoEvent.h"
 #include "StPicoDstMaker/StPicoTrack.h"
 #include "StPicoDstMaker/StPicoBTofPidTraits.h"
 #include "phys_constants.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
 
 #include "StPicoCharmContainers/StPicoD0Event.h"
 #include "StPicoCharmContainers/StKaonPion.h"
@@ -22,15 +26,20 @@
 #include "StPicoCharmContainers/StPicoKPiXEvent.h"
 #include "StPicoCharmContainers/StPicoKPiX.h"
 
+#include "StPicoCharmCostHists.h"
 #include "StPicoCharmMakerCuts.h"
 #include "StPicoCharmMaker.h"
 
 ClassImp(StPicoCharmMaker)
 
 StPicoCharmMaker::StPicoCharmMaker(char const* makerName, StPicoDstMaker* picoMaker, char const* fileBaseName)
-   : StMaker(makerName), mPicoDstMaker(picoMaker), mPicoEvent(nullptr), mPicoD0Hists(nullptr), mBaseName(fileBaseName),
+   : StMaker(makerName), mPicoDstMaker(picoMaker), mPicoEvent(nullptr), mPicoD0Hists(nullptr), mCostHists(nullptr), mBaseName(fileBaseName),
      mD0File(nullptr), mD0Tree(nullptr), mPicoD0Event(nullptr),
-     mKPiXFile(nullptr), mKPiXTree(nullptr), mPicoKPiXEvent(nullptr)
+     mKPiXFile(nullptr), mKPiXTree(nullptr), mPicoKPiXEvent(nullptr),
+     mD0HeaderTree(nullptr), mKPiXHeaderTree(nullptr),
+     mMakeD0LikeSign(charmMakerCuts::d0LikeSign), mKaonPionPionPatterns(charmMakerCuts::kaonPionPionPatterns),
+     mKaonPionKaonPatterns(charmMakerCuts::kaonPionKaonPatterns), mKaonPionProtonPatterns(charmMakerCuts::kaonPionProtonPatterns),
+     mDeferredFile(nullptr), mDeferredTree(nullptr), mDeferredCost(0)
 {
    mBaseName.ReplaceAll(".root","");
 }
@@ -40,6 +49,7 @@ StPicoCharmMaker::~StPicoCharmMaker()
    /* mTree is owned by mD0File directory, it will be destructed once
     * the file is closed in ::Finish() */
    delete mPicoD0Hists;
+   delete mCostHists;
 }
 
 Int_t StPicoCharmMaker::Init()
@@ -47,6 +57,15 @@ Int_t StPicoCharmMaker::Init()
   int const BufSize = (int)pow(2., 16.);
   int const Split = 1;
 
+  // the deferred pass makes only the K-pi-X channels, into its own files next to those of the first pass
+  bool const deferredPass = !mDeferredEventsFileName.IsNull();
+  TString const kPiXBaseName = deferredPass ? mBaseName + ".deferred" : mBaseName;
+  if(deferredPass && mMakeD0)
+  {
+    LOG_INFO << "StPicoCharmMaker - D0 candidates are made in the first pass, not for deferred events" << endm;
+    mMakeD0 = false;
+  }
+
   if(mMakeD0)
   {
     mD0File = new TFile(Form("%s.picoD0.root", mBaseName.Data()), "RECREATE");
@@ -56,27 +75,82 @@ Int_t StPicoCharmMaker::Init()
     mPicoD0Event = new StPicoD0Event();
     mD0Tree->Branch("dEvent", "StPicoD0Event", &mPicoD0Event, BufSize, Split);
 
+    if(mSparseStorage)
+    {
+      mD0HeaderTree = new TTree(StPicoCharmEventHeader::treeName(), "picoD0 event headers", BufSize);
+      mD0HeaderTree->SetAutoSave(1000000);
+      mD0HeaderTree->Branch("header", &mD0Header, StPicoCharmEventHeader::leafList(), BufSize);
+    }
+
     mPicoD0Hists = new StPicoD0QaHists(mBaseName.Data(), charmMakerCuts::prescalesFilesDirectoryName);
   }
 
   if(mMakeKaonPionPion || mMakeKaonPionKaon || mMakeKaonPionProton)
   {
-    mKPiXFile = new TFile(Form("%s.picoKPiX.root", mBaseName.Data()), "RECREATE");
+    mKPiXFile = new TFile(Form("%s.picoKPiX.root", kPiXBaseName.Data()), "RECREATE");
     mKPiXFile->SetCompressionLevel(1);
     mKPiXTree = new TTree("KPiXTree", "T", BufSize);
     mKPiXTree->SetAutoSave(1000000); // autosave every 1 Mbytes
     mPicoKPiXEvent = new StPicoKPiXEvent();
     mKPiXTree->Branch("kPiXEvent", "StPicoKPiXEvent", &mPicoKPiXEvent, BufSize, Split);
+
+    if(mSparseStorage)
+    {
+      mKPiXHeaderTree = new TTree(StPicoCharmEventHeader::treeName(), "picoKPiX event headers", BufSize);
+      mKPiXHeaderTree->SetAutoSave(1000000);
+      mKPiXHeaderTree->Branch("header", &mKPiXHeader, StPicoCharmEventHeader::leafList(), BufSize);
+    }
+
+    if(deferredPass)
+    {
+      if(!readDeferredEvents()) return kStErr;
+    }
+    else if(mKPiXCostBudget > 0)
+    {
+      mDeferredFile = new TFile(Form("%s.picoKPiX.deferred.root", mBaseName.Data()), "RECREATE");
+      mDeferredTree = new TTree("deferred", "events with deferred K-pi-X reconstruction", BufSize);
+      mDeferredTree->Branch("header", &mDeferredHeader, StPicoCharmEventHeader::leafList(), BufSize);
+      mDeferredTree->Branch("estimatedCost", &mDeferredCost, "estimatedCost/D");
+    }
   }
 
+  if(mFillCostHists) mCostHists = new StPicoCharmCostHists(kPiXBaseName.Data());
+
   return kStOK;
 }
 
+bool StPicoCharmMaker::readDeferredEvents()
+{
+  TFile deferredFile(mDeferredEventsFileName.Data());
+  TTree* deferredTree = deferredFile.IsZombie() ? nullptr : static_cast<TTree*>(deferredFile.Get("deferred"));
+
+  if(!deferredTree)
+  {
+    LOG_ERROR << "StPicoCharmMaker - Could not read deferred events from " << mDeferredEventsFileName << endm;
+    return false;
+  }
+
+  StPicoCharmEventHeader header;
+  deferredTree->SetBranchAddress("header", &header);
+
+  for(Long64_t i = 0; i < deferredTree->GetEntries(); ++i)
+  {
+    deferredTree->GetEntry(i);
+    mDeferredEvents.insert(std::make_pair(header.runId, header.eventId));
+  }
+
+  LOG_INFO << "StPicoCharmMaker - Making K-pi-X only for " << mDeferredEvents.size() << " deferred events" << endm;
+  return true;
+}
+
 Int_t StPicoCharmMaker::Finish()
 {
   if(mMakeD0)
   {
     mD0File->Write();
+    LOG_INFO << "StPicoCharmMaker - " << mD0File->GetName() << ": " << mD0Tree->GetEntries() << " candidate events, "
+             << (mD0HeaderTree ? mD0HeaderTree->GetEntries() : mD0Tree->GetEntries()) << " events, "
+             << mD0File->GetEND() << " bytes" << endm;
     mD0File->Close();
     mPicoD0Hists->closeFile();
   }
@@ -84,9 +158,25 @@ Int_t StPicoCharmMaker::Finish()
   if(mKPiXFile)
   {
    mKPiXFile->Write();
+   LOG_INFO << "StPicoCharmMaker - " << mKPiXFile->GetName() << ": " << mKPiXTree->GetEntries() << " candidate events, "
+            << (mKPiXHeaderTree ? mKPiXHeaderTree->GetEntries() : mKPiXTree->GetEntries()) << " events, "
+            << mKPiXFile->GetEND() << " bytes" << endm;
+   LOG_INFO << "StPicoCharmMaker - K-pi-X mass pre-check rejected " << mNMassPreCheckRejected << " triplets"
+            << (mValidateMassPreCheck ? Form(", %llu of them would have been stored", mNMassPreCheckLost) : "") << endm;
+   if(mUseXTrackIndex && mValidateXTrackIndex)
+     LOG_INFO << "StPicoCharmMaker - K-pi-X third track grid missed " << mNXTrackIndexLost << " stored triplets" << endm;
    mKPiXFile->Close();
   }
 
+  if(mDeferredFile)
+  {
+    LOG_INFO << "StPicoCharmMaker - " << mDeferredTree->GetEntries() << " events deferred by the K-pi-X cost budget" << endm;
+    mDeferredFile->Write();
+    mDeferredFile->Close();
+  }
+
+  if(mCostHists) mCostHists->closeFile();
+
    return kStOK;
 }
 
@@ -113,17 +203,44 @@ Int_t StPicoCharmMaker::Make()
 
    mPicoEvent = picoDst->event();
 
+   // the deferred pass writes only the deferred events
+   if(!mDeferredEventsFileName.IsNull() &&
+      !mDeferredEvents.count(std::make_pair(mPicoEvent->runId(), mPicoEvent->eventId()))) return kStOK;
+
+   TStopwatch timer;
+   StCharmEventCost cost;
+
    unsigned int nHftTracks = 0;
+   int nKaons = 0;
+   int nPions = 0;
 
-   if (isGoodTrigger() && isGoodEvent())
+   bool const goodTrigger = isGoodTrigger();
+   if (goodTrigger && isGoodEvent())
    {
       UInt_t nTracks = picoDst->numberOfTracks();
 
-      std::vector<unsigned short> idxPicoKaons;
-      std::vector<unsigned short> idxPicoPions;
-      std::vector<unsigned short> idxPicoProtons;
+      // species lists split by charge, [0] negative [1] positive
+      std::vector<unsigned short> idxPicoKaons[2];
+      std::vector<unsigned short> idxPicoPions[2];
+      std::vector<unsigned short> idxPicoProtons[2];
 
       StThreeVectorF const pVtx = mPicoEvent->primaryVertex();
+      float const bField = mPicoEvent->bField();
+
+      bool const indexTracks = mUseXTrackIndex && (mMakeKaonPionPion || mMakeKaonPionKaon || mMakeKaonPionProton);
+      if(indexTracks)
+      {
+        for(int q = 0; q < 2; ++q)
+        {
+          mKaonLines[q].clear(pVtx);
+          mPionLines[q].clear(pVtx);
+          mProtonLines[q].clear(pVtx);
+        }
+      }
+
+      mPvMomenta.resize(nTracks);
+      mPvOrigins.resize(nTracks);
+      mPvPt.resize(nTracks);
 
       for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack)
       {
@@ -133,129 +250,424 @@ Int_t StPicoCharmMaker::Make()
          if (!isGoodTrack(*trk, pVtx)) continue;
          ++nHftTracks;
 
-         if (isPion(*trk)) idxPicoPions.push_back(iTrack);
-         if (isKaon(*trk)) idxPicoKaons.push_back(iTrack);
-         if (isProton(*trk)) idxPicoProtons.push_back(iTrack);
-
+         bool const pion = isPion(*trk);
+         bool const kaon = isKaon(*trk);
+         bool const proton = isProton(*trk);
+         int const q = trk->charge() > 0 ? 1 : 0;
+
+         if (pion) idxPicoPions[q].push_back(iTrack);
+         if (kaon) idxPicoKaons[q].push_back(iTrack);
+         if (proton) idxPicoProtons[q].push_back(iTrack);
+
+         if (pion || kaon || proton)
+         {
+           StPhysicalHelixD helix = trk->dcaGeometry().helix();
+           helix.moveOrigin(helix.pathLength(pVtx));
+           StThreeVectorF const origin = helix.origin();
+           StThreeVectorF const mom = helix.momentum(bField * kilogauss);
+
+           mPvMomenta[iTrack] = mom;
+           mPvOrigins[iTrack] = origin;
+           mPvPt[iTrack] = mom.perp();
+         }
       } // .. end tracks loop
 
-      if(mMakeD0)
+      // lists by decreasing pT, pT(candidate) <= sum of the daughters pT ends the loops below early
+      for(int q = 0; q < 2; ++q)
       {
-        mPicoD0Event->nKaons(idxPicoKaons.size());
-        mPicoD0Event->nPions(idxPicoPions.size());
+        sortByPt(idxPicoKaons[q]);
+        sortByPt(idxPicoPions[q]);
+        sortByPt(idxPicoProtons[q]);
+
+        if(!indexTracks) continue;
+
+        for(unsigned short const idx : idxPicoKaons[q]) mKaonLines[q].addTrack(mPvOrigins[idx], mPvMomenta[idx]);
+        for(unsigned short const idx : idxPicoPions[q]) mPionLines[q].addTrack(mPvOrigins[idx], mPvMomenta[idx]);
+        for(unsigned short const idx : idxPicoProtons[q]) mProtonLines[q].addTrack(mPvOrigins[idx], mPvMomenta[idx]);
       }
 
-      float const bField = mPicoEvent->bField();
-      for (size_t iK0 = 0; iK0 < idxPicoKaons.size(); ++iK0)
+      nKaons = idxPicoKaons[0].size() + idxPicoKaons[1].size();
+      nPions = idxPicoPions[0].size() + idxPicoPions[1].size();
+
+      cost.nKaons = nKaons;
+      cost.nPions = nPions;
+      cost.nProtons = idxPicoProtons[0].size() + idxPicoProtons[1].size();
+      cost.estimatedCost = estimateKPiXCost(cost.nKaons, cost.nPions, cost.nProtons);
+
+      bool makeKPiX = mMakeKaonPionPion || mMakeKaonPionKaon || mMakeKaonPionProton;
+      if(makeKPiX && mDeferredTree && cost.estimatedCost > mKPiXCostBudget)
       {
-        StPicoTrack const* kaon0 = picoDst->track(idxPicoKaons[iK0]);
+        makeKPiX = false;
+        cost.deferred = true;
+
+        mDeferredHeader.runId = mPicoEvent->runId();
+        mDeferredHeader.eventId = mPicoEvent->eventId();
+        mDeferredHeader.nKaons = nKaons;
+        mDeferredHeader.nPions = nPions;
+        mDeferredCost = cost.estimatedCost;
+        mDeferredTree->Fill();
+      }
 
-        for (size_t iPi0 = 0; iPi0 < idxPicoPions.size(); ++iPi0)
-        {
-          if (idxPicoKaons[iK0] == idxPicoPions[iPi0]) continue;
-          StPicoTrack const* pion0 = picoDst->track(idxPicoPions[iPi0]);
+      if(mMakeD0)
+      {
+        mPicoD0Event->nKaons(nKaons);
+        mPicoD0Event->nPions(nPions);
+      }
 
-          // make Kπ pairs
-          StKaonPion kaonPion(*kaon0, *pion0, idxPicoKaons[iK0], idxPicoPions[iPi0], pVtx, bField);
+      // like-sign Kπ pairs are made only if a channel uses them
+      unsigned int const piSamePatterns = charmMakerCuts::kPiSameXOpp | charmMakerCuts::kPiSameXSame;
+      bool const makeLikeSignPairs = (mMakeD0 && mMakeD0LikeSign) ||
+                                     (makeKPiX && ((mMakeKaonPionPion && (mKaonPionPionPatterns & piSamePatterns)) ||
+                                                   (mMakeKaonPionKaon && (mKaonPionKaonPatterns & piSamePatterns)) ||
+                                                   (mMakeKaonPionProton && (mKaonPionProtonPatterns & piSamePatterns))));
 
-          if (mMakeD0 && isGoodD0Pair(kaonPion))
-          {
-            if(isGoodD0Mass(kaonPion)) mPicoD0Event->addKaonPion(kaonPion);
+      // minimum pT(K) + pT(π) of a pair usable as a D0 or in any Kπ-X triplet
+      float maxXPt = 0;
+      for(int q = 0; q < 2; ++q)
+      {
+        if(mMakeKaonPionPion && !idxPicoPions[q].empty()) maxXPt = std::max(maxXPt, mPvPt[idxPicoPions[q].front()]);
+        if(mMakeKaonPionKaon && !idxPicoKaons[q].empty()) maxXPt = std::max(maxXPt, mPvPt[idxPicoKaons[q].front()]);
+        if(mMakeKaonPionProton && !idxPicoProtons[q].empty()) maxXPt = std::max(maxXPt, mPvPt[idxPicoProtons[q].front()]);
+      }
 
-            bool const fillMass = isGoodQaPair(kaonPion,*kaon0,*pion0);
-            bool const unlike = kaon0->charge() * pion0->charge() < 0 ? true : false;
+      float pairPtMin = std::numeric_limits<float>::max();
+      if(mMakeD0) pairPtMin = charmMakerCuts::minD0Pt;
+      if(makeKPiX) pairPtMin = std::min(pairPtMin, charmMakerCuts::minKPiXPt - maxXPt);
 
-            if(fillMass || unlike) mPicoD0Hists->addKaonPion(&kaonPion,fillMass, unlike);
-          }
+      float maxPionPt = 0;
+      for(int q = 0; q < 2; ++q)
+      {
+        if(!idxPicoPions[q].empty()) maxPionPt = std::max(maxPionPt, mPvPt[idxPicoPions[q].front()]);
+      }
 
-          if(kaonPion.dcaDaughters() > charmMakerCuts::dcaDaughters) continue;
+      for (int kq = 0; kq < 2; ++kq)
+      {
+        for (size_t iK0 = 0; iK0 < idxPicoKaons[kq].size(); ++iK0)
+        {
+          unsigned short const kaonIdx0 = idxPicoKaons[kq][iK0];
+          float const kaonPt = mPvPt[kaonIdx0];
+          if (kaonPt + maxPionPt < pairPtMin) break;
 
-          std::unordered_set<unsigned short> usedXTrack;
+          StPicoTrack const* kaon0 = picoDst->track(kaonIdx0);
 
-          // make Kππ
-          if(mMakeKaonPionPion)
+          for (int piq = 0; piq < 2; ++piq)
           {
-            for(size_t iPi1 = iPi0+1; iPi1 < idxPicoPions.size(); ++iPi1)
-            {
-              if (idxPicoKaons[iK0] == idxPicoPions[iPi1]) continue;
-              StPicoTrack const* pion1 = picoDst->track(idxPicoPions[iPi1]);
+            bool const piSame = piq == kq;
+            if (piSame && !makeLikeSignPairs) continue;
 
-              auto search = usedXTrack.find(pion1->id());
-              if(search != usedXTrack.end()) continue;
+            // charge pattern of the triplet for a third track of charge index xq
+            unsigned int xPattern[2];
+            xPattern[kq] = piSame ? charmMakerCuts::kPiSameXSame : charmMakerCuts::kPiOppXSame;
+            xPattern[1-kq] = piSame ? charmMakerCuts::kPiSameXOpp : charmMakerCuts::kPiOppXOpp;
 
-              StPicoKPiX kaonPionPion(*kaon0, *pion0, *pion1, idxPicoKaons[iK0], idxPicoPions[iPi0], idxPicoPions[iPi1], pVtx, bField);
+            for (size_t iPi0 = 0; iPi0 < idxPicoPions[piq].size(); ++iPi0)
+            {
+              unsigned short const pionIdx0 = idxPicoPions[piq][iPi0];
+              float const kaonPionPt = kaonPt + mPvPt[pionIdx0];
+              if (kaonPionPt < pairPtMin) break;
+              if (kaonIdx0 == pionIdx0) continue;
+              StPicoTrack const* pion0 = picoDst->track(pionIdx0);
+
+              // make Kπ pairs
+              StKaonPion kaonPion(*kaon0, *pion0, kaonIdx0, pionIdx0, pVtx, bField);
+              ++cost.nPairs;
 
-              if(isGoodKPiX(kaonPionPion) && isGoodKPiXMass(kaonPionPion.fourMom(M_PION_PLUS).m()))
+              if (mMakeD0 && (!piSame || mMakeD0LikeSign) && isGoodD0Pair(kaonPion))
               {
-                mPicoKPiXEvent->addKPiX(kaonPionPion);
-                usedXTrack.insert(pion1->id());
+                if(isGoodD0Mass(kaonPion))
+                {
+                  mPicoD0Event->addKaonPion(kaonPion);
+                  if(mStoreDaughterTracks)
+                  {
+                    mD0DaughterIdx.push_back(kaonIdx0);
+                    mD0DaughterIdx.push_back(pionIdx0);
+                  }
+                }
+
+                bool const fillMass = isGoodQaPair(kaonPion,*kaon0,*pion0);
+                bool const unlike = !piSame;
+
+                if(fillMass || unlike) mPicoD0Hists->addKaonPion(&kaonPion,fillMass, unlike);
               }
-            }
-          }
 
-          // make KπK
-          if(mMakeKaonPionKaon)
-          {
-            for(size_t iK1 = iK0+1; iK1 < idxPicoKaons.size(); ++iK1)
-            {
-              if (idxPicoKaons[iK1] == idxPicoPions[iPi0]) continue;
-              StPicoTrack const* kaon1 = picoDst->track(idxPicoKaons[iK1]);
+              if(!makeKPiX || kaonPion.dcaDaughters() > charmMakerCuts::dcaDaughters) continue;
 
-              auto search = usedXTrack.find(kaon1->id());
-              if(search != usedXTrack.end()) continue;
+              std::unordered_set<unsigned short> usedXTrack;
 
-              StPicoKPiX kaonPionKaon(*kaon0, *pion0, *kaon1, idxPicoKaons[iK0], idxPicoPions[iPi0], idxPicoKaons[iK1], pVtx, bField);
+              StThreeVectorF const& kaonPvMom = mPvMomenta[kaonIdx0];
+              StThreeVectorF const& pionPvMom = mPvMomenta[pionIdx0];
+              StLorentzVectorF const kaonPionPvFourMom(kaonPvMom + pionPvMom,
+                                                       kaonPvMom.massHypothesis(M_KAON_MINUS) + pionPvMom.massHypothesis(M_PION_PLUS));
 
-              if(isGoodKPiX(kaonPionKaon) && isGoodKPiXMass(kaonPionKaon.fourMom(M_KAON_MINUS).m()))
+              StThreeVectorF const kpVertex = indexTracks ? StTrackLineGrid::dcaMidPoint(mKaonLines[kq].origin(iK0), mKaonLines[kq].direction(iK0),
+                                                                                         mPionLines[piq].origin(iPi0), mPionLines[piq].direction(iPi0))
+                                                          : pVtx;
+
+              // make Kππ
+              for (int xq = 0; mMakeKaonPionPion && xq < 2; ++xq)
               {
-                mPicoKPiXEvent->addKPiX(kaonPionKaon);
-                usedXTrack.insert(kaon1->id());
+                if (!(mKaonPionPionPatterns & xPattern[xq])) continue;
+                std::vector<unsigned short> const& pions1 = idxPicoPions[xq];
+
+                // if the pions can swap roles within the patterns, the triplet is built once
+                // with the lower track index as first pion, as in the unsplit lists
+                bool const ordered = mKaonPionPionPatterns & chargePattern(xq == kq, piSame);
+                selectXTracks(mPionLines[xq], pions1.size(), 0, kpVertex, mXTracks);
+                for(size_t const iPi1 : mXTracks)
+                {
+                  if (kaonPionPt + mPvPt[pions1[iPi1]] < charmMakerCuts::minKPiXPt) break;
+                  if (ordered && pions1[iPi1] <= pionIdx0) continue;
+                  if (kaonIdx0 == pions1[iPi1]) continue;
+                  StPicoTrack const* pion1 = picoDst->track(pions1[iPi1]);
+
+                  auto search = usedXTrack.find(pion1->id());
+                  if(search != usedXTrack.end()) continue;
+
+                  bool const massPreCheck = passKPiXMassPreCheck(kaonPionPvFourMom, pions1[iPi1], M_PION_PLUS);
+                  if(!massPreCheck && !mValidateMassPreCheck) continue;
+
+                  StPicoKPiX kaonPionPion(*kaon0, *pion0, *pion1, kaonIdx0, pionIdx0, pions1[iPi1], pVtx, bField);
+                  ++cost.nTriplets;
+
+                  if(isGoodKPiX(kaonPionPion) && isGoodKPiXMass(kaonPionPion.fourMom(M_PION_PLUS).m()))
+                  {
+                    if(!massPreCheck) ++mNMassPreCheckLost;
+                    if(!isInXTrackGrid(iPi1)) ++mNXTrackIndexLost;
+                    mPicoKPiXEvent->addKPiX(kaonPionPion);
+                    usedXTrack.insert(pion1->id());
+                  }
+                }
               }
-            }
-          }
-
-          // make KπP
-          if(mMakeKaonPionProton)
-          {
-            for(size_t iP = 0; iP < idxPicoProtons.size(); ++iP)
-            {
-              if (idxPicoProtons[iP] == idxPicoPions[iPi0]) continue;
-              StPicoTrack const* proton = picoDst->track(idxPicoProtons[iP]);
-
-              auto search = usedXTrack.find(proton->id());
-              if(search != usedXTrack.end()) continue;
 
-              StPicoKPiX kaonPionProton(*kaon0, *pion0, *proton, idxPicoKaons[iK0], idxPicoPions[iPi0], idxPicoProtons[iP], pVtx, bField);
+              // make KπK
+              for (int xq = 0; mMakeKaonPionKaon && xq < 2; ++xq)
+              {
+                if (!(mKaonPionKaonPatterns & xPattern[xq])) continue;
+                std::vector<unsigned short> const& kaons1 = idxPicoKaons[xq];
+
+                // if the kaons can swap roles within the patterns (K+ K- π with both
+                // kPiOppXOpp and kPiSameXOpp), the triplet is built once with the lower
+                // track index as first kaon, as in the unsplit lists
+                bool const xSame = xq == kq;
+                bool const ordered = mKaonPionKaonPatterns & chargePattern(piSame == xSame, xSame);
+                selectXTracks(mKaonLines[xq], kaons1.size(), 0, kpVertex, mXTracks);
+                for(size_t const iK1 : mXTracks)
+                {
+                  if (kaonPionPt + mPvPt[kaons1[iK1]] < charmMakerCuts::minKPiXPt) break;
+                  if (ordered && kaons1[iK1] <= kaonIdx0) continue;
+                  if (kaons1[iK1] == pionIdx0) continue;
+                  StPicoTrack const* kaon1 = picoDst->track(kaons1[iK1]);
+
+                  auto search = usedXTrack.find(kaon1->id());
+                  if(search != usedXTrack.end()) continue;
+
+                  bool const massPreCheck = passKPiXMassPreCheck(kaonPionPvFourMom, kaons1[iK1], M_KAON_MINUS);
+                  if(!massPreCheck && !mValidateMassPreCheck) continue;
+
+                  StPicoKPiX kaonPionKaon(*kaon0, *pion0, *kaon1, kaonIdx0, pionIdx0, kaons1[iK1], pVtx, bField);
+                  ++cost.nTriplets;
+
+                  if(isGoodKPiX(kaonPionKaon) && isGoodKPiXMass(kaonPionKaon.fourMom(M_KAON_MINUS).m()))
+                  {
+                    if(!massPreCheck) ++mNMassPreCheckLost;
+                    if(!isInXTrackGrid(iK1)) ++mNXTrackIndexLost;
+                    mPicoKPiXEvent->addKPiX(kaonPionKaon);
+                    usedXTrack.insert(kaon1->id());
+                  }
+                }
+              }
 
-              if(isGoodKPiX(kaonPionProton) && isGoodKPiXMass(kaonPionProton.fourMom(M_PROTON).m()))
+              // make KπP
+              for (int xq = 0; mMakeKaonPionProton && xq < 2; ++xq)
               {
-                mPicoKPiXEvent->addKPiX(kaonPionProton);
-                usedXTrack.insert(proton->id());
+                if (!(mKaonPionProtonPatterns & xPattern[xq])) continue;
+                std::vector<unsigned short> const& protons = idxPicoProtons[xq];
+
+                selectXTracks(mProtonLines[xq], protons.size(), 0, kpVertex, mXTracks);
+                for(size_t const iP : mXTracks)
+                {
+                  if (kaonPionPt + mPvPt[protons[iP]] < charmMakerCuts::minKPiXPt) break;
+                  if (protons[iP] == pionIdx0) continue;
+                  StPicoTrack const* proton = picoDst->track(protons[iP]);
+
+                  auto search = usedXTrack.find(proton->id());
+                  if(search != usedXTrack.end()) continue;
+
+                  bool const massPreCheck = passKPiXMassPreCheck(kaonPionPvFourMom, protons[iP], M_PROTON);
+                  if(!massPreCheck && !mValidateMassPreCheck) continue;
+
+                  StPicoKPiX kaonPionProton(*kaon0, *pion0, *proton, kaonIdx0, pionIdx0, protons[iP], pVtx, bField);
+                  ++cost.nTriplets;
+
+                  if(isGoodKPiX(kaonPionProton) && isGoodKPiXMass(kaonPionProton.fourMom(M_PROTON).m()))
+                  {
+                    if(!massPreCheck) ++mNMassPreCheckLost;
+                    if(!isInXTrackGrid(iP)) ++mNXTrackIndexLost;
+                    mPicoKPiXEvent->addKPiX(kaonPionProton);
+                    usedXTrack.insert(proton->id());
+                  }
+                }
               }
-            }
-          }
-        } // .. end make Kπ pairs
-      } // .. end of kaons loop
+            } // .. end make Kπ pairs
+          } // .. end of pion charges loop
+        } // .. end of kaons loop
+      } // .. end of kaon charges loop
+
+      if(mMakeD0 && mStoreDaughterTracks) addD0DaughterTracks(picoDst);
    } //.. end of good event fill
 
    if(mMakeD0)
    {
      mPicoD0Event->addPicoEvent(*mPicoEvent);
+     mPicoD0Event->eventSelection(goodTrigger ? StPicoD0Event::kGoodTrigger : 0);
      mPicoD0Hists->addEvent(*mPicoEvent,*mPicoD0Event,nHftTracks);
-     mD0Tree->Fill();
+
+     if(mSparseStorage)
+     {
+       mD0Header.nKaons = nKaons;
+       mD0Header.nPions = nPions;
+       mD0Header.eventSelection = mPicoD0Event->eventSelection();
+       mD0Header.vz = mPicoD0Event->vz();
+       mD0Header.vzVpd = mPicoD0Event->vzVpd();
+       fillSparse(mD0Tree, mD0HeaderTree, mD0Header, mPicoD0Event->nKaonPion());
+     }
+     else mD0Tree->Fill();
+
      mPicoD0Event->clear("C");
    }
 
    if(mKPiXFile)
    {
      mPicoKPiXEvent->addPicoEvent(*mPicoEvent);
-     mKPiXTree->Fill();
+
+     if(mSparseStorage)
+     {
+       mKPiXHeader.nKaons = nKaons;
+       mKPiXHeader.nPions = nPions;
+       fillSparse(mKPiXTree, mKPiXHeaderTree, mKPiXHeader, mPicoKPiXEvent->nKaonPionXaon());
+     }
+     else mKPiXTree->Fill();
+
      mPicoKPiXEvent->clear("C");
    }
 
+   if(mCostHists)
+   {
+     timer.Stop();
+     cost.realTime = timer.RealTime();
+     mCostHists->addEvent(mPicoEvent->grefMult(), cost);
+   }
+
    return kStOK;
 }
 
+bool StPicoCharmMaker::passKPiXMassPreCheck(StLorentzVectorF const& kaonPionPvFourMom, unsigned short const xIdx, float const xMass)
+{
+   // the momenta at the primary vertex differ from those at the decay vertex only by the
+   // small rotation along the decay length, the margin covers the difference
+   StThreeVectorF const& xPvMom = mPvMomenta[xIdx];
+   StLorentzVectorF const fourMom = kaonPionPvFourMom + StLorentzVectorF(xPvMom, xPvMom.massHypothesis(xMass));
+   float const mass = fourMom.m();
+
+   if(mass > charmMakerCuts::minKPiXMass - charmMakerCuts::kPiXMassPreCheckMargin &&
+      mass < charmMakerCuts::maxKPiXMass + charmMakerCuts::kPiXMassPreCheckMargin) return true;
+
+   ++mNMassPreCheckRejected;
+   return false;
+}
+
+namespace
+{
+  // decreasing pT, ties by track index
+  struct StHigherPt
+  {
+    std::vector<float> const& pt;
+    explicit StHigherPt(std::vector<float> const& p) : pt(p) {}
+    bool operator()(unsigned short const a, unsigned short const b) const
+    {
+      return pt[a] > pt[b] || (pt[a] == pt[b] && a < b);
+    }
+  };
+}
+
+void StPicoCharmMaker::sortByPt(std::vector<unsigned short>& idx) const
+{
+   std::sort(idx.begin(), idx.end(), StHigherPt(mPvPt));
+}
+
+unsigned int StPicoCharmMaker::chargePattern(bool const piSame, bool const xSame)
+{
+   if(piSame) return xSame ? charmMakerCuts::kPiSameXSame : charmMakerCuts::kPiSameXOpp;
+   return xSame ? charmMakerCuts::kPiOppXSame : charmMakerCuts::kPiOppXOpp;
+}
+
+double StPicoCharmMaker::estimateKPiXCost(int const nKaons, int const nPions, int const nProtons) const
+{
+   // upper bound of Kπ-X triplets tried: every Kπ pair against all third tracks
+   double nXTracks = 0;
+   if(mMakeKaonPionPion)   nXTracks += 0.5 * nPions;
+   if(mMakeKaonPionKaon)   nXTracks += 0.5 * nKaons;
+   if(mMakeKaonPionProton) nXTracks += nProtons;
+
+   return static_cast<double>(nKaons) * nPions * nXTracks;
+}
+
+void StPicoCharmMaker::selectXTracks(StTrackLineGrid const& lines, size_t const nTracks, size_t const first,
+                                     StThreeVectorF const& kpVertex, std::vector<size_t>& xTracks)
+{
+   if(mUseXTrackIndex && !mValidateXTrackIndex)
+   {
+     lines.findTracks(kpVertex, charmMakerCuts::xTrackSearchRadius, first, xTracks);
+     return;
+   }
+
+   if(mUseXTrackIndex)
+   {
+     // validation: all tracks are scanned, those found by the grid are flagged
+     lines.findTracks(kpVertex, charmMakerCuts::xTrackSearchRadius, first, mGridXTracks);
+     mInXTrackGrid.assign(nTracks, 0);
+     for(size_t const i : mGridXTracks) mInXTrackGrid[i] = 1;
+   }
+
+   xTracks.clear();
+   for(size_t i = first; i < nTracks; ++i) xTracks.push_back(i);
+}
+
+void StPicoCharmMaker::fillSparse(TTree* const candidateTree, TTree* const headerTree, StPicoCharmEventHeader& header, int const nCandidates)
+{
+   header.runId = mPicoEvent->runId();
+   header.eventId = mPicoEvent->eventId();
+   header.candidateEntry = -1;
+
+   if(nCandidates > 0)
+   {
+     header.candidateEntry = candidateTree->GetEntries();
+     candidateTree->Fill();
+   }
+
+   headerTree->Fill();
+}
+
+void StPicoCharmMaker::addD0DaughterTracks(StPicoDst const* const picoDst)
+{
+   // one snapshot per daughter, in increasing track index for StPicoD0Event::daughterTrack()
+   std::sort(mD0DaughterIdx.begin(), mD0DaughterIdx.end());
+   mD0DaughterIdx.erase(std::unique(mD0DaughterIdx.begin(), mD0DaughterIdx.end()), mD0DaughterIdx.end());
+
+   StThreeVectorF const pVtx = mPicoEvent->primaryVertex();
+   float const bField = mPicoEvent->bField();
+
+   for(unsigned short const idx : mD0DaughterIdx)
+   {
+     StPicoTrack const* trk = picoDst->track(idx);
+     StPicoBTofPidTraits const* tofPid = trk->bTofPidTraitsIndex() >= 0 ? picoDst->btofPidTraits(trk->bTofPidTraitsIndex()) : NULL;
+
+     mPicoD0Event->addDaughterTrack(StPicoDaughterTrack(*trk, idx, pVtx, bField, tofPid));
+   }
+
+   mD0DaughterIdx.clear();
+}
+
 bool StPicoCharmMaker::isGoodEvent() const
 {
    return fabs(mPicoEvent->primaryVertex().z()) < charmMakerCuts::vz &&
@@ -298,14 +710,16 @@ bool StPicoCharmMaker::isProton(StPicoTrack const& trk) const
 
 bool StPicoCharmMaker::isGoodD0Pair(StKaonPion const& kp) const
 {
-   return std::cos(kp.pointingAngle()) > charmMakerCuts::cosTheta &&
+   return kp.pt() >= charmMakerCuts::minD0Pt &&
+          std::cos(kp.pointingAngle()) > charmMakerCuts::cosTheta &&
           kp.decayLength() > charmMakerCuts::decayLength &&
           kp.dcaDaughters() < charmMakerCuts::dcaDaughters;
 }
 
 bool StPicoCharmMaker::isGoodKPiX(StPicoKPiX const& kpx) const
 {
-   return std::cos(kpx.pointingAngle()) > charmMakerCuts::cosTheta &&
+   return (kpx.kaonMomAtDca() + kpx.pionMomAtDca() + kpx.xaonMomAtDca()).perp() >= charmMakerCuts::minKPiXPt &&
+          std::cos(kpx.pointingAngle()) > charmMakerCuts::cosTheta &&
           kpx.decayLength() > charmMakerCuts::decayLength &&
           kpx.dcaDaughters() < charmMakerCuts::dcaDaughters;
 }
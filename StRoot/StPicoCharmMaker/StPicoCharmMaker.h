@@ -13,14 +13,22 @@
  * **************************************************
  */
 
+#include <vector>
+#include <set>
+#include <utility>
+
 #include "TString.h"
 
 #include "StChain/StMaker.h"
 #include "StarClassLibrary/StThreeVectorF.hh"
+#include "StarClassLibrary/StLorentzVectorF.hh"
+#include "StPicoCharmContainers/StPicoCharmEventHeader.h"
+#include "StTrackLineGrid.h"
 
 class TTree;
 class TFile;
 class StPicoDstMaker;
+class StPicoDst;
 class StPicoEvent;
 class StPicoTrack;
 class StPicoD0Event;
@@ -28,6 +36,7 @@ class StKaonPion;
 class StPicoKPiXEvent;
 class StPicoKPiX;
 class StPicoD0QaHists;
+class StPicoCharmCostHists;
 
 class StPicoCharmMaker : public StMaker 
 {
@@ -44,6 +53,36 @@ class StPicoCharmMaker : public StMaker
     void  makeKaonPionPion(bool m=true);
     void  makeKaonPionKaon(bool m=true);
     void  makeKaonPionProton(bool m=true);
+    void  sparseStorage(bool m=true);
+    // pre-select the third tracks of Kπ-X candidates with the straight-line grid. It is lossy
+    // for nearly collinear Kπ pairs, enable it only after validateXTrackIndex() reports no lost triplets.
+    void  useXTrackIndex(bool m=true);
+    // with useXTrackIndex(), scan all third tracks anyway and count the stored triplets
+    // which the grid would have missed
+    void  validateXTrackIndex(bool m=true);
+    void  fillCostHists(bool m=true);
+    // store a StPicoDaughterTrack snapshot of the D0 daughters, picoD0 files can then be analysed without the picoDst
+    void  storeDaughterTracks(bool m=true);
+
+    // allowed charge patterns of each channel, charmMakerCuts::KPiXChargePattern bits.
+    // Defaults are the signal patterns in StPicoCharmMakerCuts.h, add the wrong-sign
+    // patterns (or charmMakerCuts::kAllChargePatterns) for like-sign background.
+    void  setKaonPionPionPatterns(unsigned int patterns);
+    void  setKaonPionKaonPatterns(unsigned int patterns);
+    void  setKaonPionProtonPatterns(unsigned int patterns);
+    void  makeD0LikeSign(bool m=true);
+
+    // build the triplets rejected by the K-pi-X mass pre-check anyway and count
+    // those which would have been stored
+    void  validateMassPreCheck(bool m=true);
+
+    // events with estimated Kπ-X cost above the budget skip the three-body reconstruction and are
+    // written to the deferred events stream (<base>.picoKPiX.deferred.root). 0 disables the guard.
+    void  setKPiXCostBudget(double budget);
+    // make the three-body reconstruction only for the events listed in a deferred events file.
+    // D0 is not remade, the candidates go to <base>.deferred.picoKPiX.root (and cost histograms)
+    // next to the first pass outputs, which are not touched.
+    void  processDeferredEvents(char const* deferredEventsFileName);
 
   private:
     bool  isGoodEvent() const;
@@ -58,10 +97,21 @@ class StPicoCharmMaker : public StMaker
     bool  isGoodKPiXMass(double mass) const;
     int   getD0PtIndex(StKaonPion const& kp) const;
     bool  isGoodQaPair(StKaonPion const&, StPicoTrack const&,StPicoTrack const&);
+    void  selectXTracks(StTrackLineGrid const&, size_t nTracks, size_t first,
+                        StThreeVectorF const& kpVertex, std::vector<size_t>& xTracks);
+    bool  isInXTrackGrid(size_t i) const;
+    void  sortByPt(std::vector<unsigned short>& idx) const;
+    static unsigned int chargePattern(bool piSame, bool xSame); // charmMakerCuts::KPiXChargePattern
+    bool  passKPiXMassPreCheck(StLorentzVectorF const& kaonPionPvFourMom, unsigned short xIdx, float xMass);
+    double estimateKPiXCost(int nKaons, int nPions, int nProtons) const;
+    bool  readDeferredEvents();
+    void  fillSparse(TTree* candidateTree, TTree* headerTree, StPicoCharmEventHeader&, int nCandidates);
+    void  addD0DaughterTracks(StPicoDst const*);
 
     StPicoDstMaker*  mPicoDstMaker;
     StPicoEvent*     mPicoEvent;
     StPicoD0QaHists* mPicoD0Hists;
+    StPicoCharmCostHists* mCostHists;
 
     TString mBaseName;
 
@@ -73,10 +123,52 @@ class StPicoCharmMaker : public StMaker
     TTree* mKPiXTree;
     StPicoKPiXEvent* mPicoKPiXEvent;
 
+    // sparse storage: header for every event, candidate trees only for events with candidates
+    TTree* mD0HeaderTree;
+    TTree* mKPiXHeaderTree;
+    StPicoCharmEventHeader mD0Header;
+    StPicoCharmEventHeader mKPiXHeader;
+
     bool mMakeD0 = true;
     bool mMakeKaonPionPion = true;
     bool mMakeKaonPionKaon = true;
     bool mMakeKaonPionProton = true;
+    bool mSparseStorage = false;
+    bool mUseXTrackIndex = false;
+    bool mValidateXTrackIndex = false;
+    bool mFillCostHists = false;
+    bool mStoreDaughterTracks = false;
+    bool mMakeD0LikeSign;
+    unsigned int mKaonPionPionPatterns;
+    unsigned int mKaonPionKaonPatterns;
+    unsigned int mKaonPionProtonPatterns;
+    bool mValidateMassPreCheck = false;
+
+    // momenta, origins and pT at the primary vertex of identified tracks, indexed by track index
+    std::vector<StThreeVectorF> mPvMomenta;
+    std::vector<StThreeVectorF> mPvOrigins;
+    std::vector<float> mPvPt;
+    std::vector<unsigned short> mD0DaughterIdx; // of the stored D0 candidates
+    unsigned long long mNMassPreCheckRejected = 0;
+    unsigned long long mNMassPreCheckLost = 0; // validation only
+    unsigned long long mNXTrackIndexLost = 0;  // validation only
+
+    // budget guard
+    double mKPiXCostBudget = 0;
+    TFile* mDeferredFile;
+    TTree* mDeferredTree;
+    StPicoCharmEventHeader mDeferredHeader;
+    double mDeferredCost;
+    TString mDeferredEventsFileName;
+    std::set<std::pair<int, int> > mDeferredEvents; // runId, eventId
+
+    // straight lines of tracks at the primary vertex, indexed as the pT sorted species lists, [0] negative [1] positive
+    StTrackLineGrid mKaonLines[2];
+    StTrackLineGrid mPionLines[2];
+    StTrackLineGrid mProtonLines[2];
+    std::vector<size_t> mXTracks;
+    std::vector<size_t> mGridXTracks;  // validation only
+    std::vector<char> mInXTrackGrid;   // validation only, indexed as the species list
 
     ClassDef(StPicoCharmMaker, 0)
 };
@@ -84,4 +176,17 @@ inline void StPicoCharmMaker::makeD0(bool m)             { mMakeD0 = m; }
 inline void StPicoCharmMaker::makeKaonPionPion(bool m)   { mMakeKaonPionPion = m; }
 inline void StPicoCharmMaker::makeKaonPionKaon(bool m)   { mMakeKaonPionKaon = m; }
 inline void StPicoCharmMaker::makeKaonPionProton(bool m) { mMakeKaonPionProton = m; }
+inline void StPicoCharmMaker::sparseStorage(bool m)      { mSparseStorage = m; }
+inline void StPicoCharmMaker::useXTrackIndex(bool m)     { mUseXTrackIndex = m; }
+inline void StPicoCharmMaker::validateXTrackIndex(bool m) { mValidateXTrackIndex = m; }
+inline void StPicoCharmMaker::fillCostHists(bool m)      { mFillCostHists = m; }
+inline void StPicoCharmMaker::storeDaughterTracks(bool m) { mStoreDaughterTracks = m; }
+inline void StPicoCharmMaker::setKaonPionPionPatterns(unsigned int p)   { mKaonPionPionPatterns = p; }
+inline void StPicoCharmMaker::setKaonPionKaonPatterns(unsigned int p)   { mKaonPionKaonPatterns = p; }
+inline void StPicoCharmMaker::setKaonPionProtonPatterns(unsigned int p) { mKaonPionProtonPatterns = p; }
+inline void StPicoCharmMaker::makeD0LikeSign(bool m)     { mMakeD0LikeSign = m; }
+inline void StPicoCharmMaker::validateMassPreCheck(bool m) { mValidateMassPreCheck = m; }
+inline bool StPicoCharmMaker::isInXTrackGrid(size_t i) const { return !mValidateXTrackIndex || mInXTrackGrid[i]; }
+inline void StPicoCharmMaker::setKPiXCostBudget(double budget) { mKPiXCostBudget = budget; }
+inline void StPicoCharmMaker::processDeferredEvents(char const* fileName) { mDeferredEventsFileName = fileName; }
 #endif
@@ -50,6 +50,21 @@ namespace charmMakerCuts
    float const maxD0Mass = 2.2;
    float const minKPiXMass = 1.6;
    float const maxKPiXMass = 2.6;
+   // candidate pT minimum, the species lists are sorted by pT and a non-zero value ends the loops early
+   float const minD0Pt = 0.;
+   float const minKPiXPt = 0.;
+   // Kπ-X triplets are built only if their mass from the momenta at the primary vertex
+   // is within [minKPiXMass - margin, maxKPiXMass + margin]
+   float const kPiXMassPreCheckMargin = 0.05;
+   // third track lines must pass within this distance of the Kπ vertex (StTrackLineGrid pre-selection)
+   float const xTrackSearchRadius = 2. * dcaDaughters;
+
+   // charge patterns of Kπ-X triplets, pion and third track charges relative to the kaon
+   enum KPiXChargePattern { kPiOppXOpp = 1, kPiOppXSame = 2, kPiSameXOpp = 4, kPiSameXSame = 8, kAllChargePatterns = 15 };
+   unsigned int const kaonPionPionPatterns = kPiOppXOpp;                 // D+ -> K- π+ π+
+   unsigned int const kaonPionKaonPatterns = kPiOppXOpp | kPiSameXOpp;   // Ds+, D+ -> K+ K- π+, either kaon is first
+   unsigned int const kaonPionProtonPatterns = kPiOppXOpp;               // Λc+ -> p K- π+
+   bool const d0LikeSign = true; // like-sign Kπ pairs for the D0 background
 
    // histograms kaonPion pair cuts
    int   const nPtBins = 5;
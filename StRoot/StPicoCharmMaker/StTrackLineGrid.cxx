@@ -0,0 +1,107 @@
+#include <cmath>
+#include <algorithm>
+
+#include "StTrackLineGrid.h"
+
+StTrackLineGrid::StTrackLineGrid(int const nPhiBins, int const nD0Bins, float const d0Max) :
+  mNPhiBins(nPhiBins), mND0Bins(nD0Bins), mD0Max(d0Max),
+  mPhiBinWidth(M_PI / nPhiBins), mD0BinWidth(2. * d0Max / nD0Bins),
+  mPVtx(), mBins(nPhiBins * nD0Bins)
+{
+  mSinPhi.resize(mNPhiBins);
+  mCosPhi.resize(mNPhiBins);
+
+  for(int iPhi = 0; iPhi < mNPhiBins; ++iPhi)
+  {
+    mSinPhi[iPhi] = std::sin((iPhi + 0.5) * mPhiBinWidth);
+    mCosPhi[iPhi] = std::cos((iPhi + 0.5) * mPhiBinWidth);
+  }
+}
+
+void StTrackLineGrid::clear(StThreeVectorF const& pVtx)
+{
+  mPVtx = pVtx;
+  mOrigins.clear();
+  mDirections.clear();
+
+  // keep the capacity of the bins, steady state events do not allocate
+  for(size_t i = 0; i < mBins.size(); ++i) mBins[i].clear();
+}
+
+int StTrackLineGrid::d0Bin(float const d0) const
+{
+  int const iD0 = static_cast<int>(std::floor((d0 + mD0Max) / mD0BinWidth));
+  return std::min(std::max(iD0, 0), mND0Bins - 1);
+}
+
+void StTrackLineGrid::addTrack(StThreeVectorF const& origin, StThreeVectorF const& mom)
+{
+  StThreeVectorF const u = mom.unit();
+
+  // a line has no orientation, fold phi into [0, pi)
+  float phi = std::atan2(u.y(), u.x());
+  if(phi < 0) phi += M_PI;
+
+  int const iPhi = std::min(static_cast<int>(phi / mPhiBinWidth), mNPhiBins - 1);
+
+  // signed transverse distance of the line to the primary vertex
+  float const d0 = -(origin.x() - mPVtx.x()) * std::sin(phi) + (origin.y() - mPVtx.y()) * std::cos(phi);
+
+  mBins[bin(iPhi, d0Bin(d0))].push_back(mOrigins.size());
+  mOrigins.push_back(origin);
+  mDirections.push_back(u);
+}
+
+void StTrackLineGrid::findTracks(StThreeVectorF const& point, float const radius, size_t const first, std::vector<size_t>& tracks) const
+{
+  tracks.clear();
+
+  float const dx = point.x() - mPVtx.x();
+  float const dy = point.y() - mPVtx.y();
+
+  // the distance of the point to a line in the transverse plane changes by at most
+  // perp * dPhi within a phi bin
+  float const window = radius + std::sqrt(dx * dx + dy * dy) * 0.5 * mPhiBinWidth;
+
+  for(int iPhi = 0; iPhi < mNPhiBins; ++iPhi)
+  {
+    float const d0Point = -dx * mSinPhi[iPhi] + dy * mCosPhi[iPhi];
+    int const iD0Max = d0Bin(d0Point + window);
+
+    for(int iD0 = d0Bin(d0Point - window); iD0 <= iD0Max; ++iD0)
+    {
+      std::vector<size_t> const& lines = mBins[bin(iPhi, iD0)];
+
+      for(size_t i = 0; i < lines.size(); ++i)
+      {
+        size_t const idx = lines[i];
+        if(idx < first) continue;
+
+        if((point - mOrigins[idx]).cross(mDirections[idx]).mag() < radius) tracks.push_back(idx);
+      }
+    }
+  }
+
+  // keep the order of the full combinatorial loop
+  std::sort(tracks.begin(), tracks.end());
+}
+
+StThreeVectorF StTrackLineGrid::dcaMidPoint(StThreeVectorF const& o1, StThreeVectorF const& u1,
+                                            StThreeVectorF const& o2, StThreeVectorF const& u2)
+{
+  StThreeVectorF const w = o1 - o2;
+  float const b = u1.dot(u2);
+  float const d = u1.dot(w);
+  float const e = u2.dot(w);
+  float const denom = 1. - b * b;
+
+  float s = 0.;
+  float t = e;
+  if(denom > 1e-6)
+  {
+    s = (b * e - d) / denom;
+    t = (e - b * d) / denom;
+  }
+
+  return (o1 + s * u1 + o2 + t * u2) * 0.5;
+}
@@ -0,0 +1,67 @@
+#ifndef StTrackLineGrid_h
+#define StTrackLineGrid_h
+
+/* **************************************************
+ *  A per-event index of the straight-line approximation
+ *  of tracks at their point of closest approach to the
+ *  primary vertex.
+ *
+ *  Lines are binned in the transverse plane by their
+ *  direction (phi folded into [0, pi)) and signed distance
+ *  to the primary vertex (d0). findTracks() returns the
+ *  tracks whose 3D line passes within a radius of a point
+ *  (e.g. a Kπ vertex) visiting only the compatible d0 bins
+ *  in every phi bin. The transverse projection can only
+ *  shrink distances, so the grid never drops a good track.
+ *
+ *  Authors:  **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <vector>
+#include "StarClassLibrary/StThreeVectorF.hh"
+
+class StTrackLineGrid
+{
+  public:
+    StTrackLineGrid(int nPhiBins = 36, int nD0Bins = 40, float d0Max = 0.2);
+
+    void clear(StThreeVectorF const& pVtx);
+    void addTrack(StThreeVectorF const& origin, StThreeVectorF const& mom);
+
+    // indices (in order of addTrack calls) of tracks >= first whose line passes within radius of point
+    void findTracks(StThreeVectorF const& point, float radius, size_t first, std::vector<size_t>& tracks) const;
+
+    size_t size() const;
+    StThreeVectorF const& origin(size_t i) const;
+    StThreeVectorF const& direction(size_t i) const;
+
+    // middle of the segment of closest approach of two lines with unit directions
+    static StThreeVectorF dcaMidPoint(StThreeVectorF const& o1, StThreeVectorF const& u1,
+                                      StThreeVectorF const& o2, StThreeVectorF const& u2);
+
+  private:
+    int bin(int iPhi, int iD0) const;
+    int d0Bin(float d0) const;
+
+    int   mNPhiBins;
+    int   mND0Bins;
+    float mD0Max;
+    float mPhiBinWidth;
+    float mD0BinWidth;
+
+    StThreeVectorF mPVtx;
+    std::vector<StThreeVectorF> mOrigins;
+    std::vector<StThreeVectorF> mDirections; // unit vectors
+    std::vector<std::vector<size_t> > mBins;
+    std::vector<float> mSinPhi; // at phi bin centers
+    std::vector<float> mCosPhi;
+};
+inline size_t StTrackLineGrid::size() const { return mOrigins.size(); }
+inline StThreeVectorF const& StTrackLineGrid::origin(size_t i) const { return mOrigins[i]; }
+inline StThreeVectorF const& StTrackLineGrid::direction(size_t i) const { return mDirections[i]; }
+inline int StTrackLineGrid::bin(int iPhi, int iD0) const { return iPhi * mND0Bins + iD0; }
+#endif
@@ -0,0 +1,149 @@
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "TChain.h"
+#include "TFile.h"
+#include "TTreeCache.h"
+#include "TObjArray.h"
+#include "TUrl.h"
+
+#include "StPicoChainReader.h"
+
+ClassImp(StPicoChainReader)
+
+// _________________________________________________________
+StPicoChainReader::StPicoChainReader(char const* name) : TObject(),
+  mChain(NULL), mName(name), mCacheSize(32 * 1024 * 1024), mCacheLearnEntries(100), mPrefetchNextFile(true),
+  mTreeNumber(-1), mFirstEntry(0), mLastEntry(0), mNEntriesFile(0),
+  mNFiles(0), mNEntries(0), mBytesUnzipped(0), mBytesRead(0), mReadCalls(0),
+  mCacheEfficiency(0.), mCacheEfficiencyRel(0.) {
+  mTimer.Reset();
+}
+
+// _________________________________________________________
+void StPicoChainReader::init(TChain* chain) {
+  mChain = chain;
+
+  if (!mBranches.empty()) {
+    mChain->SetBranchStatus("*", 0);
+    for (unsigned int ii = 0; ii < mBranches.size(); ++ii)
+      mChain->SetBranchStatus(mBranches[ii].Data(), 1);
+  }
+
+  if (mCacheSize <= 0)
+    return;
+
+  // -- the cache is attached to the file of the current tree, it moves with the chain
+  if (mChain->LoadTree(0) < 0) {
+    Error("StPicoChainReader::init", "%s - no entries in the chain, no TTreeCache", mName.Data());
+    return;
+  }
+
+  TTreeCache::SetLearnEntries(mCacheLearnEntries);
+  mChain->SetCacheSize(mCacheSize);
+
+  // -- the learning phase adds any other branch the analysis reads
+  for (unsigned int ii = 0; ii < mBranches.size(); ++ii)
+    mChain->AddBranchToCache(mBranches[ii].Data(), kTRUE);
+}
+
+// _________________________________________________________
+Int_t StPicoChainReader::getEntry(Long64_t const entry) {
+  mTimer.Start(kFALSE);
+
+  // -- the chain closes the file when it moves on, collect its statistics before
+  if (mTreeNumber >= 0 && (entry < mFirstEntry || entry >= mLastEntry))
+    addFileStats();
+
+  Int_t const nBytes = mChain->GetEntry(entry);
+
+  if (mChain->GetTreeNumber() != mTreeNumber)
+    newFile();
+
+  mTimer.Stop();
+
+  if (nBytes > 0) {
+    ++mNEntries;
+    ++mNEntriesFile;
+    mBytesUnzipped += nBytes;
+  }
+
+  return nBytes;
+}
+
+// _________________________________________________________
+void StPicoChainReader::newFile() {
+  mTreeNumber = mChain->GetTreeNumber();
+  if (mTreeNumber < 0 || !mChain->GetTree())
+    return;
+
+  mFirstEntry = mChain->GetTreeOffset()[mTreeNumber];
+  mLastEntry = mFirstEntry + mChain->GetTree()->GetEntries();
+  mNEntriesFile = 0;
+  ++mNFiles;
+
+  if (mPrefetchNextFile)
+    prefetchFile(mTreeNumber + 1);
+}
+
+// _________________________________________________________
+void StPicoChainReader::addFileStats() {
+  TFile* file = mChain->GetCurrentFile();
+  if (!file)
+    return;
+
+  mBytesRead += file->GetBytesRead();
+  mReadCalls += file->GetReadCalls();
+
+  TTreeCache* cache = dynamic_cast<TTreeCache*>(file->GetCacheRead(mChain->GetTree()));
+  if (cache) {
+    mCacheEfficiency    += mNEntriesFile * cache->GetEfficiency();
+    mCacheEfficiencyRel += mNEntriesFile * cache->GetEfficiencyRel();
+  }
+
+  mTreeNumber = -1;
+}
+
+// _________________________________________________________
+void StPicoChainReader::prefetchFile(int const treeNumber) const {
+  TObjArray const* files = mChain->GetListOfFiles();
+  if (treeNumber >= files->GetEntriesFast())
+    return;
+
+  char const* fileName = files->At(treeNumber)->GetTitle();
+  TUrl const url(fileName, kTRUE);
+
+  if (strcmp(url.GetProtocol(), "file") != 0) {
+    // -- picked up by TFile::Open when the chain opens the file
+    TFile::AsyncOpen(fileName);
+    return;
+  }
+
+  // -- the readahead continues in the kernel after the descriptor is closed
+  int const fd = open(url.GetFile(), O_RDONLY);
+  if (fd < 0)
+    return;
+  posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  close(fd);
+}
+
+// _________________________________________________________
+void StPicoChainReader::printStats() {
+  if (mTreeNumber >= 0)
+    addFileStats();
+
+  double const realTime = mTimer.RealTime();
+
+  Info("StPicoChainReader", "%s - read %lld entries of %d files in %.2f s, %.1f entries/s", mName.Data(),
+       mNEntries, mNFiles, realTime, realTime > 0 ? mNEntries / realTime : 0.);
+  Info("StPicoChainReader", "%s - %.2f MB unzipped, %.2f MB read from storage in %lld read calls (%.2f calls/entry)",
+       mName.Data(), mBytesUnzipped / 1024. / 1024., mBytesRead / 1024. / 1024., mReadCalls,
+       mNEntries > 0 ? static_cast<double>(mReadCalls) / mNEntries : 0.);
+
+  if (mCacheSize > 0 && mNEntries > 0)
+    Info("StPicoChainReader", "%s - TTreeCache %.1f MB, %zu declared branches, efficiency %.3f, relative efficiency %.3f",
+	 mName.Data(), mCacheSize / 1024. / 1024., mBranches.size(), mCacheEfficiency / mNEntries, mCacheEfficiencyRel / mNEntries);
+  else
+    Info("StPicoChainReader", "%s - no TTreeCache", mName.Data());
+}
@@ -0,0 +1,113 @@
+#ifndef STPICOCHAINREADER_H
+#define STPICOCHAINREADER_H
+
+/* **************************************************
+ *  Reader setup for the candidate tree chains
+ *
+ * **************************************************
+ *  Configures the reading of a TChain of candidate
+ *  trees (picoD0, picoNpe, HF trees):
+ *    - TTreeCache of setCacheSize() bytes, with a
+ *      learning phase of setCacheLearnEntries() entries
+ *    - only the branches declared with readBranch() are
+ *      enabled and cached, all branches if none is declared
+ *    - when the chain moves to a new file the next one is
+ *      prefetched: asynchronous TFile::AsyncOpen for remote
+ *      files, kernel readahead (POSIX_FADV_WILLNEED) for
+ *      local and network file systems
+ *
+ *  The setters have to be called before init(), init()
+ *  after the branch addresses of the chain are set.
+ *  printStats() prints the read calls, the bytes read
+ *  from storage and the cache efficiency.
+ *
+ *  The branches of split candidate events are named
+ *  after the data members, e.g. for the picoD0 tree
+ *    reader->readBranch("mRunId");
+ *    reader->readBranch("mEventId");
+ *    reader->readBranch("mNKaonPion");
+ *    reader->readBranch("mKaonPionArray*");
+ *  Members which are not enabled keep their default.
+ *
+ * **************************************************
+ *
+ *  Initial Authors:
+ *          **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "TObject.h"
+#include "TString.h"
+#include "TStopwatch.h"
+
+class TChain;
+
+class StPicoChainReader : public TObject
+{
+ public:
+  StPicoChainReader(char const* name = "StPicoChainReader");
+  virtual ~StPicoChainReader() {}
+
+  void setCacheSize(Long64_t bytes);    // 0 disables the TTreeCache
+  void setCacheLearnEntries(int nEntries);
+  void setPrefetchNextFile(bool b);
+  void readBranch(char const* pattern); // wildcards as in TTree::SetBranchStatus
+
+  // -- the settings above of reader, not its chain and statistics
+  void copySettings(StPicoChainReader const& reader);
+
+  // -- chain is not owned
+  void init(TChain* chain);
+
+  Int_t getEntry(Long64_t entry);
+
+  void printStats();
+
+ private:
+  void newFile();
+  void addFileStats();
+  void prefetchFile(int treeNumber) const;
+
+  TChain* mChain; //!
+
+  TString  mName;
+  Long64_t mCacheSize;
+  int      mCacheLearnEntries;
+  bool     mPrefetchNextFile;
+  std::vector<TString> mBranches;
+
+  // -- entries of the current file
+  int      mTreeNumber;
+  Long64_t mFirstEntry;
+  Long64_t mLastEntry;
+  Long64_t mNEntriesFile;
+
+  // -- statistics
+  int        mNFiles;
+  Long64_t   mNEntries;
+  Long64_t   mBytesUnzipped;
+  Long64_t   mBytesRead;
+  Long64_t   mReadCalls;
+  double     mCacheEfficiency;    // sum over files, weighted by the entries read
+  double     mCacheEfficiencyRel;
+  TStopwatch mTimer;
+
+  ClassDef(StPicoChainReader, 0)
+};
+
+inline void StPicoChainReader::setCacheSize(Long64_t bytes)         { mCacheSize = bytes; }
+inline void StPicoChainReader::setCacheLearnEntries(int nEntries)   { mCacheLearnEntries = nEntries; }
+inline void StPicoChainReader::setPrefetchNextFile(bool b)          { mPrefetchNextFile = b; }
+inline void StPicoChainReader::readBranch(char const* pattern)      { mBranches.push_back(pattern); }
+inline void StPicoChainReader::copySettings(StPicoChainReader const& reader) {
+  mCacheSize = reader.mCacheSize;
+  mCacheLearnEntries = reader.mCacheLearnEntries;
+  mPrefetchNextFile = reader.mPrefetchNextFile;
+  mBranches = reader.mBranches;
+}
+#endif
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "StPicoCutsBase.h"
+#include "StPicoDaughterTrack.h"
 
 #include "StLorentzVectorF.hh"
 #include "StThreeVectorF.hh"
@@ -205,7 +206,24 @@ bool StPicoCutsBase::isGoodEvent(StPicoDst const * const picoDst, int *aEventCut
 bool StPicoCutsBase::isGoodRun(StPicoEvent const * const picoEvent) const {
   // -- is good run (not in bad runlist)
 
-  return (!(std::binary_search(mVecBadRunList.begin(), mVecBadRunList.end(), picoEvent->runId())));
+  return isGoodRun(picoEvent->runId());
+}
+
+// _________________________________________________________
+bool StPicoCutsBase::isGoodEvent(int const runId, bool const goodTrigger, float const vz, float const vzVpd) const {
+  // -- method to check if good event, for readers without the picoDst
+  //    the trigger selection is passed in, e.g. the one stored by the producer
+
+  return (isGoodRun(runId) && goodTrigger &&
+	  fabs(vz) < mVzMax &&
+	  fabs(vz - vzVpd) < mVzVpdVzMax);
+}
+
+// _________________________________________________________
+bool StPicoCutsBase::isGoodRun(int const runId) const {
+  // -- is good run (not in bad runlist), for readers without the picoDst
+
+  return (!(std::binary_search(mVecBadRunList.begin(), mVecBadRunList.end(), runId)));
 }
 
 // _________________________________________________________
@@ -328,6 +346,65 @@ bool StPicoCutsBase::isHybridTOFHadron(StPicoTrack const *trk, float const & tof
 
 // =======================================================================
 
+// _________________________________________________________
+bool StPicoCutsBase::isGoodTrack(StPicoDaughterTrack const * const trk) const {
+  // -- same as for StPicoTrack
+  return ((!mRequireHFT || trk->isHFTTrack()) && 
+	  trk->nHitsFit() >= mNHitsFitMin);
+}
+
+// _________________________________________________________
+bool StPicoCutsBase::isTPCHadron(StPicoDaughterTrack const * const trk, int pidFlag) const {
+  // -- check for good hadron in TPC, pT and eta at the primary vertex of the snapshot
+
+  float nSigma = std::numeric_limits<float>::quiet_NaN();
+
+  if (pidFlag == kPion)
+    nSigma = fabs(trk->nSigmaPion());
+  else if (pidFlag == kKaon)
+    nSigma = fabs(trk->nSigmaKaon());
+  else if (pidFlag == kProton)
+    nSigma = fabs(trk->nSigmaProton());
+
+  return ( trk->gPt() >= mPtRange[pidFlag][0] && trk->gPt() < mPtRange[pidFlag][1] &&
+	   fabs(trk->gEta()) < mEtaMax[pidFlag] &&
+	   nSigma < mTPCNSigmaMax[pidFlag] );
+}
+
+// _________________________________________________________
+bool StPicoCutsBase::isTOFHadron(StPicoDaughterTrack const *trk, int pidFlag) const {
+  // -- check for good hadron in TOF in ptot range
+  //    return:
+  //      not in ptot range : true
+
+  float const ptot = trk->gPtot();
+  if (ptot < mPtotRangeTOF[pidFlag][0] || ptot >= mPtotRangeTOF[pidFlag][1])
+    return true;
+
+  float const tofBeta = getTofBeta(trk);
+  return isTOFHadronPID(ptot, tofBeta, pidFlag);
+}
+
+// _________________________________________________________
+bool StPicoCutsBase::isHybridTOFHadron(StPicoDaughterTrack const *trk, int pidFlag) const {
+  // -- check for good hadron in TOF in ptot range
+  //    return:
+  //      not in ptot range : true
+  //      no TOF info       : true
+
+  float const ptot = trk->gPtot();
+  if (ptot < mPtotRangeHybridTOF[pidFlag][0] || ptot >= mPtotRangeHybridTOF[pidFlag][1])
+    return true;
+
+  float const tofBeta = getTofBeta(trk);
+  if (tofBeta <= 0 || tofBeta != tofBeta) 
+    return true;
+
+  return isTOFHadronPID(ptot, tofBeta, pidFlag);
+}
+
+// =======================================================================
+
 // _________________________________________________________
 StPicoBTofPidTraits* StPicoCutsBase::hasTofPid(StPicoTrack const * const trk) const {
   // -- check if track has TOF pid information
@@ -344,9 +421,14 @@ float StPicoCutsBase::getTofBetaBase(StPicoTrack const * const trk) const {
   //      - primary hadrons 
   //      - secondarys from charm decays (as an approximation)
 
+  return getTofBetaBase(trk, hasTofPid(trk), mPrimVtx);
+}
+
+// _________________________________________________________
+float StPicoCutsBase::getTofBetaBase(StPicoTrack const * const trk, StPicoBTofPidTraits const * const tofPid,
+				     StThreeVectorF const & pVtx) {
   float beta = std::numeric_limits<float>::quiet_NaN();
 
-  StPicoBTofPidTraits *tofPid = hasTofPid(trk);
   if (!tofPid) 
     return beta;
 
@@ -354,7 +436,7 @@ float StPicoCutsBase::getTofBetaBase(StPicoTrack const * const trk) const {
   if (beta < 1e-4) {
     StThreeVectorF const btofHitPos = tofPid->btofHitPos();
     StPhysicalHelixD helix = trk->helix();
-    float pathLength = tofPathLength(&mPrimVtx, &btofHitPos, helix.curvature());
+    float pathLength = tofPathLength(&pVtx, &btofHitPos, helix.curvature());
     float tof = tofPid->btof();
     beta = (tof > 0) ? pathLength / (tof * (C_C_LIGHT / 1.e9)) : std::numeric_limits<float>::quiet_NaN();
   }
@@ -374,6 +456,12 @@ float StPicoCutsBase::getTofBeta(StPicoTrack const * const trk) const {
   return ((helix.origin() - mPrimVtx).mag() < mPrimaryDCAtoVtxMax) ? getTofBetaBase(trk) : std::numeric_limits<float>::quiet_NaN();
 }
 
+// _________________________________________________________
+float StPicoCutsBase::getTofBeta(StPicoDaughterTrack const * const trk) const {
+  // -- same cut on the distance to the primary vertex as for the pico track
+  return (trk->dcaToPv() < mPrimaryDCAtoVtxMax) ? trk->tofBeta() : std::numeric_limits<float>::quiet_NaN();
+}
+
 // _________________________________________________________
 float StPicoCutsBase::getTofBeta(StPicoTrack const * const trk, 
 				 StLorentzVectorF const & secondaryMother, StThreeVectorF const & secondaryVtx) const {
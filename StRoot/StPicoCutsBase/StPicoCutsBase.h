@@ -36,6 +36,7 @@ class StPicoTrack;
 class StPicoEvent;
 class StPicoDst;
 class StPicoBTofPidTraits;
+class StPicoDaughterTrack;
 
 class StPicoCutsBase : public TNamed
 {
@@ -53,10 +54,12 @@ class StPicoCutsBase : public TNamed
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
 
   bool isGoodEvent(StPicoDst const * const picoDst, int *aEventCuts = NULL);
+  bool isGoodEvent(int runId, bool goodTrigger, float vz, float vzVpd) const;
 
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
 
   bool isGoodRun(StPicoEvent const * const picoEvent) const;
+  bool isGoodRun(int runId) const;
   bool isGoodTrigger(StPicoEvent const * const picoEvent) const;
   bool isGoodTrack(StPicoTrack const * const trk) const;
 
@@ -117,6 +120,22 @@ class StPicoCutsBase : public TNamed
   bool isHybridTOFKaon(StPicoTrack const *trk,   float const & tofBeta, StThreeVectorF const & vtx) const;
   bool isHybridTOFProton(StPicoTrack const *trk, float const & tofBeta, StThreeVectorF const & vtx) const;
 
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
+  // -- Candidate daughters stored in the candidate trees, see StPicoDaughterTrack
+  //    the same cuts as for StPicoTrack, with the quantities of the snapshot
+  //    (momentum at the primary vertex, TOF beta of the producing maker)
+  // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
+
+  bool isGoodTrack(StPicoDaughterTrack const * const trk) const;
+
+  bool isTPCHadron(StPicoDaughterTrack const * const trk, int pidFlag) const;
+  bool isTPCPion(StPicoDaughterTrack const *trk) const;
+  bool isTPCKaon(StPicoDaughterTrack const *trk) const;
+  bool isTPCProton(StPicoDaughterTrack const *trk) const;
+
+  bool isTOFHadron(StPicoDaughterTrack const *trk, int pidFlag) const;
+  bool isHybridTOFHadron(StPicoDaughterTrack const *trk, int pidFlag) const;
+
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
   // -- pT and eta cuts (also already inside isTPCHadron)
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
@@ -200,9 +219,13 @@ class StPicoCutsBase : public TNamed
 
   // -- calculate beta of track -- basic calculation
   float getTofBetaBase(StPicoTrack const* const trk) const;
+  // -- same, tofPid can be NULL, also used for the StPicoDaughterTrack snapshots
+  static float getTofBetaBase(StPicoTrack const* const trk, StPicoBTofPidTraits const* const tofPid, StThreeVectorF const& pVtx);
 
   // -- calculate beta of track -- for primary particles
   float getTofBeta(StPicoTrack const* const trk) const;
+  // -- same for a snapshot, from its stored beta and distance to the primary vertex
+  float getTofBeta(StPicoDaughterTrack const* const trk) const;
 
   // -- calculate corrected beta of track -- for secondary particles
   float getTofBeta(StPicoTrack const * const trk, 
@@ -336,6 +359,10 @@ inline bool StPicoCutsBase::isTPCPion(StPicoTrack const * const trk)   const {re
 inline bool StPicoCutsBase::isTPCKaon(StPicoTrack const * const trk)   const {return isTPCHadron(trk, StPicoCutsBase::kKaon); }
 inline bool StPicoCutsBase::isTPCProton(StPicoTrack const * const trk) const {return isTPCHadron(trk, StPicoCutsBase::kProton); }
 
+inline bool StPicoCutsBase::isTPCPion(StPicoDaughterTrack const * const trk)   const {return isTPCHadron(trk, StPicoCutsBase::kPion); }
+inline bool StPicoCutsBase::isTPCKaon(StPicoDaughterTrack const * const trk)   const {return isTPCHadron(trk, StPicoCutsBase::kKaon); }
+inline bool StPicoCutsBase::isTPCProton(StPicoDaughterTrack const * const trk) const {return isTPCHadron(trk, StPicoCutsBase::kProton); }
+
 inline bool StPicoCutsBase::isTOFPion(StPicoTrack const *trk)   const { float tofBeta = getTofBeta(trk);  
                                                                         return isTOFHadron(trk, tofBeta, StPicoCutsBase::kPion, mPrimVtx); }
 inline bool StPicoCutsBase::isTOFKaon(StPicoTrack const *trk)   const { float tofBeta = getTofBeta(trk);  
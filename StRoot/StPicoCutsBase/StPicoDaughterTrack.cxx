@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#include "TClonesArray.h"
+
+#include "StPicoDaughterTrack.h"
+#include "StPicoCutsBase.h"
+
+#include "StPicoDstMaker/StPicoTrack.h"
+
+ClassImp(StPicoDaughterTrack)
+
+// _________________________________________________________
+StPicoDaughterTrack::StPicoDaughterTrack() : TObject(),
+  mIdx(std::numeric_limits<unsigned short>::max()), mNHitsFit(0), mHftFlags(0),
+  mNSigmaPion(0), mNSigmaKaon(0), mNSigmaProton(0), mNSigmaElectron(0), mTofBeta(0),
+  mGPt(std::numeric_limits<float>::quiet_NaN()), mGEta(std::numeric_limits<float>::quiet_NaN()),
+  mGPtot(std::numeric_limits<float>::quiet_NaN()), mDcaToPv(0) {
+}
+
+// _________________________________________________________
+StPicoDaughterTrack::StPicoDaughterTrack(StPicoTrack const& trk, unsigned short const idx,
+					 StThreeVectorF const& pVtx, float const bField, StPicoBTofPidTraits const* const tofPid) : TObject(),
+  mIdx(idx), mNHitsFit(static_cast<Char_t>(trk.nHitsFit() * trk.charge())), mHftFlags(0),
+  mNSigmaPion(toNSigma(trk.nSigmaPion())), mNSigmaKaon(toNSigma(trk.nSigmaKaon())),
+  mNSigmaProton(toNSigma(trk.nSigmaProton())), mNSigmaElectron(toNSigma(trk.nSigmaElectron())),
+  mTofBeta(0), mGPt(trk.gPt()), mGEta(std::numeric_limits<float>::quiet_NaN()),
+  mGPtot(std::numeric_limits<float>::quiet_NaN()), mDcaToPv(0) {
+
+  // -- the quantities of the StPicoTrack cuts of StPicoCutsBase
+  StThreeVectorF const gMom = trk.gMom(pVtx, bField);
+  mGEta = gMom.pseudoRapidity();
+  mGPtot = gMom.mag();
+  mDcaToPv = (trk.helix().origin() - pVtx).mag();
+  float const tofBeta = StPicoCutsBase::getTofBetaBase(&trk, tofPid, pVtx);
+
+  if (trk.hasPxl1Hit()) mHftFlags |= kPxl1;
+  if (trk.hasPxl2Hit()) mHftFlags |= kPxl2;
+  if (trk.hasIstHit())  mHftFlags |= kIst;
+  if (trk.hasSstHit())  mHftFlags |= kSst;
+  if (trk.isHFTTrack()) mHftFlags |= kHFTTrack;
+
+  // -- beta of 0 is kept for tracks without TOF
+  if (tofBeta > 0) {
+    float const beta = std::floor(tofBeta * 20000.f + 0.5f);
+    mTofBeta = beta < std::numeric_limits<unsigned short>::max() ? static_cast<UShort_t>(std::max(beta, 1.f))
+                                                                 : std::numeric_limits<unsigned short>::max();
+  }
+}
+
+// _________________________________________________________
+short StPicoDaughterTrack::toNSigma(float const nSigma) {
+  // -- nSigma * 1000, saturated at the range of short
+  if (nSigma != nSigma)
+    return std::numeric_limits<short>::max();
+
+  float const n = std::floor(nSigma * 1000.f + 0.5f);
+  if (n <= std::numeric_limits<short>::min())
+    return std::numeric_limits<short>::min();
+
+  return n < std::numeric_limits<short>::max() ? static_cast<short>(n) : std::numeric_limits<short>::max();
+}
+
+// _________________________________________________________
+StPicoDaughterTrack const* StPicoDaughterTrack::find(TClonesArray const* const daughters, int const nDaughters, unsigned short const idx) {
+  // -- binary search, the daughters are stored in increasing picoDst index
+  int first = 0;
+  int last = nDaughters;
+
+  while (first < last) {
+    int const mid = (first + last) / 2;
+    StPicoDaughterTrack const* daughter = static_cast<StPicoDaughterTrack const*>(daughters->UncheckedAt(mid));
+
+    if (daughter->index() < idx)
+      first = mid + 1;
+    else
+      last = mid;
+  }
+
+  if (first == nDaughters)
+    return NULL;
+
+  StPicoDaughterTrack const* daughter = static_cast<StPicoDaughterTrack const*>(daughters->UncheckedAt(first));
+  return daughter->index() == idx ? daughter : NULL;
+}
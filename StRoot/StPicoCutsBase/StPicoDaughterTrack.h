@@ -0,0 +1,119 @@
+#ifndef STPICODAUGHTERTRACK_H
+#define STPICODAUGHTERTRACK_H
+
+/* **************************************************
+ *  Compact snapshot of a candidate daughter track
+ *
+ * **************************************************
+ *  Keeps the track quantities used by the analysis cuts
+ *  of candidate daughters, so that the candidate trees
+ *  (StPicoD0Event, StPicoNpeEvent, StPicoHFEvent) can be
+ *  analysed without reading the picoDst:
+ *    - TPC nSigma of pion, kaon, proton and electron
+ *    - nHitsFit (signed by the charge as in StPicoTrack)
+ *    - TOF beta, as StPicoCutsBase::getTofBetaBase()
+ *    - distance of the track origin to the primary vertex,
+ *      for the TOF cut of StPicoCutsBase::getTofBeta()
+ *    - HFT hit flags
+ *    - global pT, and eta and momentum at the primary vertex,
+ *      the quantities the StPicoTrack cuts use
+ *
+ *  One snapshot is stored per unique daughter. The
+ *  snapshots of an event are kept in increasing picoDst
+ *  index, candidates find theirs by the daughter index
+ *  they already store, see find().
+ *
+ * **************************************************
+ *
+ *  Initial Authors:
+ *          **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "TObject.h"
+#include "StThreeVectorF.hh"
+
+class TClonesArray;
+class StPicoTrack;
+class StPicoBTofPidTraits;
+
+class StPicoDaughterTrack : public TObject
+{
+ public:
+  StPicoDaughterTrack();
+  // -- tofPid NULL if the track has no TOF information
+  StPicoDaughterTrack(StPicoTrack const& trk, unsigned short idx, StThreeVectorF const& pVtx, float bField,
+                      StPicoBTofPidTraits const* tofPid);
+  ~StPicoDaughterTrack() {}
+
+  unsigned short index() const;   // index of the track in the picoDst
+  short charge()         const;
+  int   nHitsFit()       const;
+  float nSigmaPion()     const;
+  float nSigmaKaon()     const;
+  float nSigmaProton()   const;
+  float nSigmaElectron() const;
+  float tofBeta()        const;   // NaN if not available, without the cut on dcaToPv()
+  float dcaToPv()        const;   // 0 for version 1 snapshots
+  float gPt()            const;
+  float gEta()           const;
+  float gPtot()          const;
+
+  // -- HFT
+  enum eHftFlag {kPxl1 = 0x1, kPxl2 = 0x2, kIst = 0x4, kSst = 0x8, kHFTTrack = 0x10};
+  unsigned char hftFlags() const;
+  bool  hasPxl1Hit()       const;
+  bool  hasPxl2Hit()       const;
+  bool  hasIstHit()        const;
+  bool  hasSstHit()        const;
+  bool  isHFTTrack()       const;
+
+  // -- snapshot of picoDst track idx in the first nDaughters entries of a
+  //    daughter array in increasing index, NULL if not stored
+  static StPicoDaughterTrack const* find(TClonesArray const* daughters, int nDaughters, unsigned short idx);
+
+ private:
+  static short toNSigma(float nSigma);
+
+  unsigned short mIdx;
+  Char_t         mNHitsFit;        // nHitsFit * charge
+  UChar_t        mHftFlags;        // eHftFlag
+  Short_t        mNSigmaPion;      // nSigma * 1000
+  Short_t        mNSigmaKaon;      // nSigma * 1000
+  Short_t        mNSigmaProton;    // nSigma * 1000
+  Short_t        mNSigmaElectron;  // nSigma * 1000
+  UShort_t       mTofBeta;         // beta * 20000, 0 if not available
+  Float_t        mGPt;
+  Float_t        mGEta;
+  Float_t        mGPtot;           // NaN for version 1 snapshots
+  Float_t        mDcaToPv;
+
+  ClassDef(StPicoDaughterTrack, 2)
+};
+
+inline unsigned short StPicoDaughterTrack::index()          const { return mIdx; }
+inline short          StPicoDaughterTrack::charge()         const { return mNHitsFit > 0 ? 1 : -1; }
+inline int            StPicoDaughterTrack::nHitsFit()       const { return mNHitsFit > 0 ? mNHitsFit : -mNHitsFit; }
+inline float          StPicoDaughterTrack::nSigmaPion()     const { return mNSigmaPion / 1000.f; }
+inline float          StPicoDaughterTrack::nSigmaKaon()     const { return mNSigmaKaon / 1000.f; }
+inline float          StPicoDaughterTrack::nSigmaProton()   const { return mNSigmaProton / 1000.f; }
+inline float          StPicoDaughterTrack::nSigmaElectron() const { return mNSigmaElectron / 1000.f; }
+inline float          StPicoDaughterTrack::tofBeta()        const { return mTofBeta ? mTofBeta / 20000.f : std::numeric_limits<float>::quiet_NaN(); }
+inline float          StPicoDaughterTrack::gPt()            const { return mGPt; }
+inline float          StPicoDaughterTrack::gEta()           const { return mGEta; }
+inline float          StPicoDaughterTrack::dcaToPv()        const { return mDcaToPv; }
+inline float          StPicoDaughterTrack::gPtot()          const { return mGPtot == mGPtot ? mGPtot : mGPt * std::cosh(mGEta); }
+
+inline unsigned char  StPicoDaughterTrack::hftFlags()       const { return mHftFlags; }
+inline bool           StPicoDaughterTrack::hasPxl1Hit()     const { return mHftFlags & kPxl1; }
+inline bool           StPicoDaughterTrack::hasPxl2Hit()     const { return mHftFlags & kPxl2; }
+inline bool           StPicoDaughterTrack::hasIstHit()      const { return mHftFlags & kIst; }
+inline bool           StPicoDaughterTrack::hasSstHit()      const { return mHftFlags & kSst; }
+inline bool           StPicoDaughterTrack::isHFTTrack()     const { return mHftFlags & kHFTTrack; }
+#endif
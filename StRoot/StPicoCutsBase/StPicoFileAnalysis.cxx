@@ -0,0 +1,38 @@
+#include "TList.h"
+#include "TH1.h"
+
+#include "StPicoFileAnalysis.h"
+#include "StPicoChainReader.h"
+
+ClassImp(StPicoFileAnalysis)
+
+// _________________________________________________________
+StPicoFileAnalysis::StPicoFileAnalysis(char const* name) : TObject(),
+  mName(name), mOutList(NULL), mNEvents(0), mChainReader(new StPicoChainReader(name)) {
+}
+
+// _________________________________________________________
+StPicoFileAnalysis::~StPicoFileAnalysis() {
+  delete mOutList;
+  delete mChainReader;
+}
+
+// _________________________________________________________
+void StPicoFileAnalysis::copyConfiguration(StPicoFileAnalysis const& analysis) {
+  mChainReader->copySettings(*analysis.mChainReader);
+}
+
+// _________________________________________________________
+void StPicoFileAnalysis::init() {
+  // -- the output is owned by the list, not by the current directory
+  bool const oldStatus = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(false);
+
+  mOutList = new TList();
+  mOutList->SetName(mName.Data());
+  mOutList->SetOwner(true);
+
+  initAnalysis();
+
+  TH1::AddDirectory(oldStatus);
+}
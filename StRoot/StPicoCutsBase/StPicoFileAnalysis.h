@@ -0,0 +1,86 @@
+#ifndef STPICOFILEANALYSIS_H
+#define STPICOFILEANALYSIS_H
+
+/* **************************************************
+ *  Base class of candidate tree analyses
+ *
+ * **************************************************
+ *  Holds the state of one analysis of candidate trees:
+ *  its configuration (cuts) and its output list. The same
+ *  analysis is run event by event from a maker, or file
+ *  by file on worker threads by StPicoFileParallelDriver,
+ *  which runs one clone() per worker and merges their
+ *  output lists.
+ *
+ *  Implement in daughter class
+ *    clone()        - same configuration, no output
+ *    initAnalysis() - book the output in mOutList
+ *    processFile()  - analyse all events of one file
+ *
+ *  Histograms are not attached to a directory, the
+ *  output list owns them.
+ *
+ *  chainReader() holds the reader settings (cache size,
+ *  learning entries, branches) of processFile(), clone()
+ *  copies them with copyConfiguration().
+ *
+ * **************************************************
+ *
+ *  Initial Authors:
+ *          **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include "TObject.h"
+#include "TString.h"
+
+class TList;
+class StPicoChainReader;
+
+class StPicoFileAnalysis : public TObject
+{
+ public:
+  StPicoFileAnalysis(char const* name = "StPicoFileAnalysis");
+  virtual ~StPicoFileAnalysis();
+
+  virtual StPicoFileAnalysis* clone() const = 0;
+
+  // -- creates the output list and calls initAnalysis()
+  void init();
+
+  // -- false if the file could not be analysed
+  virtual bool processFile(char const* fileName) = 0;
+
+  char const* name()       const;
+  TList*      outputList() const;
+  Long64_t    nEvents()    const;
+
+  // -- settings of the readers of processFile(), set them on the prototype
+  StPicoChainReader* chainReader() const;
+
+ protected:
+  virtual void initAnalysis() = 0;
+
+  // -- to be called by clone(), copies the configuration of the base class
+  void copyConfiguration(StPicoFileAnalysis const& analysis);
+
+  TString  mName;
+  TList*   mOutList;
+  Long64_t mNEvents; // to be counted by the daughter class
+  StPicoChainReader* mChainReader;
+
+ private:
+  StPicoFileAnalysis(StPicoFileAnalysis const&);
+  StPicoFileAnalysis& operator=(StPicoFileAnalysis const&);
+
+  ClassDef(StPicoFileAnalysis, 0)
+};
+
+inline char const* StPicoFileAnalysis::name()       const { return mName.Data(); }
+inline TList*      StPicoFileAnalysis::outputList() const { return mOutList; }
+inline Long64_t    StPicoFileAnalysis::nEvents()    const { return mNEvents; }
+inline StPicoChainReader* StPicoFileAnalysis::chainReader() const { return mChainReader; }
+#endif
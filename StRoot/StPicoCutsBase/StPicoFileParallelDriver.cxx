@@ -0,0 +1,167 @@
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <string>
+
+#include "RVersion.h"
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+#include "TROOT.h"
+#endif
+#include "TFile.h"
+#include "TList.h"
+#include "TClass.h"
+#include "TStopwatch.h"
+
+#include "StPicoFileParallelDriver.h"
+#include "StPicoFileAnalysis.h"
+
+ClassImp(StPicoFileParallelDriver)
+
+// _________________________________________________________
+StPicoFileParallelDriver::StPicoFileParallelDriver(StPicoFileAnalysis const* analysis, char const* inputFilesList,
+						   char const* outFileName) : TObject(),
+  mAnalysis(analysis), mInputFileList(inputFilesList), mOutFileName(outFileName) {
+}
+
+// _________________________________________________________
+bool StPicoFileParallelDriver::readFileList() {
+  mFiles.clear();
+
+  std::ifstream listOfFiles(mInputFileList.Data());
+  if (!listOfFiles.is_open()) {
+    Error("StPicoFileParallelDriver", "could not open list of files %s", mInputFileList.Data());
+    return false;
+  }
+
+  std::string file;
+  while (getline(listOfFiles, file))
+    if (!file.empty())
+      mFiles.push_back(file.c_str());
+
+  return true;
+}
+
+// _________________________________________________________
+int StPicoFileParallelDriver::run(int nThreads) {
+  if (!mAnalysis) {
+    Error("StPicoFileParallelDriver", "no analysis");
+    return -1;
+  }
+
+  if (!readFileList() || mFiles.empty())
+    return -1;
+
+  int const nFiles = mFiles.size();
+  if (nThreads < 1)
+    nThreads = 1;
+  if (nThreads > nFiles)
+    nThreads = nFiles;
+
+  // -- protects the ROOT globals used when the workers open files and read trees,
+  //    before ROOT 6.4 opening and reading files on several threads is not safe
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+  if (nThreads > 1)
+    ROOT::EnableThreadSafety();
+#else
+  if (nThreads > 1) {
+    Warning("StPicoFileParallelDriver", "files can only be read on several threads with ROOT >= 6.4, running on 1 thread");
+    nThreads = 1;
+  }
+#endif
+
+  // -- the clones are created and booked on this thread, ROOT object creation is not thread safe
+  std::vector<StPicoFileAnalysis*> workers;
+  for (int ii = 0; ii < nThreads; ++ii) {
+    StPicoFileAnalysis* worker = mAnalysis->clone();
+    worker->init();
+    workers.push_back(worker);
+  }
+
+  std::vector<char> good(nFiles, 0);
+  std::atomic<int> next(0);
+  std::mutex logMutex;
+
+  TStopwatch timer;
+  timer.Start();
+
+  // -- every worker takes the next file
+  auto work = [&](StPicoFileAnalysis* worker) {
+    for (int iFile = next++; iFile < nFiles; iFile = next++) {
+      good[iFile] = worker->processFile(mFiles[iFile].Data());
+
+      std::lock_guard<std::mutex> lock(logMutex);
+      if (!good[iFile])
+	Error("StPicoFileParallelDriver", "%s - failed to process %s", worker->name(), mFiles[iFile].Data());
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int ii = 1; ii < nThreads; ++ii)
+    threads.push_back(std::thread(work, workers[ii]));
+  work(workers[0]);
+  for (unsigned int ii = 0; ii < threads.size(); ++ii)
+    threads[ii].join();
+
+  timer.Stop();
+
+  int nFailed = 0;
+  for (int iFile = 0; iFile < nFiles; ++iFile)
+    nFailed += !good[iFile];
+
+  Long64_t nEvents = 0;
+  for (int ii = 0; ii < nThreads; ++ii)
+    nEvents += workers[ii]->nEvents();
+
+  Info("StPicoFileParallelDriver", "%s - %d threads, %d files (%d failed), %lld events in %.1f s, %.1f events/s",
+       mAnalysis->name(), nThreads, nFiles, nFailed, nEvents, timer.RealTime(),
+       timer.RealTime() > 0 ? nEvents / timer.RealTime() : 0.);
+
+  if (!writeOutput(workers))
+    nFailed = nFiles;
+
+  for (int ii = 0; ii < nThreads; ++ii)
+    delete workers[ii];
+
+  return nFailed;
+}
+
+// _________________________________________________________
+bool StPicoFileParallelDriver::writeOutput(std::vector<StPicoFileAnalysis*> const& workers) const {
+  // -- the output of the other workers is merged into the one of the first worker
+  TList* merged = workers[0]->outputList();
+  bool isGood = true;
+
+  TIter next(merged);
+  while (TObject* obj = next()) {
+    TList others;
+    for (unsigned int ii = 1; ii < workers.size(); ++ii) {
+      TObject* other = workers[ii]->outputList()->FindObject(obj->GetName());
+      if (other)
+	others.Add(other);
+    }
+
+    if (others.IsEmpty())
+      continue;
+
+    ROOT::MergeFunc_t merge = obj->IsA()->GetMerge();
+    if (!merge) {
+      Error("StPicoFileParallelDriver", "%s of class %s can not be merged", obj->GetName(), obj->ClassName());
+      isGood = false;
+      continue;
+    }
+    merge(obj, &others, NULL);
+  }
+
+  TFile outFile(mOutFileName.Data(), "RECREATE");
+  if (outFile.IsZombie()) {
+    Error("StPicoFileParallelDriver", "could not open output file %s", mOutFileName.Data());
+    return false;
+  }
+
+  outFile.cd();
+  merged->Write();
+  outFile.Close();
+
+  return isGood;
+}
@@ -0,0 +1,66 @@
+#ifndef STPICOFILEPARALLELDRIVER_H
+#define STPICOFILEPARALLELDRIVER_H
+
+/* **************************************************
+ *  File-parallel driver of candidate tree analyses
+ *
+ * **************************************************
+ *  Runs a StPicoFileAnalysis over a list of candidate
+ *  files on nThreads worker threads, without a StChain
+ *  and without picoDsts. Every worker has its own clone
+ *  of the analysis and takes the next unprocessed file,
+ *  at the end the output lists of the clones are merged
+ *  object by object (by name) and written to one file.
+ *
+ *    StPicoD0Analysis analysis(d0Cuts);
+ *    StPicoFileParallelDriver driver(&analysis, "d0.list", "out.root");
+ *    int nFailed = driver.run(8);
+ *
+ *  The candidate files have to hold the daughter track
+ *  snapshots, the cuts are shared by the workers and only
+ *  their const methods may be used.
+ *
+ *  Several threads need ROOT >= 6.4, with older versions
+ *  the files are processed on one thread.
+ *
+ * **************************************************
+ *
+ *  Initial Authors:
+ *          **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "TObject.h"
+#include "TString.h"
+
+class StPicoFileAnalysis;
+
+class StPicoFileParallelDriver : public TObject
+{
+ public:
+  // -- analysis is the prototype of the workers, it is not run itself
+  StPicoFileParallelDriver(StPicoFileAnalysis const* analysis = NULL, char const* inputFilesList = "",
+			   char const* outFileName = "");
+  virtual ~StPicoFileParallelDriver() {}
+
+  // -- returns the number of files which failed, -1 if nothing was run
+  int run(int nThreads);
+
+ private:
+  bool readFileList();
+  bool writeOutput(std::vector<StPicoFileAnalysis*> const& workers) const;
+
+  StPicoFileAnalysis const* mAnalysis; //!
+
+  TString mInputFileList;
+  TString mOutFileName;
+  std::vector<TString> mFiles;
+
+  ClassDef(StPicoFileParallelDriver, 0)
+};
+#endif
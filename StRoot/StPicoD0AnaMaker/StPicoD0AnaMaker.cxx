@@ -1,19 +1,15 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <cmath>
 
 #include "TFile.h"
-#include "TClonesArray.h"
-#include "TTree.h"
-#include "TNtuple.h"
+#include "TList.h"
 
 #include "StPicoDstMaker/StPicoDstMaker.h"
 #include "StPicoDstMaker/StPicoDst.h"
 #include "StPicoDstMaker/StPicoEvent.h"
-#include "StPicoDstMaker/StPicoTrack.h"
 #include "StPicoCharmContainers/StPicoD0Event.h"
-#include "StPicoCharmContainers/StKaonPion.h"
+#include "StPicoD0Analysis.h"
 #include "StPicoD0AnaMaker.h"
 #include "StPicoHFMaker/StHFCuts.h"
 
@@ -22,14 +18,14 @@ ClassImp(StPicoD0AnaMaker)
 StPicoD0AnaMaker::StPicoD0AnaMaker(char const * name,char const * inputFilesList, 
     char const * outName,StPicoDstMaker* picoDstMaker): 
   StMaker(name),mPicoDstMaker(picoDstMaker),mPicoD0Event(NULL), mOutFileName(outName), mInputFileList(inputFilesList),
-  mOutputFile(NULL), mChain(NULL), mEventCounter(0), mHFCuts(NULL)
-{}
+  mOutputFile(NULL), mReader(NULL), mEventCounter(0), mHFCuts(NULL), mAnalysis(NULL)
+{
+   // reads both dense and sparse picoD0 files
+   mReader = new StPicoD0EventReader();
+}
 
 Int_t StPicoD0AnaMaker::Init()
 {
-   mPicoD0Event = new StPicoD0Event();
-
-   mChain = new TChain("T");
    std::ifstream listOfFiles(mInputFileList.Data());
    if (listOfFiles.is_open())
    {
@@ -37,7 +33,7 @@ Int_t StPicoD0AnaMaker::Init()
       while (getline(listOfFiles, file))
       {
          LOG_INFO << "StPicoD0AnaMaker - Adding :" << file << endm;
-         mChain->Add(file.c_str());
+         mReader->addFile(file.c_str());
       }
    }
    else
@@ -46,8 +42,12 @@ Int_t StPicoD0AnaMaker::Init()
       return kStErr;
    }
 
-   mChain->GetBranch("dEvent")->SetAutoDelete(kFALSE);
-   mChain->SetBranchAddress("dEvent", &mPicoD0Event);
+   if (!mReader->init())
+   {
+      LOG_ERROR << "StPicoD0AnaMaker - Could not read picoD0 files. ABORT!" << endm;
+      return kStErr;
+   }
+   mPicoD0Event = mReader->event();
 
    mOutputFile = new TFile(mOutFileName.Data(), "RECREATE");
    mOutputFile->cd();
@@ -56,21 +56,25 @@ Int_t StPicoD0AnaMaker::Init()
     mHFCuts = new StHFCuts;   
    mHFCuts->init();
 
-   // -------------- USER VARIABLES -------------------------
-   
+   mAnalysis = new StPicoD0Analysis(mHFCuts);
+   mAnalysis->init();
+
    return kStOK;
 }
 //-----------------------------------------------------------------------------
 StPicoD0AnaMaker::~StPicoD0AnaMaker()
 {
-   /*  */
+   delete mAnalysis;
+   delete mReader;
 }
 //-----------------------------------------------------------------------------
 Int_t StPicoD0AnaMaker::Finish()
 {
+   mReader->printStats();
+
    LOG_INFO << " StPicoD0AnaMaker - writing data and closing output file " <<endm;
    mOutputFile->cd();
-   // save user variables here
+   mAnalysis->outputList()->Write();
 
    mOutputFile->Close();
 
@@ -81,66 +85,31 @@ Int_t StPicoD0AnaMaker::Make()
 {
    readNextEvent();
 
-   if (!mPicoDstMaker)
-   {
-      LOG_WARN << " StPicoD0AnaMaker - No PicoDstMaker! Skip! " << endm;
-      return kStWarn;
-   }
-
-   StPicoDst const* picoDst = mPicoDstMaker->picoDst();
+   // without a picoDst the daughter tracks are read from the StPicoDaughterTrack
+   // snapshots of the picoD0 files, see StPicoCharmMaker::storeDaughterTracks()
+   StPicoDst const* picoDst = mPicoDstMaker ? mPicoDstMaker->picoDst() : NULL;
 
-   if (!picoDst)
+   if (mPicoDstMaker && !picoDst)
    {
       LOG_WARN << "StPicoD0AnaMaker - No PicoDst! Skip! " << endm;
       return kStWarn;
    }
 
-   if(mPicoD0Event->runId() != picoDst->event()->runId() ||
-       mPicoD0Event->eventId() != picoDst->event()->eventId())
+   if(picoDst && (mPicoD0Event->runId() != picoDst->event()->runId() ||
+       mPicoD0Event->eventId() != picoDst->event()->eventId()))
    {
      LOG_ERROR <<" StPicoD0AnaMaker - !!!!!!!!!!!! ATTENTION !!!!!!!!!!!!!"<<endm;
      LOG_ERROR <<" StPicoD0AnaMaker - SOMETHING TERRIBLE JUST HAPPENED. StPicoEvent and StPicoD0Event are not in sync."<<endm;
      exit(1);
    }
 
-   // -------------- USER ANALYSIS -------------------------
-   
-   // check if good event (including bad run)
-   if(!mHFCuts->isGoodEvent(const_cast<const StPicoDst*>(picoDst), NULL)) 
-     return kStOk;
-
-   TClonesArray const * aKaonPion = mPicoD0Event->kaonPionArray();
-
-   for (int idx = 0; idx < aKaonPion->GetEntries(); ++idx)
+   if(!picoDst && mPicoD0Event->nKaonPion() > 0 && mPicoD0Event->nDaughterTracks() == 0)
    {
-      // this is an example of how to get the kaonPion pairs and their corresponsing tracks
-      StKaonPion const* kp = (StKaonPion*)aKaonPion->At(idx);
-      if(!isGoodPair(kp)) continue;
-
-      StPicoTrack const* kaon = picoDst->track(kp->kaonIdx());
-      StPicoTrack const* pion = picoDst->track(kp->pionIdx());
-
+     LOG_ERROR << "StPicoD0AnaMaker - No PicoDstMaker and no daughter tracks in the picoD0 file. ABORT!" << endm;
+     return kStFatal;
    }
 
+   mAnalysis->analyze(mPicoD0Event, picoDst);
+
    return kStOK;
 }
-//-----------------------------------------------------------------------------
-bool StPicoD0AnaMaker::isGoodPair(StKaonPion const* const kp) const
-{
-  if(!kp) return false;
-
-  StPicoTrack const* kaon = mPicoDstMaker->picoDst()->track(kp->kaonIdx());
-  StPicoTrack const* pion = mPicoDstMaker->picoDst()->track(kp->pionIdx());
-
-  //  To be replaced by mHFCuts->isGoodSecondaryVertexPair(kp))
-  bool pairCuts = kp->m() > mHFCuts->cutSecondaryPairMassMin() && 
-    kp->m() < mHFCuts->cutSecondaryPairMassMax() &&
-    std::cos(kp->pointingAngle()) > mHFCuts->cutSecondaryPairCosThetaMin() &&
-    kp->decayLength()  > mHFCuts->cutSecondaryPairDecayLengthMin() && 
-    kp->decayLength()  < mHFCuts->cutSecondaryPairDecayLengthMax() &&
-    kp->dcaDaughters() < mHFCuts->cutSecondaryPairDcaDaughtersMax();
-
-  return (mHFCuts->isGoodTrack(kaon) && mHFCuts->isGoodTrack(pion) &&
-	  mHFCuts->isTPCKaon(kaon) && mHFCuts->isTPCPion(pion) && 
-	  pairCuts);
-}
@@ -5,7 +5,17 @@
  *  A Maker to read a StPicoEvent and StPicoD0Event
  *  simultaneously and do analysis. 
  *
- *  Please write your analysis in the ::Make() function.
+ *  Please write your analysis in StPicoD0Analysis::analyze(),
+ *  it is run event by event by this maker, or file by file
+ *  on worker threads by StPicoFileParallelDriver, see
+ *  runPicoD0AnaParallel.C.
+ *
+ *  picoDstMaker can be NULL for picoD0 files with daughter
+ *  track snapshots (StPicoCharmMaker::storeDaughterTracks),
+ *  the kaons and pions are then StPicoDaughterTracks.
+ *
+ *  The TTreeCache and the branches read from the picoD0
+ *  files are set up with chainReader() before Init().
  *
  *  Authors:  **Mustafa Mustafa (mmustafa@lbl.gov)
  *
@@ -14,16 +24,17 @@
  * **************************************************
  */
 
-#include "TChain.h"
 #include "StMaker.h"
+#include "StPicoCharmContainers/StPicoD0EventReader.h"
 
 class TString;
 class TFile;
 class TNtuple;
 class StPicoD0Event;
-class StKaonPion;
+class StPicoD0Analysis;
 class StPicoDstMaker;
 class StHFCuts;
+class StPicoChainReader;
 
 
 class StPicoD0AnaMaker : public StMaker
@@ -40,39 +51,40 @@ class StPicoD0AnaMaker : public StMaker
     int getEntries() const;
 
     void setHFCuts(StHFCuts* cuts);    
+    StPicoChainReader* chainReader() const;
 
   private:
     StPicoD0AnaMaker() {}
     void readNextEvent();
 
-    bool isGoodPair(StKaonPion const*) const;
-
     StPicoDstMaker* mPicoDstMaker;
-    StPicoD0Event* mPicoD0Event;
+    StPicoD0Event const* mPicoD0Event;
 
     TString mOutFileName;
     TString mInputFileList;
     TFile* mOutputFile;
-    TChain* mChain;
+    StPicoD0EventReader* mReader;
     int mEventCounter;
 
     StHFCuts* mHFCuts;
-
-    // -------------- USER variables -------------------------
-    // add your member variables here. 
-    // Remember that ntuples size can be really big, use histograms where appropriate
+    StPicoD0Analysis* mAnalysis;
 
     ClassDef(StPicoD0AnaMaker, 0)
 };
 
 inline int StPicoD0AnaMaker::getEntries() const 
 {
-  return mChain? mChain->GetEntries() : 0;
+  return mReader? mReader->getEntries() : 0;
+}
+
+inline StPicoChainReader* StPicoD0AnaMaker::chainReader() const
+{
+  return mReader->chainReader();
 }
 
 inline void StPicoD0AnaMaker::readNextEvent()
 {
-  mChain->GetEntry(mEventCounter++);
+  mReader->readEvent(mEventCounter++);
 }
 
 inline void StPicoD0AnaMaker::setHFCuts(StHFCuts* cuts)   
@@ -0,0 +1,155 @@
+#include <cmath>
+
+#include "TList.h"
+#include "TClonesArray.h"
+
+#include "StPicoDstMaker/StPicoDst.h"
+#include "StPicoDstMaker/StPicoEvent.h"
+#include "StPicoDstMaker/StPicoTrack.h"
+#include "StPicoCharmContainers/StPicoD0Event.h"
+#include "StPicoCharmContainers/StPicoD0EventReader.h"
+#include "StPicoCharmContainers/StKaonPion.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
+#include "StPicoCutsBase/StPicoChainReader.h"
+#include "StPicoHFMaker/StHFCuts.h"
+#include "StPicoD0Analysis.h"
+
+ClassImp(StPicoD0Analysis)
+
+//-----------------------------------------------------------------------------
+StPicoD0Analysis::StPicoD0Analysis(StHFCuts* cuts, char const* name) : StPicoFileAnalysis(name),
+  mHFCuts(cuts)
+{}
+//-----------------------------------------------------------------------------
+StPicoFileAnalysis* StPicoD0Analysis::clone() const
+{
+   StPicoD0Analysis* analysis = new StPicoD0Analysis(mHFCuts, mName.Data());
+   analysis->copyConfiguration(*this);
+
+   // -------------- USER configuration -------------------------
+
+   return analysis;
+}
+//-----------------------------------------------------------------------------
+void StPicoD0Analysis::initAnalysis()
+{
+   // -------------- USER VARIABLES -------------------------
+   // e.g. mOutList->Add(new TH1F(...));
+}
+//-----------------------------------------------------------------------------
+bool StPicoD0Analysis::processFile(char const* fileName)
+{
+   // one file per reader, there is no next file to prefetch
+   StPicoD0EventReader reader;
+   reader.chainReader()->copySettings(*mChainReader);
+   reader.chainReader()->setPrefetchNextFile(false);
+   reader.addFile(fileName);
+   if (!reader.init()) return false;
+
+   for (Long64_t iEvent = 0; iEvent < reader.getEntries(); ++iEvent)
+   {
+      if (!reader.readEvent(iEvent))
+      {
+         Error("StPicoD0Analysis::processFile", "could not read event %lld of %s", iEvent, fileName);
+         return false;
+      }
+
+      StPicoD0Event const* picoD0Event = reader.event();
+      if (picoD0Event->nKaonPion() > 0 && picoD0Event->nDaughterTracks() == 0)
+      {
+         Error("StPicoD0Analysis::processFile", "no daughter tracks in %s, it needs the picoDst", fileName);
+         return false;
+      }
+
+      if (!picoD0Event->hasEventSelection())
+      {
+         Error("StPicoD0Analysis::processFile", "no event selection in %s, it needs the picoDst", fileName);
+         return false;
+      }
+
+      analyze(picoD0Event, NULL);
+   }
+
+   return true;
+}
+//-----------------------------------------------------------------------------
+void StPicoD0Analysis::analyze(StPicoD0Event const* picoD0Event, StPicoDst const* picoDst)
+{
+   // check if good event (including bad run)
+   // without picoDst the trigger selection is the one of the picoD0 production
+   if(picoDst ? !mHFCuts->isGoodEvent(picoDst, NULL) :
+      !mHFCuts->isGoodEvent(picoD0Event->runId(), picoD0Event->isGoodTrigger(), picoD0Event->vz(), picoD0Event->vzVpd()))
+     return;
+
+   ++mNEvents;
+
+   // -------------- USER ANALYSIS -------------------------
+
+   TClonesArray const * aKaonPion = picoD0Event->kaonPionArray();
+
+   for (int idx = 0; idx < aKaonPion->GetEntries(); ++idx)
+   {
+      // this is an example of how to get the kaonPion pairs and their corresponsing tracks
+      StKaonPion const* kp = (StKaonPion*)aKaonPion->At(idx);
+      if(!isGoodPair(picoD0Event, picoDst, kp)) continue;
+
+      // the daughters have the same accessors with and without picoDst, e.g. kaon.gPt(), pion.nSigmaPion()
+      StPicoDaughterTrack kaon;
+      StPicoDaughterTrack pion;
+      if(!daughterTrack(picoD0Event, picoDst, kp->kaonIdx(), kaon) || !daughterTrack(picoD0Event, picoDst, kp->pionIdx(), pion))
+        continue;
+   }
+}
+//-----------------------------------------------------------------------------
+bool StPicoD0Analysis::daughterTrack(StPicoD0Event const* picoD0Event, StPicoDst const* picoDst,
+                                     unsigned short const idx, StPicoDaughterTrack& daughter) const
+{
+  if(picoD0Event->nDaughterTracks())
+  {
+    StPicoDaughterTrack const* stored = picoD0Event->daughterTrack(idx);
+    if(!stored) return false;
+
+    daughter = *stored;
+    return true;
+  }
+
+  StPicoTrack const* trk = picoDst->track(idx);
+  if(!trk) return false;
+
+  StPicoBTofPidTraits const* tofPid = trk->bTofPidTraitsIndex() >= 0 ? picoDst->btofPidTraits(trk->bTofPidTraitsIndex()) : NULL;
+
+  StPicoEvent const* picoEvent = picoDst->event();
+  daughter = StPicoDaughterTrack(*trk, idx, picoEvent->primaryVertex(), picoEvent->bField(), tofPid);
+  return true;
+}
+//-----------------------------------------------------------------------------
+bool StPicoD0Analysis::isGoodPair(StPicoD0Event const* picoD0Event, StPicoDst const* picoDst, StKaonPion const* const kp) const
+{
+  if(!kp) return false;
+
+  //  To be replaced by mHFCuts->isGoodSecondaryVertexPair(kp))
+  bool pairCuts = kp->m() > mHFCuts->cutSecondaryPairMassMin() &&
+    kp->m() < mHFCuts->cutSecondaryPairMassMax() &&
+    std::cos(kp->pointingAngle()) > mHFCuts->cutSecondaryPairCosThetaMin() &&
+    kp->decayLength()  > mHFCuts->cutSecondaryPairDecayLengthMin() &&
+    kp->decayLength()  < mHFCuts->cutSecondaryPairDecayLengthMax() &&
+    kp->dcaDaughters() < mHFCuts->cutSecondaryPairDcaDaughtersMax();
+
+  if(picoD0Event->nDaughterTracks())
+  {
+    StPicoDaughterTrack const* kaon = picoD0Event->daughterTrack(kp->kaonIdx());
+    StPicoDaughterTrack const* pion = picoD0Event->daughterTrack(kp->pionIdx());
+
+    return (kaon && pion &&
+	    mHFCuts->isGoodTrack(kaon) && mHFCuts->isGoodTrack(pion) &&
+	    mHFCuts->isTPCKaon(kaon) && mHFCuts->isTPCPion(pion) &&
+	    pairCuts);
+  }
+
+  StPicoTrack const* kaon = picoDst->track(kp->kaonIdx());
+  StPicoTrack const* pion = picoDst->track(kp->pionIdx());
+
+  return (mHFCuts->isGoodTrack(kaon) && mHFCuts->isGoodTrack(pion) &&
+	  mHFCuts->isTPCKaon(kaon) && mHFCuts->isTPCPion(pion) &&
+	  pairCuts);
+}
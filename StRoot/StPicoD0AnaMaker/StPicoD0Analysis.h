@@ -0,0 +1,63 @@
+#ifndef StPicoD0Analysis_h
+#define StPicoD0Analysis_h
+
+/* **************************************************
+ *  Analysis of StPicoD0Events, run event by event by
+ *  StPicoD0AnaMaker or file by file on worker threads by
+ *  StPicoFileParallelDriver.
+ *
+ *  Please write your analysis in the ::analyze() function
+ *  and book your histograms in ::initAnalysis(), in
+ *  mOutList. Members added here are per worker, copy your
+ *  configuration in ::clone().
+ *
+ *  picoDst is NULL in ::analyze() for picoD0 files with
+ *  daughter track snapshots, which are the only ones
+ *  ::processFile() can read.
+ *
+ *  Authors:  **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include "StPicoCutsBase/StPicoFileAnalysis.h"
+
+class StPicoDst;
+class StPicoD0Event;
+class StKaonPion;
+class StPicoDaughterTrack;
+class StHFCuts;
+
+class StPicoD0Analysis : public StPicoFileAnalysis
+{
+  public:
+    // -- cuts are not owned, they are shared by the clones
+    StPicoD0Analysis(StHFCuts* cuts = NULL, char const* name = "picoD0Analysis");
+    virtual ~StPicoD0Analysis() {}
+
+    virtual StPicoFileAnalysis* clone() const;
+    virtual bool processFile(char const* fileName);
+
+    // -- one event, picoDst can be NULL
+    void analyze(StPicoD0Event const* picoD0Event, StPicoDst const* picoDst);
+
+  protected:
+    virtual void initAnalysis();
+
+  private:
+    bool isGoodPair(StPicoD0Event const*, StPicoDst const*, StKaonPion const*) const;
+
+    // -- daughter idx from the picoD0 snapshots, or built from the picoDst track if there are none
+    bool daughterTrack(StPicoD0Event const*, StPicoDst const*, unsigned short idx, StPicoDaughterTrack& daughter) const;
+
+    StHFCuts* mHFCuts;
+
+    // -------------- USER variables -------------------------
+    // add your member variables here.
+    // Remember that ntuples size can be really big, use histograms where appropriate
+
+    ClassDef(StPicoD0Analysis, 0)
+};
+#endif
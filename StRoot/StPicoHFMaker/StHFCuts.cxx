@@ -14,7 +14,8 @@ StHFCuts::StHFCuts() : StPicoCutsBase("HFCutsBase"),
   mSecondaryPairDecayLengthMin(std::numeric_limits<float>::lowest()), mSecondaryPairDecayLengthMax(std::numeric_limits<float>::max()), 
   mSecondaryPairCosThetaMin(std::numeric_limits<float>::lowest()), 
   mSecondaryPairMassMin(std::numeric_limits<float>::lowest()), mSecondaryPairMassMax(std::numeric_limits<float>::max()), 
-  mSecondaryPairDcaToPvMax(std::numeric_limits<float>::max()),
+  mSecondaryPairDcaToPvMax(std::numeric_limits<float>::max()), mSecondaryPairMassPreCheckMargin(0.05),
+  mSecondaryPairPtMin(std::numeric_limits<float>::lowest()),
 
   mTertiaryPairDcaDaughtersMax(std::numeric_limits<float>::max()), 
   mTertiaryPairDecayLengthMin(std::numeric_limits<float>::lowest()), mTertiaryPairDecayLengthMax(std::numeric_limits<float>::max()), 
@@ -28,7 +29,9 @@ StHFCuts::StHFCuts() : StPicoCutsBase("HFCutsBase"),
   mSecondaryTripletCosThetaMin(std::numeric_limits<float>::lowest()), 
   mSecondaryTripletMassMin(std::numeric_limits<float>::lowest()), mSecondaryTripletMassMax(std::numeric_limits<float>::max()),
   mSecondaryTripletDcaToPvMax(std::numeric_limits<float>::max()),
-  mSecondaryTripletPtMin(std::numeric_limits<float>::lowest()) {
+  mSecondaryTripletPtMin(std::numeric_limits<float>::lowest()),
+
+  mSecondaryPairLikeSign(true), mTertiaryPairLikeSign(true) {
   // -- default constructor
 }
 
@@ -38,7 +41,8 @@ StHFCuts::StHFCuts(const Char_t *name) : StPicoCutsBase(name),
   mSecondaryPairDecayLengthMin(std::numeric_limits<float>::lowest()), mSecondaryPairDecayLengthMax(std::numeric_limits<float>::max()), 
   mSecondaryPairCosThetaMin(std::numeric_limits<float>::lowest()), 
   mSecondaryPairMassMin(std::numeric_limits<float>::lowest()), mSecondaryPairMassMax(std::numeric_limits<float>::max()), 
-  mSecondaryPairDcaToPvMax(std::numeric_limits<float>::max()),
+  mSecondaryPairDcaToPvMax(std::numeric_limits<float>::max()), mSecondaryPairMassPreCheckMargin(0.05),
+  mSecondaryPairPtMin(std::numeric_limits<float>::lowest()),
 
   mTertiaryPairDcaDaughtersMax(std::numeric_limits<float>::max()), 
   mTertiaryPairDecayLengthMin(std::numeric_limits<float>::lowest()), mTertiaryPairDecayLengthMax(std::numeric_limits<float>::max()), 
@@ -52,7 +56,9 @@ StHFCuts::StHFCuts(const Char_t *name) : StPicoCutsBase(name),
   mSecondaryTripletCosThetaMin(std::numeric_limits<float>::lowest()), 
   mSecondaryTripletMassMin(std::numeric_limits<float>::lowest()), mSecondaryTripletMassMax(std::numeric_limits<float>::max()),
   mSecondaryTripletDcaToPvMax(std::numeric_limits<float>::max()),
-  mSecondaryTripletPtMin(std::numeric_limits<float>::lowest()) {
+  mSecondaryTripletPtMin(std::numeric_limits<float>::lowest()),
+
+  mSecondaryPairLikeSign(true), mTertiaryPairLikeSign(true) {
   // -- constructor
 }
 
@@ -87,7 +93,8 @@ bool StHFCuts::isGoodSecondaryVertexPair(StHFPair const & pair) const {
 	   std::cos(pair.pointingAngle()) > mSecondaryPairCosThetaMin &&
 	   pair.decayLength() > mSecondaryPairDecayLengthMin && pair.decayLength() < mSecondaryPairDecayLengthMax &&
 	   pair.dcaDaughters() < mSecondaryPairDcaDaughtersMax &&
-	   pair.DcaToPrimaryVertex() < mSecondaryPairDcaToPvMax);
+	   pair.DcaToPrimaryVertex() < mSecondaryPairDcaToPvMax &&
+	   pair.pt() > mSecondaryPairPtMin);
 }
 
 // _________________________________________________________
@@ -101,6 +108,13 @@ bool StHFCuts::isGoodTertiaryVertexPair(StHFPair const & pair) const {
 	   pair.DcaToPrimaryVertex() < mTertiaryPairDcaToPvMax);
 }
 
+// _________________________________________________________
+bool StHFCuts::isSecondaryPairMassPreCheck(float const massAtPrimaryVertex) const {
+  // -- loose mass window for pairs before the full topology is calculated
+  return ( massAtPrimaryVertex > mSecondaryPairMassMin - mSecondaryPairMassPreCheckMargin &&
+	   massAtPrimaryVertex < mSecondaryPairMassMax + mSecondaryPairMassPreCheckMargin );
+}
+
 // _________________________________________________________
 bool StHFCuts::isGoodSecondaryVertexTriplet(StHFTriplet const & triplet) const {
   // -- check for good secondary vertex triplet
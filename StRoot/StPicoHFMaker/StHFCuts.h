@@ -48,6 +48,10 @@ class StHFCuts : public StPicoCutsBase
   bool isGoodTertiaryVertexPair(StHFPair const & pair) const;
   bool isGoodSecondaryVertexTriplet(StHFTriplet const & triplet) const;
 
+  // -- pre-check of the pair mass from momenta at the primary vertex (StHFPair::massAtPrimaryVertex)
+  //    against the secondary pair mass window widened by the pre-check margin
+  bool isSecondaryPairMassPreCheck(float massAtPrimaryVertex) const;
+
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
   // -- SETTER for CUTS
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- 
@@ -64,12 +68,20 @@ class StHFCuts : public StPicoCutsBase
 
   void setCutSecondaryPairDcaToPvMax(float dcaToPvMax){ mSecondaryPairDcaToPvMax = dcaToPvMax; }
 
+  void setCutSecondaryPairPtMin(float ptMin) { mSecondaryPairPtMin = ptMin; }
+
   void setCutTertiaryPairDcaToPvMax(float dcaToPvMax) { mTertiaryPairDcaToPvMax = dcaToPvMax; }
 
   void setCutSecondaryTripletDcaToPvMax(float dcaToPvMax) { mSecondaryTripletDcaToPvMax = dcaToPvMax; }
 
   void setCutSecondaryTripletPtMin(float ptMin) { mSecondaryTripletPtMin = ptMin; }
 
+  void setCutSecondaryPairMassPreCheckMargin(float margin) { mSecondaryPairMassPreCheckMargin = margin; }
+
+  // -- like-sign combinations (background) are built unless switched off
+  void setSecondaryPairLikeSign(bool b) { mSecondaryPairLikeSign = b; }
+  void setTertiaryPairLikeSign(bool b)  { mTertiaryPairLikeSign = b; }
+
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- --   
   // -- GETTER for single CUTS
   // -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- -- 
@@ -81,6 +93,8 @@ class StHFCuts : public StPicoCutsBase
   const float&    cutSecondaryPairMassMin()               const;
   const float&    cutSecondaryPairMassMax()               const;
   const float&    cutSecondaryPairDcaToPvMax()		  const;
+  const float&    cutSecondaryPairMassPreCheckMargin()    const;
+  const float&    cutSecondaryPairPtMin()                 const;
 
   const float&    cutTertiaryPairDcaDaughtersMax()        const;
   const float&    cutTertiaryPairDecayLengthMin()         const;
@@ -101,6 +115,9 @@ class StHFCuts : public StPicoCutsBase
   const float&    cutSecondaryTripletDcaToPvMax()         const;
   const float&    cutSecondaryTripletPtMin()	          const;
 
+  bool            secondaryPairLikeSign()                 const;
+  bool            tertiaryPairLikeSign()                  const;
+
  private:
   
   StHFCuts(StHFCuts const &);       
@@ -116,6 +133,8 @@ class StHFCuts : public StPicoCutsBase
   float mSecondaryPairMassMin;
   float mSecondaryPairMassMax;
   float mSecondaryPairDcaToPvMax;
+  float mSecondaryPairMassPreCheckMargin;
+  float mSecondaryPairPtMin;
 
   // ------------------------------------------
   // -- Pair cuts tertiary pair
@@ -142,7 +161,13 @@ class StHFCuts : public StPicoCutsBase
   float mSecondaryTripletDcaToPvMax;
   float mSecondaryTripletPtMin;
 
-  ClassDef(StHFCuts,1)
+  // ------------------------------------------
+  // -- Charge combinations
+  // ------------------------------------------
+  bool  mSecondaryPairLikeSign;
+  bool  mTertiaryPairLikeSign;
+
+  ClassDef(StHFCuts,4)
 };
 
 inline void StHFCuts::setCutSecondaryPair(float dcaDaughtersMax, float decayLengthMin, float decayLengthMax, 
@@ -182,6 +207,8 @@ inline const float&    StHFCuts::cutSecondaryPairCosThetaMin()           const {
 inline const float&    StHFCuts::cutSecondaryPairMassMin()               const { return mSecondaryPairMassMin; }
 inline const float&    StHFCuts::cutSecondaryPairMassMax()               const { return mSecondaryPairMassMax; }
 inline const float&    StHFCuts::cutSecondaryPairDcaToPvMax()            const { return mSecondaryPairDcaToPvMax; }
+inline const float&    StHFCuts::cutSecondaryPairMassPreCheckMargin()    const { return mSecondaryPairMassPreCheckMargin; }
+inline const float&    StHFCuts::cutSecondaryPairPtMin()                 const { return mSecondaryPairPtMin; }
 
 inline const float&    StHFCuts::cutTertiaryPairDcaDaughtersMax()        const { return mTertiaryPairDcaDaughtersMax; }
 inline const float&    StHFCuts::cutTertiaryPairDecayLengthMin()         const { return mTertiaryPairDecayLengthMin; }
@@ -201,4 +228,7 @@ inline const float&    StHFCuts::cutSecondaryTripletMassMin()            const {
 inline const float&    StHFCuts::cutSecondaryTripletMassMax()            const { return mSecondaryTripletMassMax; }
 inline const float&    StHFCuts::cutSecondaryTripletDcaToPvMax()         const { return mSecondaryTripletDcaToPvMax; }
 inline const float&    StHFCuts::cutSecondaryTripletPtMin()         const { return mSecondaryTripletPtMin; }
+
+inline bool            StHFCuts::secondaryPairLikeSign()                 const { return mSecondaryPairLikeSign; }
+inline bool            StHFCuts::tertiaryPairLikeSign()                  const { return mTertiaryPairLikeSign; }
 #endif
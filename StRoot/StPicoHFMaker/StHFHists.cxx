@@ -28,9 +28,7 @@ StHFHists::StHFHists(const char* name) : TNamed(name, name),
 StHFHists::~StHFHists()
 {
 
-  if (mPrescales)
-    delete mPrescales;
-  mPrescales = NULL;
+  // mPrescales is shared and owned by StPicoPrescales
   // note that histograms are owned by mOutFile. They will be destructed 
   // when the file is closed.
 }
@@ -42,7 +40,7 @@ void StHFHists::init (TList * outList, unsigned int mode){
   // path to lists of triggers prescales
   // lists are obtained from http://www.star.bnl.gov/protected/common/common2014/trigger2014/plots_au200gev/
   const char * prescalesFilesDirectoryName = "./run14AuAu200GeVPrescales";
-  mPrescales = new StPicoPrescales(prescalesFilesDirectoryName); // fix dir name
+  mPrescales = StPicoPrescales::instance(prescalesFilesDirectoryName); // fix dir name
   mNRuns = mPrescales->numberOfRuns();
    
 
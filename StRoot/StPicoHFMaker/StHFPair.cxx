@@ -203,4 +203,13 @@ float StHFPair::particle2Dca(StPicoTrack const * p2track, StThreeVectorF const &
   return nParticle2Dca;
 }
 
-
+// _________________________________________________________
+float StHFPair::massAtPrimaryVertex(StThreeVectorF const & p1Mom, StThreeVectorF const & p2Mom,
+				    float const p1MassHypo, float const p2MassHypo) {
+  // -- m^2 = m1^2 + m2^2 + 2 (E1 E2 - p1.p2)
+  float const e1 = std::sqrt(p1Mom.mag2() + p1MassHypo*p1MassHypo);
+  float const e2 = std::sqrt(p2Mom.mag2() + p2MassHypo*p2MassHypo);
+  float const m2 = p1MassHypo*p1MassHypo + p2MassHypo*p2MassHypo + 2.*(e1*e2 - p1Mom.dot(p2Mom));
+
+  return (m2 > 0.) ? std::sqrt(m2) : 0.;
+}
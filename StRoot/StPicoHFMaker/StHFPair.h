@@ -79,6 +79,11 @@ class StHFPair : public TObject
   float pz() const;
   float DcaToPrimaryVertex() const;
 
+  // -- invariant mass from momenta at the primary vertex, cheap estimate of m()
+  //    used to reject combinations before the full topology is calculated
+  static float massAtPrimaryVertex(StThreeVectorF const & p1Mom, StThreeVectorF const & p2Mom,
+				   float p1MassHypo, float p2MassHypo);
+
  private:
   StHFPair(StHFPair const &);
   StHFPair& operator=(StHFPair const &);
@@ -1,4 +1,5 @@
 #include "StPicoDstMaker/StPicoEvent.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
 
 #include "StPicoHFEvent.h"
 #include "StHFPair.h"
@@ -9,18 +10,22 @@ ClassImp(StPicoHFEvent)
 
 TClonesArray *StPicoHFEvent::fgHFSecondaryVerticesArray = 0;
 TClonesArray *StPicoHFEvent::fgHFTertiaryVerticesArray  = 0;
+TClonesArray *StPicoHFEvent::fgDaughterTracksArray      = 0;
 
 // _________________________________________________________
-StPicoHFEvent::StPicoHFEvent() : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0),
-						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL) {
+StPicoHFEvent::StPicoHFEvent() : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0), mNDaughterTracks(0),
+						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL), mDaughterTracksArray(NULL) {
   // -- Default constructor
   if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFPair");
   mHFSecondaryVerticesArray = fgHFSecondaryVerticesArray;
+
+  if (!fgDaughterTracksArray) fgDaughterTracksArray = new TClonesArray("StPicoDaughterTrack");
+  mDaughterTracksArray = fgDaughterTracksArray;
 }
 
 // _________________________________________________________
-StPicoHFEvent::StPicoHFEvent(unsigned int mode) : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0),
-						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL) {
+StPicoHFEvent::StPicoHFEvent(unsigned int mode) : mRunId(-1), mEventId(-1), mNHFSecondaryVertices(0), mNHFTertiaryVertices(0), mNDaughterTracks(0),
+						  mHFSecondaryVerticesArray(NULL), mHFTertiaryVerticesArray(NULL), mDaughterTracksArray(NULL) {
   // -- Constructor with mode selection
   if (mode == StPicoHFEvent::kTwoAndTwoParticleDecay) {
     if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFPair");
@@ -45,6 +50,9 @@ StPicoHFEvent::StPicoHFEvent(unsigned int mode) : mRunId(-1), mEventId(-1), mNHF
     if (!fgHFSecondaryVerticesArray) fgHFSecondaryVerticesArray = new TClonesArray("StHFPair");
     mHFSecondaryVerticesArray = fgHFSecondaryVerticesArray;
   }
+
+  if (!fgDaughterTracksArray) fgDaughterTracksArray = new TClonesArray("StPicoDaughterTrack");
+  mDaughterTracksArray = fgDaughterTracksArray;
 }
 
 // _________________________________________________________
@@ -59,11 +67,13 @@ void StPicoHFEvent::clear(char const *option) {
   mHFSecondaryVerticesArray->Clear(option);
   if (mHFTertiaryVerticesArray)
     mHFTertiaryVerticesArray->Clear(option);
+  mDaughterTracksArray->Clear(option);
   
   mRunId                = -1;
   mEventId              = -1;
   mNHFSecondaryVertices = 0;
   mNHFTertiaryVertices  = 0;
+  mNDaughterTracks      = 0;
 }
 
 // _________________________________________________________
@@ -88,3 +98,14 @@ void StPicoHFEvent::addHFSecondaryVertexQuadruplet(StHFQuadruplet const* t) {
   TClonesArray &vertexArray = *mHFTertiaryVerticesArray;
   new(vertexArray[mNHFTertiaryVertices++]) StHFQuadruplet(t);
 }
+
+// _________________________________________________________
+void StPicoHFEvent::addDaughterTrack(StPicoDaughterTrack const& t) {
+  TClonesArray &daughterArray = *mDaughterTracksArray;
+  new(daughterArray[mNDaughterTracks++]) StPicoDaughterTrack(t);
+}
+
+// _________________________________________________________
+StPicoDaughterTrack const * StPicoHFEvent::daughterTrack(unsigned short idx) const {
+  return StPicoDaughterTrack::find(mDaughterTracksArray, mNDaughterTracks, idx);
+}
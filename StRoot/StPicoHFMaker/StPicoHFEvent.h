@@ -9,6 +9,9 @@
  *   - StPicoHFEvent::kTwoAndTwoParticleDecay ->  two particle decay at secondary vertex (A -> B + C)
  *                                                and two particle decay at tertiary vertex (C -> D + E)
  *
+ *  Optionally holds a StPicoDaughterTrack snapshot of every track used by the
+ *  candidates, found by daughterTrack(particleXIdx()).
+ *
  *  Initial Authors:
  *            Xin Dong        (xdong@lbl.gov)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
@@ -27,6 +30,7 @@ class StPicoEvent;
 class StHFPair;
 class StHFTriplet;
 class StHFQuadruplet;
+class StPicoDaughterTrack;
 
 class StPicoHFEvent : public TObject
 {
@@ -43,12 +47,20 @@ public:
    void  addHFTertiaryVertexPair(StHFPair const*);
    void  addHFSecondaryVertexQuadruplet(StHFQuadruplet const*);
 
+   // -- add snapshot of a daughter track, in increasing picoDst index
+   void  addDaughterTrack(StPicoDaughterTrack const&);
+
    // -- get array with particles from secondary and tertiary vertex
    TClonesArray const * aHFSecondaryVertices() const;
    unsigned int         nHFSecondaryVertices() const;
    TClonesArray const * aHFTertiaryVertices()  const;
    unsigned int         nHFTertiaryVertices()  const;
 
+   // -- get snapshots of daughter tracks
+   TClonesArray const *        aDaughterTracks() const;
+   unsigned int                nDaughterTracks() const;
+   StPicoDaughterTrack const * daughterTrack(unsigned short idx) const; // NULL if not stored
+
    // -- get variables from StPicoEvent
    Int_t runId()   const;
    Int_t eventId() const;
@@ -64,6 +76,7 @@ private:
 
    unsigned int         mNHFSecondaryVertices;        // number of stored secondary vertex candidates
    unsigned int         mNHFTertiaryVertices;         // number of stored tertiary vertex candidates
+   unsigned int         mNDaughterTracks;             // number of stored daughter track snapshots
 
    TClonesArray*        mHFSecondaryVerticesArray;    // secondary vertex candidates
    static TClonesArray* fgHFSecondaryVerticesArray;
@@ -71,7 +84,10 @@ private:
    TClonesArray*        mHFTertiaryVerticesArray;     // tertiary vertex candidates
    static TClonesArray* fgHFTertiaryVerticesArray;
 
-   ClassDef(StPicoHFEvent, 1)
+   TClonesArray*        mDaughterTracksArray;         // daughter track snapshots
+   static TClonesArray* fgDaughterTracksArray;
+
+   ClassDef(StPicoHFEvent, 2)
 };
 
 inline TClonesArray const * StPicoHFEvent::aHFSecondaryVertices() const { return mHFSecondaryVerticesArray;}
@@ -80,6 +96,9 @@ inline unsigned int         StPicoHFEvent::nHFSecondaryVertices() const { return
 inline TClonesArray const * StPicoHFEvent::aHFTertiaryVertices()  const { return mHFTertiaryVerticesArray;}
 inline unsigned int         StPicoHFEvent::nHFTertiaryVertices()  const { return mNHFTertiaryVertices; }
 
+inline TClonesArray const * StPicoHFEvent::aDaughterTracks()      const { return mDaughterTracksArray;}
+inline unsigned int         StPicoHFEvent::nDaughterTracks()      const { return mNDaughterTracks; }
+
 inline Int_t StPicoHFEvent::runId()        const { return mRunId; }
 inline Int_t StPicoHFEvent::eventId()      const { return mEventId; }
 #endif
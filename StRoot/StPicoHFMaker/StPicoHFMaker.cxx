@@ -1,4 +1,5 @@
 #include <vector>
+#include <algorithm>
 
 #include "TTree.h"
 #include "TFile.h"
@@ -12,6 +13,8 @@
 #include "StPicoDstMaker/StPicoTrack.h"
 #include "StPicoDstMaker/StPicoBTofPidTraits.h"
 #include "StPicoPrescales/StPicoPrescales.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
+#include "StPicoCutsBase/StPicoChainReader.h"
 
 #include "StHFCuts.h"
 #include "StHFHists.h"
@@ -26,11 +29,14 @@ ClassImp(StPicoHFMaker)
 StPicoHFMaker::StPicoHFMaker(char const* name, StPicoDstMaker* picoMaker, 
 			     char const* outputBaseFileName,  char const* inputHFListHFtree = "") :
   StMaker(name), mPicoDst(NULL), mHFCuts(NULL), mHFHists(NULL), mPicoHFEvent(NULL), mBField(0.), mOutList(NULL),
-  mDecayMode(StPicoHFEvent::kTwoParticleDecay), mMakerMode(StPicoHFMaker::kAnalyze), mMcMode(false),
+  mDecayMode(StPicoHFEvent::kTwoParticleDecay), mMakerMode(StPicoHFMaker::kAnalyze), mMcMode(false), mStoreDaughterTracks(false),
+  mMassPreCheckValidation(false), mMassPreCheckFailed(false), mNMassPreCheckRejected(0), mNMassPreCheckLost(0),
   mOutputTreeName("picoHFtree"), mOutputFileBaseName(outputBaseFileName), mInputFileName(inputHFListHFtree),
-  mPicoDstMaker(picoMaker), mPicoEvent(NULL), mTree(NULL), mHFChain(NULL), mEventCounter(0), 
+  mPicoDstMaker(picoMaker), mPicoEvent(NULL), mTree(NULL), mHFChain(NULL), mHFChainReader(NULL), mEventCounter(0), 
   mOutputFileTree(NULL), mOutputFileList(NULL) {
   // -- constructor
+
+  mHFChainReader = new StPicoChainReader(Form("%s HF tree", name));
 }
 
 // _________________________________________________________
@@ -41,6 +47,8 @@ StPicoHFMaker::~StPicoHFMaker() {
     delete mHFCuts;
   mHFCuts = NULL;
 
+  delete mHFChainReader;
+
   /* mTree is owned by mOutputFile directory, it will be destructed once
    * the file is closed in ::Finish() */
 }
@@ -80,6 +88,7 @@ Int_t StPicoHFMaker::Init() {
 
     mHFChain->GetBranch("hfEvent")->SetAutoDelete(kFALSE);
     mHFChain->SetBranchAddress("hfEvent", &mPicoHFEvent);
+    mHFChainReader->init(mHFChain);
   }
   
   // -- file which holds list of histograms
@@ -133,6 +142,13 @@ Int_t StPicoHFMaker::Finish() {
   //    NOT TO BE OVERWRITTEN by daughter class
   //    daughter class should implement FinishHF()
 
+  if (mNMassPreCheckRejected > 0)
+    LOG_INFO << " StPicoHFMaker - pair mass pre-check rejected " << mNMassPreCheckRejected << " pairs"
+	     << (mMassPreCheckValidation ? Form(", %lld of them were good candidates", mNMassPreCheckLost) : "") << endm;
+
+  if (mMakerMode == StPicoHFMaker::kRead)
+    mHFChainReader->printStats();
+
   if (mMakerMode == StPicoHFMaker::kWrite) {
     mOutputFileTree->cd();
     mOutputFileTree->Write();
@@ -157,6 +173,12 @@ void StPicoHFMaker::resetEvent() {
   mIdxPicoPions.clear();
   mIdxPicoKaons.clear();
   mIdxPicoProtons.clear();
+
+  for (int iCharge = 0; iCharge < 2; ++iCharge) {
+    mIdxPicoPionsByCharge[iCharge].clear();
+    mIdxPicoKaonsByCharge[iCharge].clear();
+    mIdxPicoProtonsByCharge[iCharge].clear();
+  }
   
   mPicoHFEvent->clear("C");
 }
@@ -195,7 +217,7 @@ Int_t StPicoHFMaker::Make() {
   
   // -- read in HF tree
   if (mMakerMode == StPicoHFMaker::kRead) {
-    mHFChain->GetEntry(mEventCounter++);
+    mHFChainReader->getEntry(mEventCounter++);
 
     if (mPicoHFEvent->runId() != mPicoDst->event()->runId() || mPicoHFEvent->eventId() != mPicoDst->event()->eventId()) {
       LOG_ERROR <<" StPicoHFMaker - !!!!!!!!!!!! ATTENTION !!!!!!!!!!!!!"<<endm;
@@ -211,21 +233,55 @@ Int_t StPicoHFMaker::Make() {
 
     // -- Fill vectors of particle types
     if (mMakerMode == StPicoHFMaker::kWrite || mMakerMode == StPicoHFMaker::kAnalyze) {
+      mPvMomenta.resize(nTracks);
+      mPvPt.resize(nTracks);
+
       for (unsigned short iTrack = 0; iTrack < nTracks; ++iTrack) {
 	StPicoTrack* trk = mPicoDst->track(iTrack);
 
 	if (!trk || !mHFCuts->isGoodTrack(trk)) continue;
 
-	if (isPion(trk))   mIdxPicoPions.push_back(iTrack);   // isPion method to be implemented by daughter class
-	if (isKaon(trk))   mIdxPicoKaons.push_back(iTrack);   // isKaon method to be implemented by daughter class
-	if (isProton(trk)) mIdxPicoProtons.push_back(iTrack); // isProton method to be implemented by daughter class
+	int const iCharge = (trk->charge() > 0) ? 1 : 0;
+	bool isIdentified = false;
+
+	if (isPion(trk)) {   // isPion method to be implemented by daughter class
+	  mIdxPicoPions.push_back(iTrack);
+	  mIdxPicoPionsByCharge[iCharge].push_back(iTrack);
+	  isIdentified = true;
+	}
+	if (isKaon(trk)) {   // isKaon method to be implemented by daughter class
+	  mIdxPicoKaons.push_back(iTrack);
+	  mIdxPicoKaonsByCharge[iCharge].push_back(iTrack);
+	  isIdentified = true;
+	}
+	if (isProton(trk)) { // isProton method to be implemented by daughter class
+	  mIdxPicoProtons.push_back(iTrack);
+	  mIdxPicoProtonsByCharge[iCharge].push_back(iTrack);
+	  isIdentified = true;
+	}
+
+	if (isIdentified) {
+	  mPvMomenta[iTrack] = trk->gMom(mPrimVtx, mBField);
+	  mPvPt[iTrack] = mPvMomenta[iTrack].perp();
+	}
       
       } // .. end tracks loop
+
+      // -- sort lists split by charge by decreasing pT
+      for (int iCharge = 0; iCharge < 2; ++iCharge) {
+	sortByPt(mIdxPicoPionsByCharge[iCharge]);
+	sortByPt(mIdxPicoKaonsByCharge[iCharge]);
+	sortByPt(mIdxPicoProtonsByCharge[iCharge]);
+      }
     } // if (mMakerMode == StPicoHFMaker::kWrite || mMakerMode == StPicoHFMaker::kAnalyze) {
 
     // -- call method of daughter class
     iReturn = MakeHF();
 
+    // -- snapshots of the candidate daughters
+    if (mMakerMode == StPicoHFMaker::kWrite && mStoreDaughterTracks)
+      addDaughterTracks();
+
     // -- fill basic event histograms - for good events
     mHFHists->fillGoodEventHists(*mPicoEvent, *mPicoHFEvent);
 
@@ -244,37 +300,133 @@ Int_t StPicoHFMaker::Make() {
   return (kStOK && iReturn);
 }
 
+// _________________________________________________________
+namespace {
+  // -- decreasing pT, ties by track index
+  struct StHFHigherPt {
+    std::vector<float> const & pt;
+    explicit StHFHigherPt(std::vector<float> const & p) : pt(p) {}
+    bool operator()(unsigned short const a, unsigned short const b) const {
+      return (pt[a] > pt[b] || (pt[a] == pt[b] && a < b));
+    }
+  };
+}
+
+// _________________________________________________________
+void StPicoHFMaker::sortByPt(std::vector<unsigned short> &idx) const {
+  std::sort(idx.begin(), idx.end(), StHFHigherPt(mPvPt));
+}
+
+// _________________________________________________________
+bool StPicoHFMaker::passSecondaryPairMassPreCheck(unsigned short const p1Idx, unsigned short const p2Idx,
+						  int const p1PidFlag, int const p2PidFlag) {
+  // -- the momenta at the primary vertex differ from the ones at the secondary vertex
+  //    only by the small rotation along the decay length, covered by the pre-check margin
+
+  float const mass = StHFPair::massAtPrimaryVertex(mPvMomenta[p1Idx], mPvMomenta[p2Idx],
+						   mHFCuts->getHypotheticalMass(p1PidFlag), 
+						   mHFCuts->getHypotheticalMass(p2PidFlag));
+
+  mMassPreCheckFailed = !mHFCuts->isSecondaryPairMassPreCheck(mass);
+  if (mMassPreCheckFailed)
+    ++mNMassPreCheckRejected;
+
+  return (!mMassPreCheckFailed || mMassPreCheckValidation);
+}
+
+// _________________________________________________________
+void StPicoHFMaker::validateMassPreCheck(bool const isGoodCandidate) {
+  // -- count candidates which would have been lost by the pre-check
+
+  if (mMassPreCheckFailed && isGoodCandidate)
+    ++mNMassPreCheckLost;
+}
+
+// _________________________________________________________
+void StPicoHFMaker::addDaughterTracks() {
+  // -- one snapshot per track used by the candidates, in increasing track index
+  //    in kTwoAndTwoParticleDecay the second particle of the secondary pair is
+  //    the tertiary pair, its tracks come with the tertiary vertices
+
+  mIdxDaughters.clear();
+
+  TClonesArray const * aSecondary = mPicoHFEvent->aHFSecondaryVertices();
+  for (unsigned int idx = 0; idx < mPicoHFEvent->nHFSecondaryVertices(); ++idx) {
+    if (mDecayMode == StPicoHFEvent::kThreeParticleDecay) {
+      StHFTriplet const* triplet = static_cast<StHFTriplet*>(aSecondary->At(idx));
+      mIdxDaughters.push_back(triplet->particle1Idx());
+      mIdxDaughters.push_back(triplet->particle2Idx());
+      mIdxDaughters.push_back(triplet->particle3Idx());
+    }
+    else {
+      StHFPair const* pair = static_cast<StHFPair*>(aSecondary->At(idx));
+      mIdxDaughters.push_back(pair->particle1Idx());
+      if (mDecayMode != StPicoHFEvent::kTwoAndTwoParticleDecay)
+	mIdxDaughters.push_back(pair->particle2Idx());
+    }
+  }
+
+  TClonesArray const * aTertiary = mPicoHFEvent->aHFTertiaryVertices();
+  if (mDecayMode == StPicoHFEvent::kTwoAndTwoParticleDecay) {
+    for (unsigned int idx = 0; idx < mPicoHFEvent->nHFTertiaryVertices(); ++idx) {
+      StHFPair const* pair = static_cast<StHFPair*>(aTertiary->At(idx));
+      mIdxDaughters.push_back(pair->particle1Idx());
+      mIdxDaughters.push_back(pair->particle2Idx());
+    }
+  }
+
+  std::sort(mIdxDaughters.begin(), mIdxDaughters.end());
+  mIdxDaughters.erase(std::unique(mIdxDaughters.begin(), mIdxDaughters.end()), mIdxDaughters.end());
+
+  for (std::vector<unsigned short>::const_iterator iter = mIdxDaughters.begin(); iter != mIdxDaughters.end(); ++iter) {
+    StPicoTrack const* trk = mPicoDst->track(*iter);
+    StPicoBTofPidTraits const* tofPid = trk->bTofPidTraitsIndex() >= 0 ? mPicoDst->btofPidTraits(trk->bTofPidTraitsIndex()) : NULL;
+    mPicoHFEvent->addDaughterTrack(StPicoDaughterTrack(*trk, *iter, mPrimVtx, mBField, tofPid));
+  }
+}
+
 // _________________________________________________________
 void StPicoHFMaker::createTertiaryK0Shorts() {
   // -- Create candidate for tertiary K0shorts
+  //    pi+ pi- pairs, like-sign pairs only if requested in StHFCuts
 
-  for (unsigned short idxPion1 = 0; idxPion1 < mIdxPicoPions.size(); ++idxPion1) {
-    StPicoTrack const * pion1 = mPicoDst->track(mIdxPicoPions[idxPion1]);
-
-    if (!mHFCuts->cutMinDcaToPrimVertexTertiary(pion1, StHFCuts::kPion))
-      continue;
-    
-    for (unsigned short idxPion2 = idxPion1+1 ; idxPion2 < mIdxPicoPions.size(); ++idxPion2) {
-      StPicoTrack const * pion2 = mPicoDst->track(mIdxPicoPions[idxPion2]);      
+  for (int iCharge1 = 0; iCharge1 < 2; ++iCharge1) {
+    std::vector<unsigned short> const & pions1 = mIdxPicoPionsByCharge[iCharge1];
 
-      if (mIdxPicoPions[idxPion1] == mIdxPicoPions[idxPion2]) 
+    for (int iCharge2 = iCharge1; iCharge2 < 2; ++iCharge2) {
+      bool const likeSign = (iCharge1 == iCharge2);
+      if (likeSign && !mHFCuts->tertiaryPairLikeSign())
 	continue;
 
-      if (!mHFCuts->cutMinDcaToPrimVertexTertiary(pion2, StHFCuts::kPion))
-	continue;
+      std::vector<unsigned short> const & pions2 = mIdxPicoPionsByCharge[iCharge2];
 
-      StHFPair candidateK0Short(pion1, pion2, 
-				mHFCuts->getHypotheticalMass(StHFCuts::kPion), mHFCuts->getHypotheticalMass(StHFCuts::kPion),
-				mIdxPicoPions[idxPion1], mIdxPicoPions[idxPion2], 
-				mPrimVtx, mBField, false);
+      for (unsigned short idxPion1 = 0; idxPion1 < pions1.size(); ++idxPion1) {
+	StPicoTrack const * pion1 = mPicoDst->track(pions1[idxPion1]);
 
-      if (!mHFCuts->isGoodTertiaryVertexPair(candidateK0Short)) 
-	continue;
+	if (!mHFCuts->cutMinDcaToPrimVertexTertiary(pion1, StHFCuts::kPion))
+	  continue;
 
-      mPicoHFEvent->addHFTertiaryVertexPair(&candidateK0Short);
+	// -- each like-sign pair once
+	for (unsigned short idxPion2 = likeSign ? idxPion1+1 : 0; idxPion2 < pions2.size(); ++idxPion2) {
+	  StPicoTrack const * pion2 = mPicoDst->track(pions2[idxPion2]);
 
-      // -- fill tertiary pair histograms
-      mHFHists->fillTertiaryPairHists(&candidateK0Short, kTRUE);
+	  if (!mHFCuts->cutMinDcaToPrimVertexTertiary(pion2, StHFCuts::kPion))
+	    continue;
+
+	  StHFPair candidateK0Short(pion1, pion2, 
+				    mHFCuts->getHypotheticalMass(StHFCuts::kPion), mHFCuts->getHypotheticalMass(StHFCuts::kPion),
+				    pions1[idxPion1], pions2[idxPion2], 
+				    mPrimVtx, mBField, false);
+
+	  if (!mHFCuts->isGoodTertiaryVertexPair(candidateK0Short)) 
+	    continue;
+
+	  mPicoHFEvent->addHFTertiaryVertexPair(&candidateK0Short);
+
+	  // -- fill tertiary pair histograms
+	  mHFHists->fillTertiaryPairHists(&candidateK0Short, kTRUE);
+	}
+      }
     }
   }
 }
@@ -282,34 +434,46 @@ void StPicoHFMaker::createTertiaryK0Shorts() {
 // _________________________________________________________
 void StPicoHFMaker::createTertiaryLambdas() {
   // -- Create candidate for tertiary Lambdas
+  //    p pi- and pbar pi+ pairs, like-sign pairs only if requested in StHFCuts
 
-  for (unsigned short idxProton = 0; idxProton < mIdxPicoProtons.size(); ++idxProton) {
-    StPicoTrack const * proton = mPicoDst->track(mIdxPicoProtons[idxProton]);
+  for (int iChargeProton = 0; iChargeProton < 2; ++iChargeProton) {
+    std::vector<unsigned short> const & protons = mIdxPicoProtonsByCharge[iChargeProton];
 
-    if (!mHFCuts->cutMinDcaToPrimVertexTertiary(proton, StHFCuts::kProton))
-      continue;
+    for (int iChargePion = 0; iChargePion < 2; ++iChargePion) {
+      if (iChargePion == iChargeProton && !mHFCuts->tertiaryPairLikeSign())
+	continue;
 
-    for (unsigned short idxPion = 0 ; idxPion < mIdxPicoPions.size(); ++idxPion) {
-      StPicoTrack const * pion = mPicoDst->track(mIdxPicoPions[idxPion]);      
+      std::vector<unsigned short> const & pions = mIdxPicoPionsByCharge[iChargePion];
 
-      if (mIdxPicoPions[idxProton] == mIdxPicoPions[idxPion]) 
-	continue;
+      for (unsigned short idxProton = 0; idxProton < protons.size(); ++idxProton) {
+	StPicoTrack const * proton = mPicoDst->track(protons[idxProton]);
 
-      if (!mHFCuts->cutMinDcaToPrimVertexTertiary(pion, StHFCuts::kPion))
-	continue;
+	if (!mHFCuts->cutMinDcaToPrimVertexTertiary(proton, StHFCuts::kProton))
+	  continue;
+
+	for (unsigned short idxPion = 0 ; idxPion < pions.size(); ++idxPion) {
+	  StPicoTrack const * pion = mPicoDst->track(pions[idxPion]);      
+
+	  if (protons[idxProton] == pions[idxPion]) 
+	    continue;
+
+	  if (!mHFCuts->cutMinDcaToPrimVertexTertiary(pion, StHFCuts::kPion))
+	    continue;
       
-      StHFPair lambda(proton, pion, 
-		      mHFCuts->getHypotheticalMass(StHFCuts::kProton), mHFCuts->getHypotheticalMass(StHFCuts::kPion),
-		      mIdxPicoProtons[idxProton], mIdxPicoPions[idxPion], 
-		      mPrimVtx, mBField, false);
+	  StHFPair lambda(proton, pion, 
+			  mHFCuts->getHypotheticalMass(StHFCuts::kProton), mHFCuts->getHypotheticalMass(StHFCuts::kPion),
+			  protons[idxProton], pions[idxPion], 
+			  mPrimVtx, mBField, false);
 
-      if (!mHFCuts->isGoodTertiaryVertexPair(lambda)) 
-	continue;
+	  if (!mHFCuts->isGoodTertiaryVertexPair(lambda)) 
+	    continue;
 
-      mPicoHFEvent->addHFTertiaryVertexPair(&lambda);
+	  mPicoHFEvent->addHFTertiaryVertexPair(&lambda);
 
-      // -- fill tertiary pair histograms
-      mHFHists->fillTertiaryPairHists(&lambda, kTRUE);
+	  // -- fill tertiary pair histograms
+	  mHFHists->fillTertiaryPairHists(&lambda, kTRUE);
+	}
+      }
     }
   }
 }
@@ -34,6 +34,13 @@
  *     isKaon
  *     isProton
  *
+ *  - With setStoreDaughterTracks(true) a StPicoDaughterTrack snapshot of the
+ *    candidate daughters is written to the tree, the candidates find theirs
+ *    via StPicoHFEvent::daughterTrack(particleXIdx())
+ *
+ *  - Identified particles are stored in mIdxPicoPions/Kaons/Protons and,
+ *    split by charge and sorted by decreasing pT, in mIdxPicoPions/Kaons/ProtonsByCharge[2]
+ *
  * **************************************************
  *
  *  Initial Authors:
@@ -63,6 +70,7 @@ class StHFPair;
 class StHFTriplet;
 class StHFCuts;
 class StHFHists;
+class StPicoChainReader;
 
 class StPicoHFMaker : public StMaker 
 {
@@ -84,6 +92,11 @@ class StPicoHFMaker : public StMaker
     void setMakerMode(unsigned short us);
     void setDecayMode(unsigned short us);
     void setMcMode(bool b);
+    void setMassPreCheckValidation(bool b);
+    void setStoreDaughterTracks(bool b);
+
+    // -- kRead: TTreeCache and branches read from the HF trees, set up before Init()
+    StPicoChainReader* chainReader() const;
 
     // -- different modes to use the StPicoHFMaker class
     //    - kAnalyze - don't write candidate trees, just fill histograms
@@ -114,6 +127,15 @@ class StPicoHFMaker : public StMaker
     unsigned int isDecayMode() const;
     unsigned int isMakerMode() const;
     bool         isMcMode() const;
+
+    // -- cheap pre-check of the secondary pair mass from the cached momenta at the primary vertex
+    //    call before building the StHFPair, then validateMassPreCheck() with the result of the
+    //    full cuts. In validation mode every pair passes and the lost candidates are counted
+    bool passSecondaryPairMassPreCheck(unsigned short p1Idx, unsigned short p2Idx, int p1PidFlag, int p2PidFlag);
+    void validateMassPreCheck(bool isGoodCandidate);
+
+    // -- pT at the primary vertex of an identified particle, conserved along the helix
+    float ptAtPrimaryVertex(unsigned short idx) const;
     
     // -- protected members ------------------------
 
@@ -133,9 +155,22 @@ class StPicoHFMaker : public StMaker
     std::vector<unsigned short> mIdxPicoKaons;
     std::vector<unsigned short> mIdxPicoProtons;
 
+    // -- same indices split by charge, [0] negative [1] positive, sorted by decreasing pT
+    //    loops over them skip charge combinations of no interest and can stop once
+    //    the sum of the daughters pT drops below the candidate pT cut
+    std::vector<unsigned short> mIdxPicoPionsByCharge[2];
+    std::vector<unsigned short> mIdxPicoKaonsByCharge[2];
+    std::vector<unsigned short> mIdxPicoProtonsByCharge[2];
+
+    // -- momenta and pT at the primary vertex of identified particles, indexed by track index
+    std::vector<StThreeVectorF> mPvMomenta;
+    std::vector<float>          mPvPt;
+
   private:
     void  resetEvent();
+    void  sortByPt(std::vector<unsigned short> &idx) const;
     bool  setupEvent();
+    void  addDaughterTracks();
     
     void  initializeEventStats();
     void  fillEventStats(int *aEventStat);
@@ -147,6 +182,14 @@ class StPicoHFMaker : public StMaker
 
     bool            mMcMode;             // use MC mode
 
+    bool            mStoreDaughterTracks; // write daughter track snapshots in kWrite mode
+    std::vector<unsigned short> mIdxDaughters;
+
+    bool            mMassPreCheckValidation;   // build pairs failing the mass pre-check and count lost candidates
+    bool            mMassPreCheckFailed;       // result of the last pre-check
+    Long64_t        mNMassPreCheckRejected;
+    Long64_t        mNMassPreCheckLost;
+
     TString         mOutputTreeName;     // name for output trees
 
     TString         mOutputFileBaseName; // base name for output files
@@ -163,6 +206,7 @@ class StPicoHFMaker : public StMaker
     TTree*          mTree;               // tree holding "mPicoHFEvent" for writing only
 
     TChain*         mHFChain;            // chain to read in HF tree
+    StPicoChainReader* mHFChainReader;   // reads mHFChain
     int             mEventCounter;       // n Processed events in chain
 
     TFile*          mOutputFileTree;     // ptr to file saving the HFtree
@@ -176,8 +220,12 @@ inline void StPicoHFMaker::setTreeName(const char* tName)  { mOutputTreeName = t
 inline void StPicoHFMaker::setMakerMode(unsigned short us) { mMakerMode = us; }
 inline void StPicoHFMaker::setDecayMode(unsigned short us) { mDecayMode = us; }
 inline void StPicoHFMaker::setMcMode(bool b)               { mMcMode = b; }
+inline void StPicoHFMaker::setMassPreCheckValidation(bool b) { mMassPreCheckValidation = b; }
+inline void StPicoHFMaker::setStoreDaughterTracks(bool b)    { mStoreDaughterTracks = b; }
+inline StPicoChainReader* StPicoHFMaker::chainReader() const { return mHFChainReader; }
 
 inline unsigned int StPicoHFMaker::isDecayMode() const     { return mDecayMode; }
 inline unsigned int StPicoHFMaker::isMakerMode() const     { return mMakerMode; }
 inline bool StPicoHFMaker::isMcMode() const                { return mMcMode; }
+inline float StPicoHFMaker::ptAtPrimaryVertex(unsigned short idx) const { return mPvPt[idx]; }
 #endif
@@ -84,28 +84,56 @@ int StPicoHFMyAnaMaker::createCandidates() {
   // -- ADD USER CODE TO CREATE PARTICLE CANDIDATES --------
   //    - vectors mIdxPicoKaons, mIdxPicoPions mIdxPicoProtons
   //      have been filled in the background using the cuts in HFCuts
+  //    - mIdxPicoKaonsByCharge[2], ... hold the same split by charge, sorted by decreasing pT
 
   // -- Decay channel1 --- EXAMPLE
   if (mDecayChannel == StPicoHFMyAnaMaker::kChannel1) {
 
-    for (unsigned short idxKaon = 0; idxKaon < mIdxPicoKaons.size(); ++idxKaon) {
-      StPicoTrack const *kaon = mPicoDst->track(mIdxPicoKaons[idxKaon]);
+    // -- loop over charge combinations, like-sign pairs only if requested in HFCuts
+    for (int iChargeKaon = 0; iChargeKaon < 2; ++iChargeKaon) {
+      for (int iChargePion = 0; iChargePion < 2; ++iChargePion) {
+	if (iChargeKaon == iChargePion && !mHFCuts->secondaryPairLikeSign())
+	  continue;
+
+	std::vector<unsigned short> const & kaons = mIdxPicoKaonsByCharge[iChargeKaon];
+	std::vector<unsigned short> const & pions = mIdxPicoPionsByCharge[iChargePion];
+
+	// -- lists are sorted by decreasing pT: pT(pair) <= pT(kaon) + pT(pion) ends the loops
+	float const maxPionPt = pions.empty() ? 0. : ptAtPrimaryVertex(pions.front());
+
+	for (unsigned short idxKaon = 0; idxKaon < kaons.size(); ++idxKaon) {
+	  float const kaonPt = ptAtPrimaryVertex(kaons[idxKaon]);
+	  if (kaonPt + maxPionPt < mHFCuts->cutSecondaryPairPtMin())
+	    break;
+
+	  StPicoTrack const *kaon = mPicoDst->track(kaons[idxKaon]);
       
-      for (unsigned short idxPion = 0; idxPion < mIdxPicoPions.size(); ++idxPion) {
-	StPicoTrack const *pion = mPicoDst->track(mIdxPicoPions[idxPion]);
+	  for (unsigned short idxPion = 0; idxPion < pions.size(); ++idxPion) {
+	    if (kaonPt + ptAtPrimaryVertex(pions[idxPion]) < mHFCuts->cutSecondaryPairPtMin())
+	      break;
+
+	    StPicoTrack const *pion = mPicoDst->track(pions[idxPion]);
 	
-	if (mIdxPicoKaons[idxKaon] == mIdxPicoPions[idxPion]) 
-	  continue;
+	    if (kaons[idxKaon] == pions[idxPion]) 
+	      continue;
+
+	    // -- skip pairs far from the mass window before calculating the topology
+	    if (!passSecondaryPairMassPreCheck(kaons[idxKaon], pions[idxPion], StHFCuts::kKaon, StHFCuts::kPion))
+	      continue;
       
-	StHFPair pair(kaon, pion,
-		      mHFCuts->getHypotheticalMass(StHFCuts::kKaon), mHFCuts->getHypotheticalMass(StHFCuts::kPion),
-		      mIdxPicoKaons[idxKaon], mIdxPicoPions[idxPion], mPrimVtx, mBField);
-	if (!mHFCuts->isGoodSecondaryVertexPair(pair)) 
-	  continue;
-	mPicoHFEvent->addHFSecondaryVertexPair(&pair);
+	    StHFPair pair(kaon, pion,
+			  mHFCuts->getHypotheticalMass(StHFCuts::kKaon), mHFCuts->getHypotheticalMass(StHFCuts::kPion),
+			  kaons[idxKaon], pions[idxPion], mPrimVtx, mBField);
+	    bool const isGoodPair = mHFCuts->isGoodSecondaryVertexPair(pair);
+	    validateMassPreCheck(isGoodPair);
+	    if (!isGoodPair) 
+	      continue;
+	    mPicoHFEvent->addHFSecondaryVertexPair(&pair);
 	
-      } // for (unsigned short idxPion = 0; idxPion < mIdxPicoPions.size(); ++idxPion) {
-    } // for (unsigned short idxKaon = 0; idxKaon < mIdxPicoKaons.size(); ++idxKaon) {
+	  } // for (unsigned short idxPion = 0; idxPion < pions.size(); ++idxPion) {
+	} // for (unsigned short idxKaon = 0; idxKaon < kaons.size(); ++idxKaon) {
+      } // for (int iChargePion = 0; iChargePion < 2; ++iChargePion) {
+    } // for (int iChargeKaon = 0; iChargeKaon < 2; ++iChargeKaon) {
   } // else  if (mDecayChannel == StPicoHFMyAnaMaker::Channel1) {
 
  return kStOK;
@@ -130,6 +158,8 @@ int StPicoHFMyAnaMaker::analyzeCandidates() {
     for (unsigned int idx = 0; idx <  mPicoHFEvent->nHFSecondaryVertices(); ++idx) {
       StHFPair const* pair = static_cast<StHFPair*>(aCandidates->At(idx));
 
+      // -- files written with setStoreDaughterTracks(true) also hold the daughters
+      //    as StPicoDaughterTrack: mPicoHFEvent->daughterTrack(pair->particle1Idx())
       StPicoTrack const* kaon = mPicoDst->track(pair->particle1Idx());
       kaon->gPt();
       StPicoTrack const* pion = mPicoDst->track(pair->particle2Idx());
@@ -4,6 +4,7 @@
 #include "StarRoot/MTrack.h"
 #include "StiMaker/StKFVerticesCollection.h"
 #include "StEvent/StDcaGeometry.h"
+#include "TError.h"
 
 #include "StPicoDstMaker/StPicoDst.h"
 #include "StPicoDstMaker/StPicoTrack.h"
@@ -11,13 +12,31 @@
 
 using namespace std;
 
+StPicoKFVertexFitter::StPicoKFVertexFitter(unsigned int const nTracksReserve) : mHasEventFit(false)
+{
+   reserve(nTracksReserve);
+}
+
+void StPicoKFVertexFitter::reserve(unsigned int const nTracks) const
+{
+   if (mParticles.size() >= nTracks) return;
+
+   // the buffers only grow, their elements are overwritten by each refit
+   mGoodTracks.reserve(nTracks);
+   mParticles.resize(nTracks);
+   mParticlePointers.resize(nTracks);
+   mParameters.resize(6 * nTracks);
+   mCovariances.resize(21 * nTracks);
+   mFlags.resize(nTracks);
+}
+
 StThreeVectorF StPicoKFVertexFitter::primaryVertexRefit(StPicoDst const* const picoDst,
     std::vector<int>& tracksToRemove) const
 {
    // just in case it is not sorted
    std::sort(tracksToRemove.begin(),tracksToRemove.end());
 
-   vector<int> goodTracks;
+   mGoodTracks.clear();
 
    // make a list of good tracks to be used in the KFVertex fit
    for (unsigned int iTrk = 0; iTrk < picoDst->numberOfTracks(); ++iTrk)
@@ -27,52 +46,101 @@ StThreeVectorF StPicoKFVertexFitter::primaryVertexRefit(StPicoDst const* const p
 
       if(std::binary_search(tracksToRemove.begin(), tracksToRemove.end(), iTrk)) continue;
 
-      goodTracks.push_back(iTrk);
+      mGoodTracks.push_back(iTrk);
    }
 
-   return primaryVertexRefitUsingTracks(picoDst,goodTracks);
+   return primaryVertexRefitUsingTracks(picoDst,mGoodTracks);
 }
 
 StThreeVectorF StPicoKFVertexFitter::primaryVertexRefitUsingTracks(StPicoDst const* const picoDst,
     std::vector<int>& tracksToUse) const
 {
-  // fill an array of KFParticles
-  KFParticle* particles[tracksToUse.size()];
+   size_t const nTracks = tracksToUse.size();
+   reserve(nTracks);
 
-   for (size_t iTrk = 0; iTrk < tracksToUse.size(); ++iTrk)
+   // fill the pool of KFParticles
+   MTrack track;
+   track.SetNDF(1);
+
+   for (size_t iTrk = 0; iTrk < nTracks; ++iTrk)
    {
       StPicoTrack* gTrack = (StPicoTrack*)picoDst->track(tracksToUse[iTrk]);
 
-      StDcaGeometry dcaG = gTrack->dcaGeometry();
-      Double_t xyzp[6], CovXyzp[21];
+      Double_t* xyzp = &mParameters[6 * iTrk];
+      Double_t* CovXyzp = &mCovariances[21 * iTrk];
+
+      StDcaGeometry const dcaG = gTrack->dcaGeometry();
       dcaG.GetXYZ(xyzp, CovXyzp);
-      MTrack track;
       track.SetParameters(xyzp);
       track.SetCovarianceMatrix(CovXyzp);
-      track.SetNDF(1);
       track.SetID(gTrack->id());
       track.SetCharge(dcaG.charge());
 
       Int_t pdg = dcaG.charge() > 0 ? 211 : -211; // assume all tracks are pions.
 
-      particles[iTrk] = new KFParticle(track, pdg);
+      mParticles[iTrk] = KFParticle(track, pdg);
+      mParticlePointers[iTrk] = &mParticles[iTrk];
+   }
+
+   std::fill(mFlags.begin(), mFlags.begin() + nTracks, 0);
+   mHasEventFit = false;
+   mVertex = KFVertex();
+   mVertex.ConstructPrimaryVertex(nTracks ? &mParticlePointers[0] : NULL, nTracks,
+                                  nTracks ? (Bool_t*) &mFlags[0] : NULL, TMath::Sqrt(StAnneling::Chi2Cut() / 2));
+
+   return toThreeVector(mVertex);
+}
+
+StThreeVectorF StPicoKFVertexFitter::primaryVertexFitEvent(StPicoDst const* const picoDst) const
+{
+   std::vector<int> noTracks;
+   StThreeVectorF const kfVertex = primaryVertexRefit(picoDst, noTracks);
+
+   // mGoodTracks holds the picoDst indices of the pool
+   mTrackSlots.assign(picoDst->numberOfTracks(), -1);
+   for (size_t iSlot = 0; iSlot < mGoodTracks.size(); ++iSlot) mTrackSlots[mGoodTracks[iSlot]] = iSlot;
+
+   mHasEventFit = true;
+   return kfVertex;
+}
+
+StThreeVectorF StPicoKFVertexFitter::removeTracks(int const* const tracksToRemove, int const nTracksToRemove) const
+{
+   if (!mHasEventFit)
+   {
+     Error("StPicoKFVertexFitter::removeTracks", "no event fit, call primaryVertexFitEvent() first");
+     return StThreeVectorF(-999.,-999.,-999.);
    }
 
-   TArrayC Flag(tracksToUse.size());
-   KFVertex aVertex;
-   aVertex.ConstructPrimaryVertex((const KFParticle **) particles, tracksToUse.size(),
-                                  (Bool_t*) Flag.GetArray(), TMath::Sqrt(StAnneling::Chi2Cut() / 2));
+   KFVertex vertex = mVertex;
+   if (!vertex.GetX()) return toThreeVector(vertex);
+
+   for (int iTrk = 0; iTrk < nTracksToRemove; ++iTrk)
+   {
+      int const idx = tracksToRemove[iTrk];
+      if (idx < 0 || idx >= (int)mTrackSlots.size()) continue;
 
-   // clean up
-   for(size_t iTrk = 0; iTrk < tracksToUse.size(); ++iTrk) delete particles[iTrk];
+      // only tracks the event fit used contribute to the vertex
+      int const slot = mTrackSlots[idx];
+      if (slot < 0 || !mFlags[slot]) continue;
 
+      // a track listed twice is removed once
+      if (std::find(tracksToRemove, tracksToRemove + iTrk, idx) != tracksToRemove + iTrk) continue;
+
+      mParticles[slot].SubtractFromVertex(vertex);
+   }
+
+   return toThreeVector(vertex);
+}
+
+StThreeVectorF StPicoKFVertexFitter::toThreeVector(KFVertex const& vertex)
+{
    StThreeVectorF kfVertex(-999.,-999.,-999.);
 
-   if (aVertex.GetX())
+   if (vertex.GetX())
    {
-     kfVertex.set(aVertex.GetX(), aVertex.GetY(), aVertex.GetZ());
+     kfVertex.set(vertex.GetX(), vertex.GetY(), vertex.GetZ());
    }
 
    return kfVertex;
-
 }
@@ -5,6 +5,28 @@
  *  Class to fit primary vertex using KF vertex maker
  *
  *  Usage:
+ *    Keep one fitter for the whole job, the KFParticles
+ *    and the track parameter/covariance buffers are kept
+ *    between refits and only grow with the largest event,
+ *    a refit does no per-track heap allocation.
+ *    Not thread safe, use one fitter per thread.
+ *
+ *  Leave-daughters-out vertices:
+ *    primaryVertexFitEvent() fits the vertex of all tracks
+ *    once per event and keeps the tracks of the fit,
+ *    primaryVertexWithoutTracks() then removes the
+ *    daughters of a candidate from it by the inverse Kalman
+ *    update of KFParticle::SubtractFromVertex, at a cost of
+ *    O(daughters) per candidate instead of a refit.
+ *    The tracks rejected by the event fit stay rejected and
+ *    the subtraction is linearized at the event vertex, the
+ *    result agrees with primaryVertexRefit(picoDst, daughters)
+ *    within the vertex resolution, not exactly.
+ *    Any other refit in between invalidates the event fit.
+ *
+ *      kfVertexFitter.primaryVertexFitEvent(picoDst);
+ *      for (candidates)
+ *        StThreeVectorF pVtx = kfVertexFitter.primaryVertexWithoutTracks(kaonIdx, pionIdx);
  *
  * **************************************************
  *  Authors:
@@ -18,14 +40,19 @@
 
 #include <vector>
 #include "StThreeVectorF.hh"
+#include "StarRoot/KFParticle.h"
+#include "StarRoot/KFVertex.h"
 
 class StPicoDst;
 
 class StPicoKFVertexFitter
 {
   public:
-   StPicoKFVertexFitter() {}
+   explicit StPicoKFVertexFitter(unsigned int nTracksReserve = 0);
    ~StPicoKFVertexFitter() {}
+
+   // preallocate the buffers for nTracks tracks
+   void reserve(unsigned int nTracks) const;
    
    StThreeVectorF primaryVertexRefit(StPicoDst const*) const;
 
@@ -34,6 +61,29 @@ class StPicoKFVertexFitter
 
    StThreeVectorF primaryVertexRefitUsingTracks(StPicoDst const*,
        std::vector<int>& tracksToUse) const;
+
+   // -- leave-daughters-out mode, the vertices are (-999, -999, -999) if the event fit failed
+   StThreeVectorF primaryVertexFitEvent(StPicoDst const*) const;
+   StThreeVectorF primaryVertexWithoutTracks(std::vector<int> const& tracksToRemove) const;
+   StThreeVectorF primaryVertexWithoutTracks(int idx1, int idx2) const;
+
+  private:
+   // subtracts the tracks from the event vertex
+   StThreeVectorF removeTracks(int const* tracksToRemove, int nTracksToRemove) const;
+   static StThreeVectorF toThreeVector(KFVertex const&);
+
+   // scratch buffers of the refits
+   mutable std::vector<int> mGoodTracks;
+   mutable std::vector<KFParticle> mParticles;
+   mutable std::vector<KFParticle const*> mParticlePointers;
+   mutable std::vector<Double_t> mParameters;  // 6 per track: x, y, z, px, py, pz
+   mutable std::vector<Double_t> mCovariances; // 21 per track
+   mutable std::vector<Char_t> mFlags;
+
+   // of the last fit
+   mutable KFVertex mVertex;
+   mutable bool mHasEventFit;
+   mutable std::vector<int> mTrackSlots;        // picoDst index -> pool index, -1 if not in the event fit
 };
 
 inline StThreeVectorF StPicoKFVertexFitter::primaryVertexRefit(StPicoDst const* picoDst) const
@@ -41,4 +91,15 @@ inline StThreeVectorF StPicoKFVertexFitter::primaryVertexRefit(StPicoDst const*
   std::vector<int> v;
   return primaryVertexRefit(picoDst,v);
 }
+
+inline StThreeVectorF StPicoKFVertexFitter::primaryVertexWithoutTracks(std::vector<int> const& tracksToRemove) const
+{
+  return removeTracks(tracksToRemove.empty() ? NULL : &tracksToRemove[0], tracksToRemove.size());
+}
+
+inline StThreeVectorF StPicoKFVertexFitter::primaryVertexWithoutTracks(int const idx1, int const idx2) const
+{
+  int const tracksToRemove[2] = {idx1, idx2};
+  return removeTracks(tracksToRemove, 2);
+}
 #endif
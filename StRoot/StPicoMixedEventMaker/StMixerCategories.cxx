@@ -0,0 +1,55 @@
+#include <cmath>
+
+#include "StMixerCategories.h"
+#include "StMixerCuts.h"
+
+namespace
+{
+  char const* const axisNames[StMixerCategories::kNAxes] = {"Vz", "Cent", "Ep", "Mult"};
+}
+
+StMixerCategories::StMixerCategories()
+{
+  for(int i = 0; i < kNAxes; ++i) setAxis(i, 1, 0, 1);
+  setAxis(kVz, 10, -mxeCuts::maxVz, mxeCuts::maxVz);
+  setAxis(kCentrality, 9, 0, 9);
+}
+void StMixerCategories::setAxis(int const axis, int const nBins, float const min, float const max)
+{
+  mNBins[axis] = nBins > 1 ? nBins : 1;
+  mMin[axis] = min;
+  mMax[axis] = max;
+}
+int StMixerCategories::nCategories() const
+{
+  int n = 1;
+  for(int i = 0; i < kNAxes; ++i) n *= mNBins[i];
+  return n;
+}
+int StMixerCategories::category(float const values[kNAxes]) const
+{
+  int category = 0;
+  for(int i = kNAxes - 1; i >= 0; --i){
+    int bin = 0;
+    if(usesAxis(i)){
+      bin = (int)std::floor((values[i] - mMin[i]) / (mMax[i] - mMin[i]) * mNBins[i]);
+      if(bin < 0 || bin >= mNBins[i]) return -1;
+    }
+    category = category * mNBins[i] + bin;
+  }
+  return category;
+}
+TString StMixerCategories::name(int category) const
+{
+  int bins[kNAxes];
+  for(int i = 0; i < kNAxes; ++i){
+    bins[i] = category % mNBins[i];
+    category /= mNBins[i];
+  }
+
+  // the original pool names come first
+  TString name = TString::Format("%s_%i_%s_%i", axisNames[kCentrality], bins[kCentrality], axisNames[kVz], bins[kVz]);
+  for(int i = kEventPlane; i < kNAxes; ++i)
+    if(usesAxis(i)) name += TString::Format("_%s_%i", axisNames[i], bins[i]);
+  return name;
+}
@@ -0,0 +1,40 @@
+#ifndef StMixerCategories_hh
+#define StMixerCategories_hh
+/* **************************************************
+ *
+ * Event categories of the mixer pools. Every axis has
+ * uniform bins, axes with one bin are not used. Default
+ * is 10 vz bins in [-6, 6] cm and the 9 StRefMultCorr
+ * centrality bins, the pools of the original mixer.
+ *
+ * **************************************************
+ *
+ *  Initial Authors:  
+ *         ** Michael Lomnitz (mrlomnitz@lbl.gov)
+ *            Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include "TString.h"
+
+class StMixerCategories{
+ public:
+  enum axis {kVz, kCentrality, kEventPlane, kMultiplicity, kNAxes};
+
+  StMixerCategories();
+  void setAxis(int axis, int nBins, float min, float max);
+  bool usesAxis(int axis) const;
+  int nCategories() const;
+  // values are indexed by axis, -1 if outside any used axis
+  int category(float const values[kNAxes]) const;
+  TString name(int category) const;
+ private:
+  int   mNBins[kNAxes];
+  float mMin[kNAxes];
+  float mMax[kNAxes];
+};
+inline bool StMixerCategories::usesAxis(int axis) const { return mNBins[axis] > 1; }
+#endif
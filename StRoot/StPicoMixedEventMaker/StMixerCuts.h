@@ -52,6 +52,23 @@ namespace mxeCuts
   float const nSigmaKaon = 2.0;
   float const kTofBetaDiff = 0.03;
   
+  //Charge combinations
+  bool const likeSign = true; // mix like-sign pairs for the background
+
+  //Pools
+  int const eventBuffer = 10; // events per pool without a memory budget, and the maximum with one
+  int const minEventBuffer = 2;
+  int const eventBytesEstimate = 8000; // until the first events are measured
+
+  //Mixing strategy, see StMixerStrategy
+  enum mixingStrategy {kOneSided, kSymmetric, kMostRecent};
+  int const defaultStrategy = kOneSided;
+  int const nMostRecent = 8; // events a new event is mixed with in kMostRecent
+
+  //Track encoding, see StMixerTrackBlock
+  bool const compactTracks = false;
+  float const compactMassTolerance = 0.001; // GeV, validation of the compact encoding
+  
   //Topology
   float const massMin = 0;
   float const massMax = 2.5;
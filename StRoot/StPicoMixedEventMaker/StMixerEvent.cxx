@@ -3,30 +3,81 @@
 #include "StMixerEvent.h"
 
 StMixerEvent::StMixerEvent() :  mVtx(StThreeVectorF()),
-    mBField(std::numeric_limits<float>::quiet_NaN())
+    mBField(std::numeric_limits<float>::quiet_NaN()), mNAllocations(0), mNDroppedTracks(0), mNUnencodedTracks(0),
+    mFullTracks(true), mCompactTracks(false)
 {
 }
 StMixerEvent::StMixerEvent(StMixerEvent *t) : mVtx(t->mVtx), mBField(t->mBField),
-					      mTracks(t->mTracks),
-					      mEventKaons(t->mEventKaons), mEventPions(t->mEventPions)
+					      mNAllocations(0), mNDroppedTracks(0), mNUnencodedTracks(0),
+					      mFullTracks(t->mFullTracks), mCompactTracks(t->mCompactTracks)
 {
+  for(int i = 0; i < 2; ++i){
+    mEventKaons[i] = t->mEventKaons[i];
+    mEventPions[i] = t->mEventPions[i];
+  }
 }
 StMixerEvent::StMixerEvent(StThreeVectorF vtx, float b) :  mVtx(StThreeVectorF()),
-    mBField(std::numeric_limits<float>::quiet_NaN())
+    mBField(std::numeric_limits<float>::quiet_NaN()), mNAllocations(0), mNDroppedTracks(0), mNUnencodedTracks(0),
+    mFullTracks(true), mCompactTracks(false)
 {
     mVtx = vtx;
     mBField = b;
 
 }
-void StMixerEvent::addTrack(StMixerTrack t)
+void StMixerEvent::reset(StThreeVectorF const& vtx, float const b)
 {
-  mTracks.push_back(t);
+  // clear() keeps the capacity, a slot stops allocating once it has seen a large event
+  mVtx = vtx;
+  mBField = b;
+  for(int i = 0; i < 2; ++i){
+    mEventKaons[i].clear(vtx, b, mFullTracks, mCompactTracks);
+    mEventPions[i].clear(vtx, b, mFullTracks, mCompactTracks);
+  }
 }
-void StMixerEvent::addPion(int arrayId)
+void StMixerEvent::assign(StMixerEvent const& t)
 {
-  mEventPions.push_back(arrayId);
+  mVtx = t.mVtx;
+  mBField = t.mBField;
+  for(int i = 0; i < 2; ++i){
+    mEventKaons[i] = t.mEventKaons[i];
+    mEventPions[i] = t.mEventPions[i];
+  }
 }
-void StMixerEvent::addKaon(int arrayId)
+void StMixerEvent::addPion(StMixerTrack const& t, int trackId)
 {
-  mEventKaons.push_back(arrayId);
+  add(mEventPions[chargeIndex(t.charge())], t, trackId);
+}
+void StMixerEvent::addKaon(StMixerTrack const& t, int trackId)
+{
+  add(mEventKaons[chargeIndex(t.charge())], t, trackId);
+}
+void StMixerEvent::add(StMixerTrackBlock& block, StMixerTrack const& t, int trackId)
+{
+  int const nAllocations = block.add(t, trackId);
+  if(nAllocations < 0) ++mNDroppedTracks;
+  else {
+    mNAllocations += nAllocations;
+    // validation blocks keep the full track
+    if(block.hasCompact() && !block.isCompact(block.size() - 1)) ++mNUnencodedTracks;
+  }
+}
+void StMixerEvent::write(std::ostream& out) const
+{
+  float const header[4] = {mVtx.x(), mVtx.y(), mVtx.z(), mBField};
+  out.write(reinterpret_cast<char const*>(header), sizeof(header));
+  for(int i = 0; i < 2; ++i){
+    mEventPions[i].write(out);
+    mEventKaons[i].write(out);
+  }
+}
+bool StMixerEvent::read(std::istream& in)
+{
+  float header[4];
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if(!in.good()) return false;
+  reset(StThreeVectorF(header[0], header[1], header[2]), header[3]);
+  for(int i = 0; i < 2; ++i){
+    if(!mEventPions[i].read(in) || !mEventKaons[i].read(in)) return false;
+  }
+  return true;
 }
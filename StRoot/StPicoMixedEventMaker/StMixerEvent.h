@@ -2,9 +2,11 @@
 #define StMixerEvent_hh
 
 #include <vector>
+#include <iostream>
 #include "StarClassLibrary/StThreeVectorF.hh"
 
 #include "StMixerTrack.h"
+#include "StMixerTrackBlock.h"
 /* **************************************************
  *
  * Event class used for mixed event buffer, stripped down 
@@ -12,8 +14,16 @@
  * and basic track information. Currently include:
  * 1) primVtx
  * 2) B-Field
- * 3) MixerTrack array
- * 4) Arrays of indices pointing to pions and kaons in mixertrack
+ * 3) Pion and kaon track blocks split by charge, stored as
+ *    structure of arrays (see StMixerTrackBlock). A track
+ *    identified as both is stored in both blocks with the
+ *    same picoDst index.
+ *
+ * setTrackEncoding() selects full and/or compact track blocks.
+ *
+ * Events are slots of the StPicoEventMixer ring buffer: reset() 
+ * reuses the track storage of the previous event in the slot, 
+ * nAllocations() counts the times it had to grow.
  *
  * **************************************************
  *
@@ -34,38 +44,64 @@ class StMixerEvent{
   StMixerEvent(StMixerEvent *);
   StMixerEvent(StThreeVectorF, float);
   ~StMixerEvent(){;};
-  void addPion(int);
-  void addKaon(int);
-  void addTrack(StMixerTrack);
+  void reset(StThreeVectorF const&, float);
+  // applies from the next reset()
+  void setTrackEncoding(bool full, bool compact);
+  // copies vertex, field and tracks, reusing the storage of this event
+  void assign(StMixerEvent const&);
+  void addPion(StMixerTrack const&, int trackId);
+  void addKaon(StMixerTrack const&, int trackId);
   void setPos( float const, float const, float const);
   void setField( float const );
-  int getNoTracks();
-  int getNoKaons();
-  int getNoPions();
-  int pionId(int counter);
-  int kaonId(int counter);
-  StMixerTrack pionAt(int const); 
-  StMixerTrack kaonAt(int const); 
+  int getNoKaons() const;
+  int getNoPions() const;
+  int getNoKaons(int charge) const;
+  int getNoPions(int charge) const;
+  StMixerTrackBlock const& pions(int charge) const;
+  StMixerTrackBlock const& kaons(int charge) const;
   StThreeVectorF const & vertex() const;
   double const field() const;
+  int nAllocations() const;
+  // tracks the compact encoding could not store
+  int nDroppedTracks() const;
+  // tracks out of the compact encoding range kept only as full tracks, validation only
+  int nUnencodedTracks() const;
+  // bytes of the stored tracks
+  size_t nBytes() const;
+  void write(std::ostream&) const;
+  bool read(std::istream&);
  private:
   StThreeVectorF mVtx;
   float mBField;
-  std::vector <StMixerTrack  > mTracks;
-  std::vector <int  > mEventKaons;
-  std::vector <int  > mEventPions;
+  StMixerTrackBlock mEventKaons[2]; // [0] negative, [1] positive
+  StMixerTrackBlock mEventPions[2];
+  static int chargeIndex(int charge);
+  void add(StMixerTrackBlock&, StMixerTrack const&, int trackId);
+  int mNAllocations;
+  int mNDroppedTracks;
+  int mNUnencodedTracks;
+  bool mFullTracks;
+  bool mCompactTracks;
 };
+inline int StMixerEvent::chargeIndex(int charge){ return charge > 0 ? 1 : 0; }
 inline void StMixerEvent::setPos( float const vx, float const vy, float const vz){
   mVtx = StThreeVectorF(vx, vy, vz);
 }
 inline void StMixerEvent::setField( float const field ){ mBField = field; }
-inline int StMixerEvent::getNoPions(){ return mEventPions.size(); }
-inline int StMixerEvent::getNoKaons(){ return mEventKaons.size(); }
-inline int StMixerEvent::getNoTracks(){ return mTracks.size();}
-inline int StMixerEvent::pionId(int counter){ return mEventPions.at(counter); }
-inline int StMixerEvent::kaonId(int counter){ return mEventKaons.at(counter); }
-inline StMixerTrack StMixerEvent::pionAt(int const counter) { return( mTracks.at(mEventPions.at(counter)) );} 
-inline StMixerTrack StMixerEvent::kaonAt(int const counter) { return( mTracks.at(mEventKaons.at(counter)) );} 
+inline int StMixerEvent::getNoPions() const { return mEventPions[0].size() + mEventPions[1].size(); }
+inline int StMixerEvent::getNoKaons() const { return mEventKaons[0].size() + mEventKaons[1].size(); }
+inline int StMixerEvent::getNoPions(int charge) const { return mEventPions[chargeIndex(charge)].size(); }
+inline int StMixerEvent::getNoKaons(int charge) const { return mEventKaons[chargeIndex(charge)].size(); }
+inline StMixerTrackBlock const& StMixerEvent::pions(int charge) const { return mEventPions[chargeIndex(charge)]; }
+inline StMixerTrackBlock const& StMixerEvent::kaons(int charge) const { return mEventKaons[chargeIndex(charge)]; }
 inline StThreeVectorF const & StMixerEvent::vertex() const { return mVtx; }
 inline double const StMixerEvent::field() const {return mBField; }
+inline int StMixerEvent::nAllocations() const { return mNAllocations; }
+inline int StMixerEvent::nDroppedTracks() const { return mNDroppedTracks; }
+inline int StMixerEvent::nUnencodedTracks() const { return mNUnencodedTracks; }
+inline void StMixerEvent::setTrackEncoding(bool full, bool compact) { mFullTracks = full; mCompactTracks = compact; }
+inline size_t StMixerEvent::nBytes() const
+{
+  return mEventPions[0].nBytes() + mEventPions[1].nBytes() + mEventKaons[0].nBytes() + mEventKaons[1].nBytes();
+}
 #endif
@@ -1,6 +1,6 @@
 #include "StMixerHists.h"
 
-StMixerHists::StMixerHists(char* fileBaseName):
+StMixerHists::StMixerHists(char const* fileBaseName):
   mSE_Vtx(NULL), mME_Vtx(NULL), mSE_LS(NULL), mSE_US(NULL),
   mME_LS(NULL), mME_US(NULL)
 {
@@ -30,3 +30,12 @@ void StMixerHists::closeFile()
   mME_LS->Write();
   mME_US->Write();
 }
+void StMixerHists::add(StMixerHists const& h)
+{
+  mSE_Vtx->Add(h.mSE_Vtx);
+  mME_Vtx->Add(h.mME_Vtx);
+  mSE_LS->Add(h.mSE_LS);
+  mSE_US->Add(h.mSE_US);
+  mME_LS->Add(h.mME_LS);
+  mME_US->Add(h.mME_US);
+}
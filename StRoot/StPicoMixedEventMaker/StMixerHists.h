@@ -24,7 +24,7 @@
 class StMixerHists
 {
  public:
-  StMixerHists(char* fileBaseName);
+  StMixerHists(char const* fileBaseName);
   ~StMixerHists();
 
   void fillSameEvt(const StThreeVectorF& vtx);
@@ -32,6 +32,8 @@ class StMixerHists
   void fillSameEvtPair(StMixerPair const* const, int charge);
   void fillMixedEvtPair(StMixerPair const* const, int charge);
   void closeFile();
+  // sums the histograms of another category, e.g. of all pools at Finish
+  void add(StMixerHists const&);
  private:
   TH2F* mSE_Vtx;
   TH2F* mME_Vtx;
@@ -1,11 +1,9 @@
 #include <limits>
 #include <cmath>
 
-#include "StarClassLibrary/StPhysicalHelixD.hh"
-#include "StarClassLibrary/SystemOfUnits.h"
-
 #include "StMixerPair.h"
 #include "StMixerTrack.h"
+#include "StMixerTrackBlock.h"
 
 ClassImp(StMixerPair)
 
@@ -28,43 +26,68 @@ StMixerPair::StMixerPair(StMixerPair const * t) : mLorentzVector(t->mLorentzVect
 // _________________________________________________________
 StMixerPair::StMixerPair(StMixerTrack const& particle1, StMixerTrack const& particle2,
                          float p1MassHypo, float p2MassHypo,
-                         StThreeVectorF const& vtx1, StThreeVectorF const& vtx2, float const bField) :  mLorentzVector(StLorentzVectorF()), mDecayVertex(StThreeVectorF()),
+                         StThreeVectorF const& vtx1, StThreeVectorF const& vtx2) :  mLorentzVector(StLorentzVectorF()), mDecayVertex(StThreeVectorF()),
     mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
     mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
     mParticle1Mom(particle1.gMom()), mParticle2Mom(particle2.gMom()),
     mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()) {
+    makePair(particle1.origin(), particle1.gMom().unit(), particle1.gMom(), particle1.dPhiDs(),
+             particle2.origin() + (vtx1 - vtx2), particle2.gMom().unit(), particle2.gMom(), particle2.dPhiDs(),
+             p1MassHypo, p2MassHypo, vtx1);
+}
+
+// _________________________________________________________
+StMixerPair::StMixerPair(StMixerTrackBlock const& block1, int const i1, StMixerTrackBlock const& block2, int const i2,
+                         float p1MassHypo, float p2MassHypo,
+                         StThreeVectorF const& vtx1, StThreeVectorF const& vtx2, bool const compact) :  mLorentzVector(StLorentzVectorF()), mDecayVertex(StThreeVectorF()),
+    mPointingAngle(std::numeric_limits<float>::quiet_NaN()), mDecayLength(std::numeric_limits<float>::quiet_NaN()),
+    mParticle1Dca(std::numeric_limits<float>::quiet_NaN()), mParticle2Dca(std::numeric_limits<float>::quiet_NaN()),
+    mParticle1Mom(), mParticle2Mom(),
+    mDcaDaughters(std::numeric_limits<float>::max()), mCosThetaStar(std::numeric_limits<float>::quiet_NaN()) {
+    StThreeVectorF p1Origin, p1Dir, p2Origin, p2Dir;
+    float p1DPhiDs, p2DPhiDs;
+    block1.line(i1, compact, p1Origin, mParticle1Mom, p1Dir, p1DPhiDs);
+    block2.line(i2, compact, p2Origin, mParticle2Mom, p2Dir, p2DPhiDs);
+    makePair(p1Origin, p1Dir, mParticle1Mom, p1DPhiDs,
+             p2Origin + (vtx1 - vtx2), p2Dir, mParticle2Mom, p2DPhiDs,
+             p1MassHypo, p2MassHypo, vtx1);
+}
+
+// _________________________________________________________
+void StMixerPair::makePair(StThreeVectorF const& p1Origin, StThreeVectorF const& p1Dir, StThreeVectorF const& p1Mom, float const p1DPhiDs,
+                           StThreeVectorF const& p2Origin, StThreeVectorF const& p2Dir, StThreeVectorF const& p2Mom, float const p2DPhiDs,
+                           float const p1MassHypo, float const p2MassHypo, StThreeVectorF const& vtx1) {
     // -- Create pair out of 2 tracks
     //     prefixes code:
     //      p1 means particle 1
     //      p2 means particle 2
     //      pair means particle1-particle2  pair
-
-    StThreeVectorF dVtx = vtx1 -vtx2;
-
-    StPhysicalHelixD p1Helix(particle1.gMom(), particle1.origin(),bField*kilogauss, particle1.charge());
-    StPhysicalHelixD p2Helix(particle2.gMom(), particle2.origin() + dVtx, bField*kilogauss,  particle2.charge());
-
-    // -- move origins of helices to the primary vertex origin
-    p1Helix.moveOrigin(p1Helix.pathLength(vtx1));
-    p2Helix.moveOrigin(p2Helix.pathLength(vtx1));
-
-    // -- use straight lines approximation to get point of DCA of particle1-particle2 pair
-    StThreeVectorF const p1Mom = p1Helix.momentum(bField * kilogauss);
-    StThreeVectorF const p2Mom = p2Helix.momentum(bField * kilogauss);
-
-    StPhysicalHelixD const p1StraightLine(p1Mom, p1Helix.origin(), 0, particle1.charge());
-    StPhysicalHelixD const p2StraightLine(p2Mom, p2Helix.origin(), 0, particle2.charge());
-
-    pair<double, double> const ss = p1StraightLine.pathLengths(p2StraightLine);
-    StThreeVectorF const p1AtDcaToP2 = p1StraightLine.at(ss.first);
-    StThreeVectorF const p2AtDcaToP1 = p2StraightLine.at(ss.second);
+    //     origins are the DCA to vtx1, particle 2 already translated from its own event
+
+    // -- straight lines approximation to get point of DCA of particle1-particle2 pair
+    StThreeVectorF const w = p1Origin - p2Origin;
+    float const b = p1Dir.dot(p2Dir);
+    float const d = p1Dir.dot(w);
+    float const e = p2Dir.dot(w);
+    float const denom = 1. - b * b;
+
+    float s1 = 0.;
+    float s2 = e;
+    if(denom > 1e-6)
+    {
+      s1 = (b * e - d) / denom;
+      s2 = (e - b * d) / denom;
+    }
+
+    StThreeVectorF const p1AtDcaToP2 = p1Origin + s1 * p1Dir;
+    StThreeVectorF const p2AtDcaToP1 = p2Origin + s2 * p2Dir;
 
     // -- calculate DCA of particle1 to particle2 at their DCA
     mDcaDaughters = (p1AtDcaToP2 - p2AtDcaToP1).mag();
 
-    // -- calculate Lorentz vector of particle1-particle2 pair
-    StThreeVectorF const p1MomAtDca = p1Helix.momentumAt(ss.first,  bField * kilogauss);
-    StThreeVectorF const p2MomAtDca = p2Helix.momentumAt(ss.second, bField * kilogauss);
+    // -- calculate Lorentz vector of particle1-particle2 pair, momenta follow the helix
+    StThreeVectorF const p1MomAtDca = rotate(p1Mom, p1DPhiDs * s1);
+    StThreeVectorF const p2MomAtDca = rotate(p2Mom, p2DPhiDs * s2);
 
     StLorentzVectorF const p1FourMom(p1MomAtDca, p1MomAtDca.massHypothesis(p1MassHypo));
     StLorentzVectorF const p2FourMom(p2MomAtDca, p2MomAtDca.massHypothesis(p2MassHypo));
@@ -85,8 +108,13 @@ StMixerPair::StMixerPair(StMixerTrack const& particle1, StMixerTrack const& part
     mDecayLength = vtxToV0.mag();
 
     // -- calculate DCA of tracks to primary vertex
-    mParticle1Dca = (p1Helix.origin() - vtx1).mag();
-    mParticle2Dca = (p2Helix.origin() - vtx1).mag();
+    mParticle1Dca = (p1Origin - vtx1).mag();
+    mParticle2Dca = (p2Origin - vtx1).mag();
 }
 
-
+// _________________________________________________________
+StThreeVectorF StMixerPair::rotate(StThreeVectorF const& mom, float const phi) {
+    float const c = std::cos(phi);
+    float const s = std::sin(phi);
+    return StThreeVectorF(c * mom.x() - s * mom.y(), s * mom.x() + c * mom.y(), mom.z());
+}
@@ -5,7 +5,13 @@
  *  Generic class calculating and storing pairs in Event Mixing
  *  Allows to combine:
  *  - two particles, using
- *      StMixerPair(StPicoTrack const * particle1, StPicoTrack const * particle2, ...
+ *      StMixerPair(StMixerTrack const& particle1, StMixerTrack const& particle2, ...
+ *    or a track of two StMixerTrackBlock arrays
+ *
+ *  Tracks come with their straight line at the DCA to their own
+ *  event vertex, particle 2 is translated by vtx1 - vtx2. The
+ *  pair is the line-to-line DCA, the momenta are rotated by
+ *  dPhiDs * s to the DCA point.
  *
  * **************************************************
  *
@@ -23,6 +29,7 @@
 #include "StarClassLibrary/StThreeVectorF.hh"
 
 class StMixerTrack;
+class StMixerTrackBlock;
 
 class StMixerPair : public TObject
 {
@@ -32,8 +39,12 @@ class StMixerPair : public TObject
 
   StMixerPair(StMixerTrack const&  particle1, StMixerTrack const& particle2, 
 	   float p1MassHypo, float p2MassHypo,
-	   StThreeVectorF const& vtx1, StThreeVectorF const& vtx2,
-	   float bField);
+	   StThreeVectorF const& vtx1, StThreeVectorF const& vtx2);
+
+  // compact uses the compact encoding of the blocks if they have it
+  StMixerPair(StMixerTrackBlock const& block1, int i1, StMixerTrackBlock const& block2, int i2,
+	   float p1MassHypo, float p2MassHypo,
+	   StThreeVectorF const& vtx1, StThreeVectorF const& vtx2, bool compact = false);
 
   ~StMixerPair() {;}
   
@@ -62,6 +73,11 @@ class StMixerPair : public TObject
  private:
   StMixerPair(StMixerPair const &);
   StMixerPair& operator=(StMixerPair const &);
+  void makePair(StThreeVectorF const& p1Origin, StThreeVectorF const& p1Dir, StThreeVectorF const& p1Mom, float p1DPhiDs,
+		StThreeVectorF const& p2Origin, StThreeVectorF const& p2Dir, StThreeVectorF const& p2Mom, float p2DPhiDs,
+		float p1MassHypo, float p2MassHypo, StThreeVectorF const& vtx1);
+  static StThreeVectorF rotate(StThreeVectorF const& mom, float phi);
+
   StLorentzVectorF mLorentzVector; 
   StThreeVectorF   mDecayVertex; 
 
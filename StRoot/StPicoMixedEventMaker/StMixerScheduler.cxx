@@ -0,0 +1,61 @@
+#include "StMixerScheduler.h"
+#include "StPicoEventMixer.h"
+
+StMixerScheduler::StMixerScheduler(int const nThreads) : mStop(false), mNWaits(0)
+{
+  for(int i = 0; i < nThreads; ++i)
+    mWorkers.push_back(std::thread(&StMixerScheduler::work, this));
+}
+StMixerScheduler::~StMixerScheduler()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mWorkReady.notify_all();
+  for(size_t i = 0; i < mWorkers.size(); ++i) mWorkers[i].join();
+}
+void StMixerScheduler::submit(StPicoEventMixer* mixer)
+{
+  if(mWorkers.empty()){
+    mixer->mixEvents();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mBusy.insert(mixer);
+    mQueue.push_back(mixer);
+  }
+  mWorkReady.notify_one();
+}
+void StMixerScheduler::wait(StPicoEventMixer* mixer)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  if(!mBusy.count(mixer)) return;
+  ++mNWaits;
+  mWorkDone.wait(lock, [this, mixer]{ return !mBusy.count(mixer); });
+}
+void StMixerScheduler::waitAll()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  mWorkDone.wait(lock, [this]{ return mBusy.empty(); });
+}
+void StMixerScheduler::work()
+{
+  while(true){
+    StPicoEventMixer* mixer = NULL;
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      mWorkReady.wait(lock, [this]{ return mStop || !mQueue.empty(); });
+      if(mQueue.empty()) return;
+      mixer = mQueue.front();
+      mQueue.pop_front();
+    }
+    mixer->mixEvents();
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mBusy.erase(mixer);
+    }
+    mWorkDone.notify_all();
+  }
+}
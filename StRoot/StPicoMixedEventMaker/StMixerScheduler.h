@@ -0,0 +1,64 @@
+#ifndef StMixerScheduler_hh
+#define StMixerScheduler_hh
+/* **************************************************
+ *
+ * Runs StPicoEventMixer::mixEvents() of full pools on a set
+ * of worker threads while the chain keeps reading picoDsts.
+ * Pools share no state, each one is mixed by at most one
+ * worker at a time and fills only its own StMixerHists,
+ * which are booked and merged on the event thread. ROOT
+ * thread safety must be enabled before the workers start,
+ * StPicoMixedEventMaker::Init() does it.
+ * A pool must not be touched by the event thread while it
+ * is queued or being mixed, wait(pool) blocks until it is free.
+ * With zero threads submit() mixes inline.
+ *
+ * Not for the dictionary, include only in .cxx files.
+ *
+ * **************************************************
+ *
+ *  Initial Authors:  
+ *         ** Michael Lomnitz (mrlomnitz@lbl.gov)
+ *            Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <vector>
+#include <deque>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class StPicoEventMixer;
+
+class StMixerScheduler{
+ public:
+  explicit StMixerScheduler(int nThreads);
+  ~StMixerScheduler();
+  void submit(StPicoEventMixer*);
+  void wait(StPicoEventMixer*);
+  void waitAll();
+  int nThreads() const;
+  // number of times the event thread had to wait for a busy pool
+  long long nWaits() const;
+ private:
+  StMixerScheduler(StMixerScheduler const&);
+  StMixerScheduler& operator=(StMixerScheduler const&);
+  void work();
+
+  std::vector<std::thread> mWorkers;
+  std::deque<StPicoEventMixer*> mQueue;
+  std::set<StPicoEventMixer*> mBusy; // queued or being mixed
+  std::mutex mMutex;
+  std::condition_variable mWorkReady;
+  std::condition_variable mWorkDone;
+  bool mStop;
+  long long mNWaits;
+};
+inline int StMixerScheduler::nThreads() const { return mWorkers.size(); }
+inline long long StMixerScheduler::nWaits() const { return mNWaits; }
+#endif
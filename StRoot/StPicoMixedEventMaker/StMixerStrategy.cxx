@@ -0,0 +1,67 @@
+#include <algorithm>
+
+#include "StMixerStrategy.h"
+#include "StMixerCuts.h"
+#include "StPicoEventMixer.h"
+
+StMixerStrategy* StMixerStrategy::create(int const strategy, int const nMostRecent)
+{
+  switch(strategy){
+  case mxeCuts::kSymmetric:  return new StSymmetricMixing();
+  case mxeCuts::kMostRecent: return new StMostRecentMixing(nMostRecent);
+  default:                   return new StOneSidedMixing();
+  }
+}
+// _________________________________________________________
+bool StOneSidedMixing::ready(int const nEvents, int const bufferSize) const
+{
+  return nEvents == bufferSize - 1;
+}
+void StOneSidedMixing::mix(StPicoEventMixer& mixer) const
+{
+  int const nEvents = mixer.nBufferedEvents();
+  for(int iEvt = 0; iEvt < nEvents; ++iEvt)
+    mixer.mixEventPair(0, iEvt);
+  mixer.dropOldestEvent();
+}
+void StOneSidedMixing::flushOldest(StPicoEventMixer& mixer) const
+{
+  // the oldest event is mixed only when it leaves the buffer
+  mix(mixer);
+}
+// _________________________________________________________
+void StSymmetricMixing::mix(StPicoEventMixer& mixer) const
+{
+  int const nEvents = mixer.nBufferedEvents();
+  for(int iEvt = 0; iEvt < nEvents; ++iEvt)
+    mixer.mixEventPair(0, iEvt);
+  for(int iEvt = 1; iEvt < nEvents; ++iEvt)
+    mixer.mixEventPair(iEvt, 0);
+  mixer.dropOldestEvent();
+}
+// _________________________________________________________
+StMostRecentMixing::StMostRecentMixing(int const nMostRecent) : mNMostRecent(nMostRecent)
+{
+}
+bool StMostRecentMixing::ready(int const nEvents, int) const
+{
+  return nEvents > 0;
+}
+void StMostRecentMixing::mix(StPicoEventMixer& mixer) const
+{
+  // the kept events leave one slot free for the next event
+  int const nMostRecent = std::min(mNMostRecent, mixer.bufferSize() - 1);
+  int const newest = mixer.nBufferedEvents() - 1;
+
+  mixer.mixEventPair(newest, newest);
+  for(int iEvt = std::max(0, newest - nMostRecent); iEvt < newest; ++iEvt){
+    mixer.mixEventPair(newest, iEvt);
+    mixer.mixEventPair(iEvt, newest);
+  }
+  if(newest >= nMostRecent) mixer.dropOldestEvent();
+}
+void StMostRecentMixing::flushOldest(StPicoEventMixer& mixer) const
+{
+  // every event was mixed when it was added
+  mixer.dropOldestEvent();
+}
@@ -0,0 +1,73 @@
+#ifndef StMixerStrategy_hh
+#define StMixerStrategy_hh
+/* **************************************************
+ *
+ * Mixing strategies of StPicoEventMixer. A strategy decides
+ * when a pool is mixed and which buffered events are paired,
+ * with StPicoEventMixer::mixEventPair(pion event, kaon event),
+ * and drops the events it is done with.
+ *
+ * 1) kOneSided:  once the buffer is full, pions of the oldest
+ *    event with kaons of every buffered event
+ * 2) kSymmetric: as kOneSided, plus kaons of the oldest event
+ *    with pions of the other events, twice the mixed pairs
+ *    per buffered event
+ * 3) kMostRecent: every new event against the N most recent
+ *    events, in both directions
+ *
+ * Every event is paired with itself (same event) exactly once.
+ *
+ * flushOldest() makes the pairs the oldest buffered event is
+ * still owed and drops it, for pools which do not fit the buffer.
+ *
+ * **************************************************
+ *
+ *  Initial Authors:  
+ *         ** Michael Lomnitz (mrlomnitz@lbl.gov)
+ *            Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+class StPicoEventMixer;
+
+class StMixerStrategy{
+ public:
+  virtual ~StMixerStrategy(){}
+  virtual char const* name() const = 0;
+  // true if the mixer has to mix after an event was added
+  virtual bool ready(int nEvents, int bufferSize) const = 0;
+  virtual void mix(StPicoEventMixer&) const = 0;
+  virtual void flushOldest(StPicoEventMixer&) const = 0;
+
+  // strategy is one of mxeCuts::mixingStrategy
+  static StMixerStrategy* create(int strategy, int nMostRecent);
+};
+
+class StOneSidedMixing : public StMixerStrategy{
+ public:
+  virtual char const* name() const { return "one-sided"; }
+  virtual bool ready(int nEvents, int bufferSize) const;
+  virtual void mix(StPicoEventMixer&) const;
+  virtual void flushOldest(StPicoEventMixer&) const;
+};
+
+class StSymmetricMixing : public StOneSidedMixing{
+ public:
+  virtual char const* name() const { return "symmetric"; }
+  virtual void mix(StPicoEventMixer&) const;
+};
+
+class StMostRecentMixing : public StMixerStrategy{
+ public:
+  explicit StMostRecentMixing(int nMostRecent);
+  virtual char const* name() const { return "most-recent"; }
+  virtual bool ready(int nEvents, int bufferSize) const;
+  virtual void mix(StPicoEventMixer&) const;
+  virtual void flushOldest(StPicoEventMixer&) const;
+ private:
+  int mNMostRecent;
+};
+#endif
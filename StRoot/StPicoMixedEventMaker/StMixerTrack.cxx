@@ -1,14 +1,25 @@
 #include <limits>
 
+#include "StarClassLibrary/StPhysicalHelixD.hh"
+#include "StarClassLibrary/SystemOfUnits.h"
+
 #include "StMixerTrack.h"
 #include "StPicoDstMaker/StPicoTrack.h"
 
-StMixerTrack::StMixerTrack() : mOrigin(StThreeVectorF()), mMom(StThreeVectorF()), mTrackInfo(std::numeric_limits<short>::min())
+StMixerTrack::StMixerTrack() : mOrigin(StThreeVectorF()), mMom(StThreeVectorF()), mDPhiDs(0), mTrackInfo(std::numeric_limits<short>::min())
 {
 }
 StMixerTrack::StMixerTrack(StThreeVectorF const & pVtx, float B,StPicoTrack const& picoTrack, bool isTpcPi, bool isTofPi, bool isTpcK, bool isTofK) :
-    mOrigin(picoTrack.helix().origin()), mMom(picoTrack.gMom(pVtx,B)), mTrackInfo(0)
+    mOrigin(), mMom(), mDPhiDs(0), mTrackInfo(0)
 {
+    // -- the helix is propagated once, at insertion, to its DCA to the event vertex
+    StPhysicalHelixD helix = picoTrack.helix();
+    helix.moveOrigin(helix.pathLength(pVtx));
+    mOrigin = helix.origin();
+    mMom = helix.momentum(B * kilogauss);
+    // -- dphi/ds = -qB/p, 2.99792458e-4 GeV/c per kG cm
+    mDPhiDs = -picoTrack.charge() * B * 2.99792458e-4 / mMom.mag();
+
     if( picoTrack.charge() == 1 ) mTrackInfo = mTrackInfo | 1;
     //Pi
     if( isTpcPi == true ) mTrackInfo = mTrackInfo | (1 << 1);
@@ -18,7 +29,7 @@ StMixerTrack::StMixerTrack(StThreeVectorF const & pVtx, float B,StPicoTrack cons
     if( isTofK == true ) mTrackInfo = mTrackInfo | (1 << 4);
 
 }
-StMixerTrack::StMixerTrack(StMixerTrack const * t) : mOrigin(t->mOrigin), mMom(t->mMom), mTrackInfo(t->mTrackInfo)
+StMixerTrack::StMixerTrack(StMixerTrack const * t) : mOrigin(t->mOrigin), mMom(t->mMom), mDPhiDs(t->mDPhiDs), mTrackInfo(t->mTrackInfo)
 {
 }
 
@@ -8,6 +8,9 @@
  * 1) charge
  * 2) isTpcPi & isTofPi
  * 3) isTpcKaon & is TofKaon
+ * 4) origin and momentum at the DCA to the event vertex and
+ *    the rotation rate of the momentum along the helix, so
+ *    pairing needs only the straight line and a rotation
  *
  * **************************************************
  *
@@ -33,15 +36,18 @@ class StMixerTrack{
   int const charge() const ;
   StThreeVectorF const& gMom() const;
   StThreeVectorF const& origin() const;
+  float dPhiDs() const;
   ~StMixerTrack(){}
  private:
   StThreeVectorF mOrigin;
   StThreeVectorF mMom;
+  float mDPhiDs; // transverse momentum rotation per cm of path length
   short mTrackInfo;
 };
 inline short const StMixerTrack::getTrackInfo() const { return(mTrackInfo); }
 inline StThreeVectorF const & StMixerTrack::gMom() const { return(mMom) ;}
 inline StThreeVectorF const & StMixerTrack::origin() const { return(mOrigin) ;}
+inline float StMixerTrack::dPhiDs() const { return(mDPhiDs) ;}
 inline int const StMixerTrack::charge() const { 
   int temp = (mTrackInfo & 1);
   if(temp == 1) return 1;
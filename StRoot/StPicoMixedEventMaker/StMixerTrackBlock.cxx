@@ -0,0 +1,179 @@
+#include <cmath>
+#include <limits>
+
+#include "StMixerTrackBlock.h"
+
+namespace
+{
+  float const originStep = 2e-4; // cm
+  float const ptStep = 2e-4;     // GeV/c
+  float const etaStep = 1e-4;
+  float const phiStep = 2. * M_PI / 65536.;
+
+  template <class T> bool quantize(float const value, float const step, T& q)
+  {
+    float const n = std::floor(value / step + 0.5);
+    if(n < std::numeric_limits<T>::min() || n > std::numeric_limits<T>::max()) return false;
+    q = static_cast<T>(n);
+    return true;
+  }
+}
+
+StMixerTrackBlock::StMixerTrackBlock() : mVtx(), mBField(0), mFull(true), mCompact(false), mSize(0)
+{
+}
+void StMixerTrackBlock::clear(StThreeVectorF const& vtx, float const bField, bool const full, bool const compact)
+{
+  // clear() keeps the capacity
+  mVtx = vtx;
+  mBField = bField;
+  mFull = full || !compact;
+  mCompact = compact;
+  mSize = 0;
+  ox.clear(); oy.clear(); oz.clear();
+  px.clear(); py.clear(); pz.clear();
+  ux.clear(); uy.clear(); uz.clear();
+  dPhiDs.clear(); info.clear(); id.clear();
+  cdx.clear(); cdy.clear(); cdz.clear();
+  cpt.clear(); ceta.clear(); cphi.clear();
+  cinfo.clear(); cid.clear();
+}
+int StMixerTrackBlock::add(StMixerTrack const& t, int const trackId)
+{
+  short dx = 0, dy = 0, dz = 0, eta = 0;
+  unsigned short pt = 0, phi = 0;
+  bool encoded = true;
+  if(mCompact){
+    StThreeVectorF const d = t.origin() - mVtx;
+    encoded = quantize(d.x(), originStep, dx) && quantize(d.y(), originStep, dy) && quantize(d.z(), originStep, dz) &&
+              quantize(t.gMom().perp(), ptStep, pt) && quantize(t.gMom().pseudoRapidity(), etaStep, eta) &&
+              trackId <= 65535;
+    // a validation block keeps the full track
+    if(!encoded && !mFull) return -1;
+    // phi wraps around
+    if(encoded) phi = static_cast<unsigned short>(static_cast<long>(std::floor((t.gMom().phi() + M_PI) / phiStep + 0.5)) & 0xffff);
+    else dx = dy = dz = eta = pt = 0;
+  }
+
+  // all arrays grow together
+  int const nAllocations = (mFull && id.size() == id.capacity()) || (mCompact && cid.size() == cid.capacity()) ? 1 : 0;
+  if(mFull){
+    addLine(t.origin(), t.gMom(), t.gMom().unit(), t.dPhiDs(), t.getTrackInfo(), trackId);
+  }
+  if(mCompact){
+    cdx.push_back(dx); cdy.push_back(dy); cdz.push_back(dz);
+    cpt.push_back(pt); ceta.push_back(eta); cphi.push_back(phi);
+    cinfo.push_back(encoded ? t.getTrackInfo() & 0xff : kNotEncoded);
+    cid.push_back(encoded ? trackId : 0);
+  }
+  ++mSize;
+  return nAllocations;
+}
+void StMixerTrackBlock::addLine(StThreeVectorF const& origin, StThreeVectorF const& mom, StThreeVectorF const& direction,
+                                float const rate, short const trackInfo, int const trackId)
+{
+  ox.push_back(origin.x()); oy.push_back(origin.y()); oz.push_back(origin.z());
+  px.push_back(mom.x()); py.push_back(mom.y()); pz.push_back(mom.z());
+  ux.push_back(direction.x()); uy.push_back(direction.y()); uz.push_back(direction.z());
+  dPhiDs.push_back(rate);
+  info.push_back(trackInfo);
+  id.push_back(trackId);
+}
+void StMixerTrackBlock::decode(StMixerTrackBlock& lines) const
+{
+  lines.clear(mVtx, mBField, true, false);
+  StThreeVectorF origin, mom, direction;
+  float rate;
+  for(int i = 0; i < mSize; ++i){
+    line(i, true, origin, mom, direction, rate);
+    lines.addLine(origin, mom, direction, rate, trackInfo(i), trackId(i));
+  }
+  lines.mSize = mSize;
+}
+size_t StMixerTrackBlock::nBytes() const
+{
+  // the slots keep their capacity across clear(), it is not a property of the event
+  return id.size() * (10 * sizeof(float) + sizeof(short) + sizeof(int)) +
+         cid.size() * (6 * sizeof(short) + sizeof(char) + sizeof(short));
+}
+void StMixerTrackBlock::line(int const i, bool const compact, StThreeVectorF& origin, StThreeVectorF& mom,
+                             StThreeVectorF& direction, float& rate) const
+{
+  if(mFull && !(compact && isCompact(i))){
+    origin = StThreeVectorF(ox[i], oy[i], oz[i]);
+    mom = StThreeVectorF(px[i], py[i], pz[i]);
+    direction = StThreeVectorF(ux[i], uy[i], uz[i]);
+    rate = dPhiDs[i];
+    return;
+  }
+
+  origin = StThreeVectorF(mVtx.x() + cdx[i] * originStep, mVtx.y() + cdy[i] * originStep, mVtx.z() + cdz[i] * originStep);
+  float const pt = cpt[i] * ptStep;
+  float const phi = cphi[i] * phiStep - static_cast<float>(M_PI);
+  float const pzOverPt = std::sinh(ceta[i] * etaStep);
+  mom = StThreeVectorF(pt * std::cos(phi), pt * std::sin(phi), pt * pzOverPt);
+  float const p = pt * std::sqrt(1. + pzOverPt * pzOverPt);
+  direction = mom / p;
+  // -- dphi/ds = -qB/p, 2.99792458e-4 GeV/c per kG cm, the charge is bit 0 of the flags
+  rate = -((cinfo[i] & 1) ? 1 : -1) * mBField * 2.99792458e-4 / p;
+}
+StThreeVectorF StMixerTrackBlock::origin(int const i) const
+{
+  StThreeVectorF o, p, u;
+  float rate;
+  line(i, false, o, p, u, rate);
+  return o;
+}
+StThreeVectorF StMixerTrackBlock::gMom(int const i) const
+{
+  StThreeVectorF o, p, u;
+  float rate;
+  line(i, false, o, p, u, rate);
+  return p;
+}
+// _________________________________________________________
+template <class T> void StMixerTrackBlock::writeArray(std::ostream& out, std::vector<T> const& v)
+{
+  if(!v.empty()) out.write(reinterpret_cast<char const*>(&v[0]), sizeof(T) * v.size());
+}
+template <class T> void StMixerTrackBlock::readArray(std::istream& in, std::vector<T>& v, int const n)
+{
+  v.resize(n);
+  if(n) in.read(reinterpret_cast<char*>(&v[0]), sizeof(T) * n);
+}
+void StMixerTrackBlock::write(std::ostream& out) const
+{
+  int const header[3] = {mSize, mFull, mCompact};
+  out.write(reinterpret_cast<char const*>(header), sizeof(header));
+  if(mFull){
+    writeArray(out, ox); writeArray(out, oy); writeArray(out, oz);
+    writeArray(out, px); writeArray(out, py); writeArray(out, pz);
+    writeArray(out, ux); writeArray(out, uy); writeArray(out, uz);
+    writeArray(out, dPhiDs); writeArray(out, info); writeArray(out, id);
+  }
+  if(mCompact){
+    writeArray(out, cdx); writeArray(out, cdy); writeArray(out, cdz);
+    writeArray(out, cpt); writeArray(out, ceta); writeArray(out, cphi);
+    writeArray(out, cinfo); writeArray(out, cid);
+  }
+}
+bool StMixerTrackBlock::read(std::istream& in)
+{
+  // the vertex and field are set by clear() before
+  int header[3] = {0, 0, 0};
+  in.read(reinterpret_cast<char*>(header), sizeof(header));
+  if(!in.good() || header[0] < 0 || (!header[1] && !header[2])) return false;
+  mSize = header[0];
+  mFull = header[1];
+  mCompact = header[2];
+  int const nFull = mFull ? mSize : 0;
+  int const nCompact = mCompact ? mSize : 0;
+  readArray(in, ox, nFull); readArray(in, oy, nFull); readArray(in, oz, nFull);
+  readArray(in, px, nFull); readArray(in, py, nFull); readArray(in, pz, nFull);
+  readArray(in, ux, nFull); readArray(in, uy, nFull); readArray(in, uz, nFull);
+  readArray(in, dPhiDs, nFull); readArray(in, info, nFull); readArray(in, id, nFull);
+  readArray(in, cdx, nCompact); readArray(in, cdy, nCompact); readArray(in, cdz, nCompact);
+  readArray(in, cpt, nCompact); readArray(in, ceta, nCompact); readArray(in, cphi, nCompact);
+  readArray(in, cinfo, nCompact); readArray(in, cid, nCompact);
+  return in.good();
+}
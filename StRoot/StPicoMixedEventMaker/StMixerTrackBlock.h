@@ -0,0 +1,110 @@
+#ifndef StMixerTrackBlock_hh
+#define StMixerTrackBlock_hh
+/* **************************************************
+ *
+ * Structure of arrays holding the mixer tracks of one
+ * species and charge of an event. The pair loop of the
+ * event mixer streams through the contiguous arrays
+ * instead of copying StMixerTrack objects.
+ * Tracks are stored as the straight line at their DCA to
+ * the event vertex, with a unit direction and the momentum
+ * rotation rate precomputed at insertion.
+ *
+ * Compact blocks store instead, 15 bytes per track:
+ * 1) origin - event vertex, 16 bits per coordinate, 2 um steps
+ * 2) pt (0.2 MeV/c), eta (1e-4) and phi (2pi/2^16), 16 bits each
+ * 3) StMixerTrack flags in a byte, picoDst index in 16 bits
+ * and decode the line in line(). Tracks farther than 6.5 cm
+ * from the vertex in any coordinate, with pt above 13 GeV/c
+ * or |eta| above 3.2 are not stored.
+ * Blocks may keep both, to validate the compact encoding. They
+ * store every full track, isCompact() tells which ones also
+ * have a compact encoding.
+ * decode() unpacks all compact tracks at once into a full
+ * block, pair loops then read every line many times for free.
+ *
+ * **************************************************
+ *
+ *  Initial Authors:  
+ *         ** Michael Lomnitz (mrlomnitz@lbl.gov)
+ *            Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <vector>
+#include <iostream>
+#include "StarClassLibrary/StThreeVectorF.hh"
+
+#include "StMixerTrack.h"
+
+class StMixerTrackBlock{
+ public:
+  StMixerTrackBlock();
+  // compact blocks decode relative to the vertex and with the field of their event
+  void clear(StThreeVectorF const& vtx, float bField, bool full, bool compact);
+  // returns 1 if the block had to grow, -1 if the track cannot be stored
+  int  add(StMixerTrack const&, int id);
+  // full block with the decoded compact lines, reuses the storage of lines
+  void decode(StMixerTrackBlock& lines) const;
+  int  size() const;
+  // bytes of the stored tracks
+  size_t nBytes() const;
+  bool hasFull() const;
+  bool hasCompact() const;
+  // has a compact encoding, false for the tracks out of its range in validation blocks
+  bool isCompact(int i) const;
+
+  // the full line if stored and not compact requested, or if the track has no compact encoding,
+  // else the decoded compact one
+  void line(int i, bool compact, StThreeVectorF& origin, StThreeVectorF& mom,
+	    StThreeVectorF& direction, float& dPhiDs) const;
+  StThreeVectorF origin(int i) const;
+  StThreeVectorF gMom(int i) const;
+  int trackId(int i) const;
+  short trackInfo(int i) const;
+
+  // raw binary, used to carry mixer pools across jobs
+  void write(std::ostream&) const;
+  bool read(std::istream&);
+
+ private:
+  template <class T> static void writeArray(std::ostream&, std::vector<T> const&);
+  template <class T> static void readArray(std::istream&, std::vector<T>&, int n);
+  void addLine(StThreeVectorF const& origin, StThreeVectorF const& mom, StThreeVectorF const& direction,
+               float rate, short trackInfo, int trackId);
+
+  // cinfo bit of the tracks without compact encoding, StMixerTrack flags use bits 0-4
+  static unsigned char const kNotEncoded = 0x80;
+
+  StThreeVectorF mVtx;
+  float mBField;
+  bool  mFull;
+  bool  mCompact;
+  int   mSize;
+
+  // full
+  std::vector<float> ox, oy, oz; // origin, DCA to the event vertex
+  std::vector<float> px, py, pz; // momentum at the origin
+  std::vector<float> ux, uy, uz; // unit direction
+  std::vector<float> dPhiDs;     // momentum rotation per cm
+  std::vector<short> info;       // StMixerTrack bit flags
+  std::vector<int>   id;         // index of the track in the picoDst, same event pairs share it
+
+  // compact
+  std::vector<short> cdx, cdy, cdz;
+  std::vector<unsigned short> cpt;
+  std::vector<short> ceta;
+  std::vector<unsigned short> cphi;
+  std::vector<unsigned char> cinfo;
+  std::vector<unsigned short> cid;
+};
+inline int StMixerTrackBlock::size() const { return mSize; }
+inline bool StMixerTrackBlock::hasFull() const { return mFull; }
+inline bool StMixerTrackBlock::hasCompact() const { return mCompact; }
+inline bool StMixerTrackBlock::isCompact(int i) const { return mCompact && !(cinfo[i] & kNotEncoded); }
+inline int StMixerTrackBlock::trackId(int i) const { return mFull ? id[i] : cid[i]; }
+inline short StMixerTrackBlock::trackInfo(int i) const { return mFull ? info[i] : cinfo[i]; }
+#endif
@@ -0,0 +1,83 @@
+#include <cstring>
+
+#include "TError.h"
+
+#include "StMixerTrackStore.h"
+#include "StMixerEvent.h"
+
+namespace
+{
+  // store layout:
+  //   TrackStoreHeader
+  //   records: int centrality, StMixerEvent::write()
+  char const trackStoreMagic[8] = {'P','I','C','O','M','X','T','S'};
+  unsigned int const trackStoreVersion = 2;
+
+  struct TrackStoreHeader
+  {
+    char magic[8];
+    unsigned int version;
+    unsigned int reserved;
+  };
+}
+
+StMixerTrackStore::StMixerTrackStore() : mNEvents(0)
+{
+}
+StMixerTrackStore::~StMixerTrackStore()
+{
+  close();
+}
+bool StMixerTrackStore::openForWriting(char const* fileName)
+{
+  mOut.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!mOut.is_open()) {
+    Error("StMixerTrackStore", "cannot write %s", fileName);
+    return false;
+  }
+
+  TrackStoreHeader header;
+  memcpy(header.magic, trackStoreMagic, sizeof(trackStoreMagic));
+  header.version = trackStoreVersion;
+  header.reserved = 0;
+  mOut.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  mNEvents = 0;
+  return mOut.good();
+}
+bool StMixerTrackStore::openForReading(char const* fileName)
+{
+  mIn.open(fileName, std::ios::in | std::ios::binary);
+  if(!mIn.is_open()) {
+    Error("StMixerTrackStore", "cannot read %s", fileName);
+    return false;
+  }
+
+  TrackStoreHeader header;
+  mIn.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if(!mIn.good() || memcmp(header.magic, trackStoreMagic, sizeof(trackStoreMagic)) != 0 ||
+     header.version != trackStoreVersion) {
+    Error("StMixerTrackStore", "%s is not a mixer track store", fileName);
+    mIn.close();
+    return false;
+  }
+  mNEvents = 0;
+  return true;
+}
+void StMixerTrackStore::close()
+{
+  if(mOut.is_open()) mOut.close();
+  if(mIn.is_open()) mIn.close();
+}
+void StMixerTrackStore::write(int const centrality, StMixerEvent const& event)
+{
+  mOut.write(reinterpret_cast<char const*>(&centrality), sizeof(centrality));
+  event.write(mOut);
+  ++mNEvents;
+}
+bool StMixerTrackStore::read(int& centrality, StMixerEvent& event)
+{
+  mIn.read(reinterpret_cast<char*>(&centrality), sizeof(centrality));
+  if(!mIn.good() || !event.read(mIn)) return false;
+  ++mNEvents;
+  return true;
+}
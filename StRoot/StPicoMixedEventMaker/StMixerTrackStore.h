@@ -0,0 +1,46 @@
+#ifndef StMixerTrackStore_hh
+#define StMixerTrackStore_hh
+/* **************************************************
+ *
+ * Compact store of the good events of StPicoMixedEventMaker
+ * for offline mixing (see StOfflineEventMixer). Every record
+ * holds the centrality bin and the StMixerEvent: vertex, field
+ * and the pion and kaon StMixerTrackBlock arrays. The vz bin is
+ * not stored, it is recomputed from the vertex by the mixer.
+ *
+ * **************************************************
+ *
+ *  Initial Authors:  
+ *         ** Michael Lomnitz (mrlomnitz@lbl.gov)
+ *            Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <fstream>
+
+class StMixerEvent;
+
+class StMixerTrackStore{
+ public:
+  StMixerTrackStore();
+  ~StMixerTrackStore();
+  bool openForWriting(char const* fileName);
+  bool openForReading(char const* fileName);
+  void close();
+  void write(int centrality, StMixerEvent const&);
+  // false at the end of the store
+  bool read(int& centrality, StMixerEvent&);
+  long long nEvents() const;
+ private:
+  StMixerTrackStore(StMixerTrackStore const&);
+  StMixerTrackStore& operator=(StMixerTrackStore const&);
+
+  std::ofstream mOut;
+  std::ifstream mIn;
+  long long mNEvents;
+};
+inline long long StMixerTrackStore::nEvents() const { return mNEvents; }
+#endif
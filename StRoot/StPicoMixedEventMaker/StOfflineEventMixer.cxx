@@ -0,0 +1,160 @@
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "RVersion.h"
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+#include "TROOT.h"
+#else
+#include "TThread.h"
+#endif
+#include "TFile.h"
+#include "TH1.h"
+#include "TError.h"
+
+#include "StOfflineEventMixer.h"
+#include "StPicoEventMixer.h"
+#include "StMixerEvent.h"
+#include "StMixerStrategy.h"
+#include "StMixerTrackStore.h"
+#include "StMixerCategories.h"
+
+ClassImp(StOfflineEventMixer)
+
+namespace
+{
+  // ROOT object creation and file I/O of the configurations is serialized,
+  // histograms are filled outside, every configuration has its own
+  std::mutex rootMutex;
+}
+
+// _________________________________________________________
+StOfflineEventMixer::StOfflineEventMixer(char const* trackStoreFileName) : TObject(),
+  mTrackStoreFileName(trackStoreFileName)
+{
+}
+// _________________________________________________________
+StOfflineEventMixer::~StOfflineEventMixer()
+{
+  for(size_t i = 0; i < mCategories.size(); ++i) delete mCategories[i];
+}
+// _________________________________________________________
+void StOfflineEventMixer::addConfiguration(char const* name, int const bufferSize, int const strategy,
+                                           int const nMostRecent, int const nVzBins)
+{
+  mNames.push_back(name);
+  mBufferSizes.push_back(bufferSize);
+  mStrategies.push_back(strategy);
+  mNMostRecent.push_back(nMostRecent);
+  mCategories.push_back(new StMixerCategories());
+  mCategories.back()->setAxis(StMixerCategories::kVz, nVzBins, -mxeCuts::maxVz, mxeCuts::maxVz);
+}
+// _________________________________________________________
+void StOfflineEventMixer::setCategoryAxis(int const axis, int const nBins, float const min, float const max)
+{
+  if(mCategories.empty()) {
+    Error("StOfflineEventMixer", "setCategoryAxis() before addConfiguration()");
+    return;
+  }
+  if(axis != StMixerCategories::kVz && axis != StMixerCategories::kCentrality) {
+    Error("StOfflineEventMixer", "%s: category axis %i is not in the track store, only vz and centrality",
+          mNames.back().Data(), axis);
+    return;
+  }
+  mCategories.back()->setAxis(axis, nBins, min, max);
+}
+// _________________________________________________________
+int StOfflineEventMixer::run(int const nThreads)
+{
+  bool const addDirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(false);
+  int const nConfigs = mNames.size();
+
+  // -- the workers create StMixerPairs and fill histograms
+  if(nThreads > 1 && nConfigs > 1) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+    ROOT::EnableThreadSafety();
+#else
+    TThread::Initialize();
+#endif
+  }
+
+  std::vector<char> good(nConfigs, 0);
+  std::atomic<int> next(0);
+
+  // every worker picks the next configuration, the store is read once per configuration
+  auto work = [&]() {
+    for(int iConfig = next++; iConfig < nConfigs; iConfig = next++)
+      good[iConfig] = mixConfiguration(iConfig);
+  };
+
+  std::vector<std::thread> workers;
+  for(int i = 1; i < nThreads && i < nConfigs; ++i) workers.push_back(std::thread(work));
+  work();
+  for(size_t i = 0; i < workers.size(); ++i) workers[i].join();
+
+  int nFailed = 0;
+  for(int iConfig = 0; iConfig < nConfigs; ++iConfig) nFailed += !good[iConfig];
+
+  TH1::AddDirectory(addDirectory);
+  return nFailed;
+}
+// _________________________________________________________
+bool StOfflineEventMixer::mixConfiguration(int const iConfig) const
+{
+  TString const& name = mNames[iConfig];
+  StMixerCategories const& categories = *mCategories[iConfig];
+  if(mBufferSizes[iConfig] < 2) {
+    Error("StOfflineEventMixer", "%s: bad configuration", name.Data());
+    return false;
+  }
+
+  StMixerTrackStore store;
+  if(!store.openForReading(mTrackStoreFileName.Data())) return false;
+
+  int const nCategories = categories.nCategories();
+  std::vector<StPicoEventMixer*> mixers(nCategories, NULL);
+  {
+    std::lock_guard<std::mutex> lock(rootMutex);
+    for(int iCategory = 0; iCategory < nCategories; ++iCategory){
+      TString const category = TString::Format("%s_%s", name.Data(), categories.name(iCategory).Data());
+      StPicoEventMixer* mixer = new StPicoEventMixer(category.Data());
+      mixer->setEventBuffer(mBufferSizes[iConfig]);
+      mixer->setMixingStrategy(StMixerStrategy::create(mStrategies[iConfig], mNMostRecent[iConfig]));
+      mixers[iCategory] = mixer;
+    }
+  }
+
+  StMixerEvent event;
+  int centrality = -1;
+  long long nPairs = 0;
+  double mixingCpuTime = 0;
+  float values[StMixerCategories::kNAxes] = {0};
+  while(store.read(centrality, event)){
+    if(centrality < 0 || centrality > 8) continue;
+    values[StMixerCategories::kVz] = event.vertex().z();
+    values[StMixerCategories::kCentrality] = centrality;
+    int const category = categories.category(values);
+    if(category < 0) continue;
+
+    StPicoEventMixer* mixer = mixers[category];
+    if(mixer->addMixerEvent(event)) mixer->mixEvents();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(rootMutex);
+    TString const strategy = mixers[0]->strategy().name();
+    TFile outFile(TString::Format("%s.picoMEoffline.root", name.Data()), "RECREATE");
+    for(size_t i = 0; i < mixers.size(); ++i){
+      mixers[i]->finish();
+      nPairs += mixers[i]->nAcceptedMixedEventPairs();
+      mixingCpuTime += mixers[i]->mixingCpuTime();
+      delete mixers[i];
+    }
+    outFile.Close();
+    Info("StOfflineEventMixer", "%s (%s, buffer %i, %i categories): %lld events, %lld accepted mixed-event pairs, %.1f pairs per CPU s",
+         name.Data(), strategy.Data(),
+         mBufferSizes[iConfig], nCategories, store.nEvents(), nPairs, mixingCpuTime > 0 ? nPairs / mixingCpuTime : 0.);
+  }
+  return true;
+}
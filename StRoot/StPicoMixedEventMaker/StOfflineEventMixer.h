@@ -0,0 +1,69 @@
+#ifndef StOfflineEventMixer_hh
+#define StOfflineEventMixer_hh
+/* **************************************************
+ *
+ * Standalone mixer reading a StMixerTrackStore written by
+ * StPicoMixedEventMaker::setTrackStoreFile(). Every mixing
+ * configuration (buffer depth, strategy, event categories)
+ * streams the store on its own thread and writes its
+ * histograms to <name>.picoMEoffline.root. No picoDst I/O.
+ * Pair cuts are the mxeCuts of the build.
+ *
+ * The store keeps only the vertex and the centrality of the
+ * events, so only the vz and centrality axes of
+ * StMixerCategories can be set, with setCategoryAxis() after
+ * addConfiguration(). Event plane and multiplicity pools need
+ * StPicoMixedEventMaker.
+ *
+ *   StOfflineEventMixer mixer("job.picoMEstore.bin");
+ *   mixer.addConfiguration("buffer5", 5, mxeCuts::kOneSided);
+ *   mixer.addConfiguration("sym20", 20, mxeCuts::kSymmetric);
+ *   mixer.setCategoryAxis(StMixerCategories::kCentrality, 3, 0, 9);
+ *   mixer.run(2);
+ *
+ * **************************************************
+ *
+ *  Initial Authors:  
+ *         ** Michael Lomnitz (mrlomnitz@lbl.gov)
+ *            Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "TObject.h"
+#include "TString.h"
+
+class StMixerCategories;
+
+class StOfflineEventMixer : public TObject
+{
+ public:
+  StOfflineEventMixer(char const* trackStoreFileName = "");
+  ~StOfflineEventMixer();
+
+  // strategy is one of mxeCuts::mixingStrategy, vz bins span the mxeCuts::maxVz range
+  void addConfiguration(char const* name, int bufferSize, int strategy, int nMostRecent = 8, int nVzBins = 10);
+  // category axis of the last added configuration, StMixerCategories::kVz or kCentrality
+  void setCategoryAxis(int axis, int nBins, float min, float max);
+  // mixes all configurations on nThreads threads, returns the number of failed ones
+  int run(int nThreads);
+
+ private:
+  StOfflineEventMixer(StOfflineEventMixer const&);
+  StOfflineEventMixer& operator=(StOfflineEventMixer const&);
+  bool mixConfiguration(int iConfig) const;
+
+  TString mTrackStoreFileName;
+  std::vector<TString> mNames;
+  std::vector<int> mBufferSizes;
+  std::vector<int> mStrategies;
+  std::vector<int> mNMostRecent;
+  std::vector<StMixerCategories*> mCategories;
+
+  ClassDef(StOfflineEventMixer, 0)
+};
+#endif
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <fstream>
+
+#include "StPicoEventClassifier.h"
+
+#include "StPicoDstMaker/StPicoEvent.h"
+#include "StRefMultCorr/StRefMultCorr.h"
+
+ClassImp(StPicoEventClassifier)
+
+// _________________________________________________________
+StPicoEventClassifier::StPicoEventClassifier(StRefMultCorr* grefmultCorrUtil) : TObject(),
+  mGRefMultCorrUtil(grefmultCorrUtil), mBadRunListFileName(""),
+  mRunId(-1), mGoodRun(false), mEventId(-1), mGoodTrigger(false), mCentrality9(-1), mCentrality16(-1), mWeight(1.),
+  mNRuns(0), mNClassifications(0), mNCacheHits(0) {
+}
+
+// _________________________________________________________
+void StPicoEventClassifier::init() {
+  if (mBadRunListFileName.IsNull())
+    return;
+
+  ifstream runs(mBadRunListFileName.Data());
+  if (!runs.is_open())
+    runs.open(Form("picoLists/%s", mBadRunListFileName.Data()));
+  if (!runs.is_open()) {
+    Error("StPicoEventClassifier::init", "bad run list NOT found: %s, continue without bad run selection", mBadRunListFileName.Data());
+    return;
+  }
+
+  Int_t runId = 0;
+  while (runs >> runId)
+    mVecBadRunList.push_back(runId);
+  std::sort(mVecBadRunList.begin(), mVecBadRunList.end());
+}
+
+// _________________________________________________________
+void StPicoEventClassifier::initRun(StPicoEvent const* picoEvent) {
+  mRunId = picoEvent->runId();
+  ++mNRuns;
+
+  mGoodRun = !std::binary_search(mVecBadRunList.begin(), mVecBadRunList.end(), mRunId);
+
+  // -- StRefMultCorr::init searches its parameter tables for the run
+  if (mGRefMultCorrUtil)
+    mGRefMultCorrUtil->init(mRunId);
+}
+
+// _________________________________________________________
+void StPicoEventClassifier::classify(StPicoEvent const* picoEvent) {
+  if (picoEvent->runId() == mRunId && picoEvent->eventId() == mEventId) {
+    ++mNCacheHits;
+    return;
+  }
+
+  ++mNClassifications;
+  if (picoEvent->runId() != mRunId)
+    initRun(picoEvent);
+  mEventId = picoEvent->eventId();
+
+  mGoodTrigger = false;
+  for (std::vector<unsigned int>::const_iterator iter = mVecTriggerIdList.begin(); iter != mVecTriggerIdList.end(); ++iter)
+    if (picoEvent->isTrigger(*iter)) {
+      mGoodTrigger = true;
+      break;
+    }
+
+  mCentrality9 = -1;
+  mCentrality16 = -1;
+  mWeight = 1.;
+  if (mGRefMultCorrUtil) {
+    mGRefMultCorrUtil->initEvent(picoEvent->grefMult(), picoEvent->primaryVertex().z(), picoEvent->ZDCx());
+    mCentrality9 = mGRefMultCorrUtil->getCentralityBin9();
+    mCentrality16 = mGRefMultCorrUtil->getCentralityBin16();
+    mWeight = mGRefMultCorrUtil->getWeight();
+  }
+}
@@ -0,0 +1,109 @@
+#ifndef STPICOEVENTCLASSIFIER_H
+#define STPICOEVENTCLASSIFIER_H
+
+/* **************************************************
+ *  Per-run event classification cache
+ *
+ * **************************************************
+ *  Classifies an event by run quality, trigger and
+ *  grefMult centrality. The centrality calibration
+ *  (StRefMultCorr::init) and the bad-run flag are
+ *  evaluated once per run, per event only
+ *  StRefMultCorr::initEvent and the trigger lookup are
+ *  left.
+ *
+ *  Used by StPicoMixedEventMaker. Several mixed event makers
+ *  of a chain (e.g. with different categories) can share
+ *  one classifier, the classification of the current event
+ *  is cached and the makers after the first one only read
+ *  it back.
+ *
+ *  Bad runs and triggers are set with addTriggerId() and
+ *  setBadRunListFileName().
+ *
+ * **************************************************
+ *
+ *  Initial Authors:
+ *            Michael Lomnitz (mrlomnitz@lbl.gov)
+ *          **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  ** Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include <vector>
+
+#include "TObject.h"
+#include "TString.h"
+
+class StPicoEvent;
+class StRefMultCorr;
+
+class StPicoEventClassifier : public TObject
+{
+ public:
+  StPicoEventClassifier(StRefMultCorr* grefmultCorrUtil = NULL);
+  virtual ~StPicoEventClassifier() {}
+
+  // -- reads the bad run list
+  void init();
+
+  // -- classifies the event, a no-op if it is the cached one
+  void classify(StPicoEvent const* picoEvent);
+
+  // -- of the last classified event
+  bool  isGoodRun()     const;
+  bool  isGoodTrigger() const;
+  int   centrality9()   const; // -1 if not available
+  int   centrality16()  const;
+  float weight()        const;
+
+  // -- statistics
+  int       nRuns()            const;
+  long long nClassifications() const;
+  long long nCacheHits()       const;
+
+  void setBadRunListFileName(const char* fileName);
+  void addTriggerId(unsigned int triggerId);
+
+ private:
+  void initRun(StPicoEvent const* picoEvent);
+
+  StRefMultCorr* mGRefMultCorrUtil; //!
+
+  TString mBadRunListFileName;
+  std::vector<int> mVecBadRunList;
+  std::vector<unsigned int> mVecTriggerIdList;
+
+  // -- per run
+  int  mRunId;
+  bool mGoodRun;
+
+  // -- per event
+  int   mEventId;
+  bool  mGoodTrigger;
+  int   mCentrality9;
+  int   mCentrality16;
+  float mWeight;
+
+  int       mNRuns;
+  long long mNClassifications;
+  long long mNCacheHits;
+
+  ClassDef(StPicoEventClassifier, 0)
+};
+
+inline bool  StPicoEventClassifier::isGoodRun()     const { return mGoodRun; }
+inline bool  StPicoEventClassifier::isGoodTrigger() const { return mGoodTrigger; }
+inline int   StPicoEventClassifier::centrality9()   const { return mCentrality9; }
+inline int   StPicoEventClassifier::centrality16()  const { return mCentrality16; }
+inline float StPicoEventClassifier::weight()        const { return mWeight; }
+
+inline int       StPicoEventClassifier::nRuns()            const { return mNRuns; }
+inline long long StPicoEventClassifier::nClassifications() const { return mNClassifications; }
+inline long long StPicoEventClassifier::nCacheHits()       const { return mNCacheHits; }
+
+inline void StPicoEventClassifier::setBadRunListFileName(const char* fileName) { mBadRunListFileName = fileName; }
+inline void StPicoEventClassifier::addTriggerId(unsigned int triggerId) { mVecTriggerIdList.push_back(triggerId); }
+#endif
@@ -1,4 +1,7 @@
 #include <limits>
+#include <algorithm>
+#include <ctime>
+#include <cmath>
 
 #include "TTree.h"
 #include "TH2F.h"
@@ -10,102 +13,242 @@
 
 #include "StPicoMixedEventMaker.h"
 #include "StMixerEvent.h"
+#include "StMixerTrackBlock.h"
 #include "StMixerPair.h"
 #include "StMixerHists.h"
+#include "StMixerStrategy.h"
 
-StPicoEventMixer::StPicoEventMixer(char* category):
-  mEvents(NULL),mHists(NULL), mEventsBuffer(std::numeric_limits<int>::min()), filledBuffer(0)
+StPicoEventMixer::StPicoEventMixer(char const* category):
+  mEvents(),mHists(NULL), mStrategy(NULL), mEventsBuffer(std::numeric_limits<int>::min()), filledBuffer(0),
+  mFirstEvent(0), mNEventsAdded(0), mNMixedPairs(0), mNAcceptedMixedEventPairs(0), mMixCpuTime(0),
+  mCompactTracks(mxeCuts::compactTracks), mValidateCompact(false), mNValidatedPairs(0), mNMassMismatches(0),
+  mNSelectionMismatches(0), mMaxMassDifference(0)
 {
     setEventBuffer(3);
+    mStrategy = StMixerStrategy::create(mxeCuts::defaultStrategy, mxeCuts::nMostRecent);
     mHists = new StMixerHists(category);
+    mMixTimer.Reset();
 }
 StPicoEventMixer::~StPicoEventMixer()
 {
   delete mHists; 
-  for(int i =0 ; i<mEvents.size() ; i++){
-    delete mEvents.at(i);
-  }
+  delete mStrategy;
+}
+void StPicoEventMixer::setMixingStrategy(StMixerStrategy* strategy)
+{
+  delete mStrategy;
+  mStrategy = strategy;
+}
+void StPicoEventMixer::setEventBuffer(int buffer)
+{
+  mEventsBuffer = buffer;
+  StMixerEvent slot;
+  slot.setTrackEncoding(!mCompactTracks || mValidateCompact, mCompactTracks);
+  mEvents.assign(buffer, slot);
+  mFirstEvent = 0;
+  filledBuffer = 0;
+}
+void StPicoEventMixer::shrinkEventBuffer(int const buffer)
+{
+  if(buffer >= mEventsBuffer) return;
+  // oldest event first, then keep at most the events left after a mixing
+  std::rotate(mEvents.begin(), mEvents.begin() + mFirstEvent, mEvents.end());
+  mFirstEvent = 0;
+  int const nKept = std::max(0, std::min<int>(filledBuffer, buffer - 2));
+  mEvents.erase(mEvents.begin(), mEvents.begin() + (filledBuffer - nKept));
+  mEvents.resize(buffer);
+  mEventsBuffer = buffer;
+  filledBuffer = nKept;
+}
+void StPicoEventMixer::setCompactTracks(bool const compact, bool const validate)
+{
+  mCompactTracks = compact;
+  mValidateCompact = compact && validate;
+  for(size_t i = 0; i < mEvents.size(); ++i)
+    mEvents[i].setTrackEncoding(!mCompactTracks || mValidateCompact, mCompactTracks);
 }
 void StPicoEventMixer::finish() {
   mHists->closeFile();
 }
+void StPicoEventMixer::writePool(std::ostream& out) const
+{
+  int const nEvents = filledBuffer;
+  out.write(reinterpret_cast<char const*>(&nEvents), sizeof(nEvents));
+  for(int i = 0; i < nEvents; ++i) event(i).write(out);
+}
+bool StPicoEventMixer::readPool(std::istream& in, int* const nFlushed)
+{
+  int nEvents = 0;
+  in.read(reinterpret_cast<char*>(&nEvents), sizeof(nEvents));
+  if(!in.good() || nEvents < 0) return false;
+  mFirstEvent = 0;
+  filledBuffer = 0;
+  for(int i = 0; i < nEvents; ++i){
+    // the loaded events must leave room for the next one, the oldest of a deeper pool
+    // are mixed as the strategy still owes them and dropped
+    if(filledBuffer >= mEventsBuffer - 1) {
+      mStrategy->flushOldest(*this);
+      if(nFlushed) ++*nFlushed;
+    }
+    if(!event(filledBuffer).read(in)) {
+      filledBuffer = 0;
+      return false;
+    }
+    ++filledBuffer;
+  }
+  return true;
+}
+long long StPicoEventMixer::nAllocations() const
+{
+  long long n = 0;
+  for(size_t i = 0; i < mEvents.size(); ++i) n += mEvents[i].nAllocations();
+  return n;
+}
+long long StPicoEventMixer::nDroppedTracks() const
+{
+  long long n = 0;
+  for(size_t i = 0; i < mEvents.size(); ++i) n += mEvents[i].nDroppedTracks();
+  return n;
+}
+long long StPicoEventMixer::nUnencodedTracks() const
+{
+  long long n = 0;
+  for(size_t i = 0; i < mEvents.size(); ++i) n += mEvents[i].nUnencodedTracks();
+  return n;
+}
+size_t StPicoEventMixer::nBytes() const
+{
+  size_t n = 0;
+  for(size_t i = 0; i < mEvents.size(); ++i) n += mEvents[i].nBytes();
+  return n;
+}
 bool StPicoEventMixer::addPicoEvent(StPicoDst const* const picoDst)
 {
     if( !isGoodEvent(picoDst) )
         return false;
     int nTracks = picoDst->numberOfTracks();
     StThreeVectorF pVertex = picoDst->event()->primaryVertex();
-    StMixerEvent* event = new StMixerEvent(pVertex, picoDst->event()->bField());
-    bool isTpcPi = false;
-    bool isTofPi = false;
-    bool isTpcK = false;
-    bool isTofK = false;
+    // fill the first free slot in place, it becomes part of the buffer only if it has pions or kaons
+    StMixerEvent& event = this->event(filledBuffer);
+    event.reset(pVertex, picoDst->event()->bField());
     //Event.setNoTracks( nTracks );
     for( int iTrk = 0; iTrk < nTracks; ++iTrk) {
         StPicoTrack const* trk = picoDst->track(iTrk);
+        bool isTpcPi = false;
+        bool isTofPi = false;
+        bool isTpcK = false;
+        bool isTofK = false;
 	bool saveTrack = false;
         if( !isGoodTrack(trk)  || isCloseTrack(*trk,pVertex)) continue;
         if( isTpcPion(trk)) {
             isTpcPi = true;
-            event->addPion(event->getNoTracks());
 	    saveTrack = true;
         }
         if(isTpcKaon(trk)) {
             isTpcK = true;
 	    saveTrack = true;
-            event->addKaon(event->getNoTracks());
         }
 	if(saveTrack == true){
 	  StMixerTrack mTrack(pVertex, picoDst->event()->bField(), *trk, isTpcPi, isTofPi, isTpcK, isTofK);
-	  event->addTrack(mTrack);
+	  // the picoDst index identifies a track stored in both blocks
+	  if(isTpcPi) event.addPion(mTrack, iTrk);
+	  if(isTpcK) event.addKaon(mTrack, iTrk);
 	}
     }
-    if ( event->getNoPions() > 0 ||  event->getNoKaons() > 0) {
-        mEvents.push_back(event);
+    if ( event.getNoPions() > 0 ||  event.getNoKaons() > 0) {
         filledBuffer+=1;
+        ++mNEventsAdded;
     }
     else {
-        delete event;
         return false;
     }
     //Returns true if need to do mixing, false if buffer has space still
-    if ( filledBuffer == mEventsBuffer - 1 )
-        return true;
-    return false;
+    return mStrategy->ready(filledBuffer, mEventsBuffer);
+}
+bool StPicoEventMixer::addMixerEvent(StMixerEvent const& mixerEvent)
+{
+    if ( mixerEvent.getNoPions() == 0 && mixerEvent.getNoKaons() == 0 ) return false;
+    event(filledBuffer).assign(mixerEvent);
+    filledBuffer+=1;
+    ++mNEventsAdded;
+    return mStrategy->ready(filledBuffer, mEventsBuffer);
 }
 void StPicoEventMixer::mixEvents() {
-    size_t const nEvent = mEvents.size();
-    int const nTracksEvt1 = mEvents.at(0)->getNoPions();
+    mMixTimer.Start(kFALSE);
+    timespec cpu0, cpu1;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu0);
+    mStrategy->mix(*this);
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu1);
+    mMixCpuTime += (cpu1.tv_sec - cpu0.tv_sec) + 1e-9 * (cpu1.tv_nsec - cpu0.tv_nsec);
+    mMixTimer.Stop();
+}
+void StPicoEventMixer::mixEventPair(int const iPionEvt, int const iKaonEvt) {
+    StMixerEvent const& pionEvent = event(iPionEvt);
+    StMixerEvent const& kaonEvent = event(iKaonEvt);
+    bool const sameEvent = iPionEvt == iKaonEvt;
+    int const charges[2] = {-1, 1};
     //Template for D0 studies
-    for( size_t iEvt2 = 0; iEvt2 < nEvent; iEvt2++) {
-        int const nTracksEvt2 = mEvents.at(iEvt2)->getNoKaons();
-        if( iEvt2 == 0 )
-	  mHists->fillSameEvt(mEvents.at(0)->vertex());
-        else
-	  mHists->fillMixedEvt(mEvents.at(0)->vertex());
+    if( sameEvent )
+      mHists->fillSameEvt(pionEvent.vertex());
+    else
+      mHists->fillMixedEvt(pionEvent.vertex());
+    // the compact tracks are decoded once, the pair loop reads every line many times
+    if( mCompactTracks )
+      for( int const kaonCharge : charges )
+        kaonEvent.kaons(kaonCharge).decode(mDecodedKaons[kaonCharge > 0]);
+
+    for( int const pionCharge : charges ) {
+      StMixerTrackBlock const& pions = pionEvent.pions(pionCharge);
+      if( mCompactTracks ) pions.decode(mDecodedPions);
+      // with validation the histograms are filled from the full tracks
+      bool const useFull = !mCompactTracks || mValidateCompact;
+      StMixerTrackBlock const& pionLines = useFull ? pions : mDecodedPions;
+      int const nTracksEvt1 = pions.size();
+
+      for( int const kaonCharge : charges ) {
+        // like-sign combinations are skipped entirely unless requested
+        if( pionCharge == kaonCharge && !mxeCuts::likeSign ) continue;
+        int const charge = pionCharge + kaonCharge;
+        StMixerTrackBlock const& kaons = kaonEvent.kaons(kaonCharge);
+        StMixerTrackBlock const& kaonLines = useFull ? kaons : mDecodedKaons[kaonCharge > 0];
+        int const nTracksEvt2 = kaons.size();
+
         for( int iTrk2 = 0; iTrk2 < nTracksEvt2; iTrk2++) {
+          for( int iTrk1 = 0; iTrk1 < nTracksEvt1; iTrk1++) {
+	    if(sameEvent && pions.trackId(iTrk1) == kaons.trackId(iTrk2)) continue;
 
-            for( int iTrk1 = 0; iTrk1 < nTracksEvt1; iTrk1++) {
-	      if(iEvt2 == 0 ){
-		if(mEvents.at(0)->pionId(iTrk1) == mEvents.at(iEvt2)->kaonId(iTrk2) )
-		  continue;
-	      }
-	      StMixerPair pair(mEvents.at(0)->pionAt(iTrk1), mEvents.at(iEvt2)->kaonAt(iTrk2),
-                                 mxeCuts::pidMass[mxeCuts::kPion], mxeCuts::pidMass[mxeCuts::kKaon],
-                                 mEvents.at(0)->vertex(), mEvents.at(iEvt2)->vertex(),
-                                 mEvents.at(0)->field() );
-	      if(!isGoodPair(&pair) ) continue;
-	      int charge = mEvents.at(0)->pionAt(iTrk1).charge() +  mEvents.at(iEvt2)->kaonAt(iTrk2).charge();
-	      if(iEvt2 == 0)
-		mHists->fillSameEvtPair(&pair, charge );
-	      else
-		mHists->fillMixedEvtPair(&pair, charge);
-            } //second event track loop
-        } //first event track loop
-    } //loop over second events
+	    StMixerPair pair(pionLines, iTrk1, kaonLines, iTrk2,
+                             mxeCuts::pidMass[mxeCuts::kPion], mxeCuts::pidMass[mxeCuts::kKaon],
+                             pionEvent.vertex(), kaonEvent.vertex());
+	    ++mNMixedPairs;
+	    // tracks out of the compact encoding range have no compact pair to compare
+	    if(mValidateCompact && pions.isCompact(iTrk1) && kaons.isCompact(iTrk2))
+	      validatePair(pair, StMixerPair(mDecodedPions, iTrk1, mDecodedKaons[kaonCharge > 0], iTrk2,
+	                                     mxeCuts::pidMass[mxeCuts::kPion], mxeCuts::pidMass[mxeCuts::kKaon],
+	                                     pionEvent.vertex(), kaonEvent.vertex()));
+	    if(!isGoodPair(pair) ) continue;
+	    if(sameEvent)
+	      mHists->fillSameEvtPair(&pair, charge );
+	    else {
+	      mHists->fillMixedEvtPair(&pair, charge);
+	      ++mNAcceptedMixedEventPairs;
+	    }
+          } //first event track loop
+        } //second event track loop
+      } //kaon charges loop
+    } //pion charges loop
+}
+void StPicoEventMixer::validatePair(StMixerPair const& pair, StMixerPair const& compactPair) {
+    ++mNValidatedPairs;
+    float const massDifference = std::fabs(pair.m() - compactPair.m());
+    if(massDifference > mMaxMassDifference) mMaxMassDifference = massDifference;
+    if(massDifference > mxeCuts::compactMassTolerance) ++mNMassMismatches;
+    if(isGoodPair(pair) != isGoodPair(compactPair)) ++mNSelectionMismatches;
+}
+void StPicoEventMixer::dropOldestEvent() {
+    // its slot is reused
+    mFirstEvent = (mFirstEvent + 1) % mEvents.size();
     --filledBuffer;
-    delete mEvents.at(0)	;
-    mEvents.erase(mEvents.begin());
 }
 // _________________________________________________________
 bool StPicoEventMixer::isMixerPion(StMixerTrack const& track) {
@@ -127,9 +270,9 @@ bool StPicoEventMixer::isMixerKaon(StMixerTrack const& track) {
 }
 bool StPicoEventMixer::isGoodEvent(StPicoDst const * const picoDst)
 {
+    // run and trigger are checked by the maker's StPicoEventClassifier
     StPicoEvent* picoEvent = picoDst->event();
-    return (isGoodTrigger(picoEvent) &&
-            fabs(picoEvent->primaryVertex().z()) < mxeCuts::maxVz &&
+    return (fabs(picoEvent->primaryVertex().z()) < mxeCuts::maxVz &&
             fabs(picoEvent->primaryVertex().z() - picoEvent->vzVpd()) < mxeCuts::vzVpdVz);
 }
 bool StPicoEventMixer::isTpcPion(StPicoTrack const * const trk)
@@ -170,11 +313,3 @@ int StPicoEventMixer::getD0PtIndex(StMixerPair const& pair) const
      return i; 
   }
 }
-bool StPicoEventMixer::isGoodTrigger(StPicoEvent const * const mPicoEvent) const 
-{
-  for(int ii = 0; ii<mxeCuts::nTrig; ++ii){
-    if( mPicoEvent->isTrigger(mxeCuts::mTriggerId[ii]) )
-      return true;
-  }
-  return false;
-}
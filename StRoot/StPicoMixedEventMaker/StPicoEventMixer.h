@@ -8,6 +8,17 @@
  * Template provided used for D0 reconstruction, user should personalize 
  * mixEvent() method to cosntruct desired background.
  *
+ * The buffer is a ring of preallocated StMixerEvent slots, the oldest
+ * event is dropped by moving the ring start and its slot is reused by
+ * the next event. Steady state mixing does not allocate.
+ * mixEvents() may run on a worker thread (see StMixerScheduler), it
+ * touches only this mixer and its own StMixerHists.
+ * When to mix and which buffered events are paired is decided by the
+ * StMixerStrategy, see setMixingStrategy().
+ * setCompactTracks() buffers quantized tracks, deeper buffers fit in
+ * the same memory. With validation both encodings are kept, histograms
+ * are filled from the full tracks and the pairs are compared.
+ *
  * **************************************************
  * 
  * Initial Authors:
@@ -20,9 +31,12 @@
  */
 
 #include <vector>
+#include <iostream>
 
+#include "TStopwatch.h"
 #include "StarClassLibrary/StThreeVectorF.hh"
 #include "StMixerCuts.h"
+#include "StMixerEvent.h"
 
 class TTree;
 class TH2F;
@@ -30,19 +44,34 @@ class StPicoEvent;
 class StPicoTrack;
 class StPicoDst;
 class StMixerTrack;
-class StMixerEvent;
 class StMixerPair;
 class StMixerHists;
+class StMixerStrategy;
 
 class StPicoEventMixer {
  public: 
-  StPicoEventMixer(char* category);
+  StPicoEventMixer(char const* category);
   ~StPicoEventMixer();
   bool addPicoEvent(StPicoDst const* picoDst);
+  // an event which already passed the selection, e.g. read from a StMixerTrackStore
+  bool addMixerEvent(StMixerEvent const&);
+  // the last added event
+  StMixerEvent const& newestEvent() const;
+  // allocates the buffer slots, call before adding events
   void setEventBuffer(int buffer);
+  // fewer slots, drops the oldest buffered events which do not fit
+  void shrinkEventBuffer(int buffer);
+  // takes ownership of the strategy
+  void setMixingStrategy(StMixerStrategy*);
+  // call before adding events
+  void setCompactTracks(bool compact, bool validate = false);
   void mixEvents();
+  // used by the strategies, events are counted from the oldest
+  void mixEventPair(int iPionEvt, int iKaonEvt);
+  void dropOldestEvent();
+  int nBufferedEvents() const;
+  int bufferSize() const;
   bool isGoodEvent(StPicoDst const * const picoDst);
-  bool isGoodTrigger(StPicoEvent const * const) const;
   bool isGoodTrack(StPicoTrack const * const trk);
   bool isCloseTrack(StPicoTrack const& trk, StThreeVectorF const& pVtx);
   bool isTpcPion(StPicoTrack const * const);
@@ -50,19 +79,75 @@ class StPicoEventMixer {
   bool isGoodPair(StMixerPair const& pair);
   int getD0PtIndex(StMixerPair const& pair) const;
   void finish();
+  // buffered events not yet mixed, carried over to the next job. The oldest events of a pool
+  // deeper than the buffer are flushed by the strategy, nFlushed counts them
+  void writePool(std::ostream&) const;
+  bool readPool(std::istream&, int* nFlushed = NULL);
+
+  // statistics
+  long long nEventsAdded() const;
+  long long nAllocations() const;
+  size_t nBytes() const;
+  long long nMixedPairs() const;
+  long long nAcceptedMixedEventPairs() const;
+  double mixingTime() const;
+  double mixingCpuTime() const;
+  long long nDroppedTracks() const;
+  long long nUnencodedTracks() const;
+  // validation of the compact encoding
+  long long nValidatedPairs() const;
+  long long nMassMismatches() const;
+  long long nSelectionMismatches() const;
+  float maxMassDifference() const;
+  StMixerStrategy const& strategy() const;
+  StMixerHists const& hists() const;
  private:
   bool isMixerPion(StMixerTrack const&);
   bool isMixerKaon(StMixerTrack const&);
+  StMixerEvent& event(int i);
+  StMixerEvent const& event(int i) const;
+  void validatePair(StMixerPair const& pair, StMixerPair const& compactPair);
   
-  std::vector <StMixerEvent*> mEvents; 
+  std::vector <StMixerEvent> mEvents; // ring buffer slots
   StMixerHists* mHists;
+  StMixerStrategy* mStrategy;
   unsigned short int mEventsBuffer; 
   unsigned short int filledBuffer;
+  unsigned short int mFirstEvent; // slot of the oldest event
+  long long mNEventsAdded;
+  long long mNMixedPairs;
+  long long mNAcceptedMixedEventPairs;
+  mutable TStopwatch mMixTimer; // TStopwatch::RealTime() is not const
+  double mMixCpuTime; // of the mixing thread
+  bool mCompactTracks;
+  bool mValidateCompact;
+  long long mNValidatedPairs;
+  long long mNMassMismatches;
+  long long mNSelectionMismatches;
+  float mMaxMassDifference;
+  // compact tracks of the events being mixed, decoded once per mixEventPair()
+  StMixerTrackBlock mDecodedPions;
+  StMixerTrackBlock mDecodedKaons[2];
   float dca1, dca2, dcaDaughters, theta_hs, decayL_hs;
   float pt_hs, mass_hs, eta_hs, phi_hs;
 };
 
-inline void StPicoEventMixer::setEventBuffer(int buffer){ mEventsBuffer = buffer;}
+inline StMixerEvent& StPicoEventMixer::event(int i){ return mEvents[(mFirstEvent + i) % mEvents.size()]; }
+inline StMixerEvent const& StPicoEventMixer::event(int i) const { return mEvents[(mFirstEvent + i) % mEvents.size()]; }
+inline long long StPicoEventMixer::nEventsAdded() const { return mNEventsAdded; }
+inline long long StPicoEventMixer::nMixedPairs() const { return mNMixedPairs; }
+inline long long StPicoEventMixer::nAcceptedMixedEventPairs() const { return mNAcceptedMixedEventPairs; }
+inline double StPicoEventMixer::mixingTime() const { return mMixTimer.RealTime(); }
+inline double StPicoEventMixer::mixingCpuTime() const { return mMixCpuTime; }
+inline StMixerStrategy const& StPicoEventMixer::strategy() const { return *mStrategy; }
+inline long long StPicoEventMixer::nValidatedPairs() const { return mNValidatedPairs; }
+inline long long StPicoEventMixer::nMassMismatches() const { return mNMassMismatches; }
+inline long long StPicoEventMixer::nSelectionMismatches() const { return mNSelectionMismatches; }
+inline float StPicoEventMixer::maxMassDifference() const { return mMaxMassDifference; }
+inline StMixerEvent const& StPicoEventMixer::newestEvent() const { return event(filledBuffer - 1); }
+inline int StPicoEventMixer::nBufferedEvents() const { return filledBuffer; }
+inline int StPicoEventMixer::bufferSize() const { return mEventsBuffer; }
+inline StMixerHists const& StPicoEventMixer::hists() const { return *mHists; }
 			    
     
 #endif
@@ -2,6 +2,12 @@
 #include "TFile.h"
 #include "TChain.h"
 #include "TH1.h"
+#include "RVersion.h"
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+#include "TROOT.h"
+#else
+#include "TThread.h"
+#endif
 
 
 #include "StarClassLibrary/StThreeVectorF.hh"
@@ -12,17 +18,50 @@
 #include "StPicoDstMaker/StPicoBTofPidTraits.h"
 #include "StPicoMixedEventMaker.h"
 #include "StPicoEventMixer.h"
+#include "StMixerScheduler.h"
+#include "StMixerHists.h"
+#include "StMixerStrategy.h"
+#include "StMixerTrackStore.h"
+#include "StMixerCategories.h"
+#include "StMixerEvent.h"
 #include "StRoot/StRefMultCorr/StRefMultCorr.h"
+#include "StPicoEventClassifier.h"
 
 #include <vector>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 
 ClassImp(StPicoMixedEventMaker)
 
+namespace
+{
+  // pool state layout:
+  //   PoolStateHeader
+  //   per created pool: int category, int nEvents, nEvents x StMixerEvent::write()
+  //   int -1
+  char const poolStateMagic[8] = {'P','I','C','O','M','X','P','L'};
+  unsigned int const poolStateVersion = 3;
+
+  struct PoolStateHeader
+  {
+    char magic[8];
+    unsigned int version;
+    unsigned int nCategories;
+    unsigned int reserved;
+  };
+}
+
 // _________________________________________________________
 StPicoMixedEventMaker::StPicoMixedEventMaker(char const* name, StPicoDstMaker* picoMaker, StRefMultCorr* grefmultCorrUtil,
         char const* outputBaseFileName,  char const* inputHFListHFtree = "") :
     StMaker(name), mPicoDst(NULL), mPicoDstMaker(picoMaker),  mPicoEvent(NULL),
-    mGRefMultCorrUtil(grefmultCorrUtil),
+    mGRefMultCorrUtil(grefmultCorrUtil), mClassifier(NULL), mOwnClassifier(false),
+    mCategories(new StMixerCategories()), mPicoEventMixers(NULL), mNCategories(0), mNPools(0),
+    mMemoryBudget(0), mEventBytes(0), mNEventsMeasured(0), mScheduler(NULL), mTrackStore(NULL), mNMixingThreads(1),
+    mMixingStrategy(mxeCuts::defaultStrategy), mNMostRecent(mxeCuts::nMostRecent),
+    mCompactTracks(mxeCuts::compactTracks), mValidateCompactTracks(false),
     mOuputFileBaseName(outputBaseFileName), mInputFileName(inputHFListHFtree),
     mEventCounter(0), mTree(NULL), mOutputFileTree(NULL) {
 
@@ -38,12 +77,15 @@ StPicoMixedEventMaker::StPicoMixedEventMaker(char const* name, StPicoDstMaker* p
 // _________________________________________________________
 StPicoMixedEventMaker::~StPicoMixedEventMaker() {
 
+  // joins the workers before the pools go away
+  delete mScheduler;
+  delete mTrackStore;
+  if(mOwnClassifier) delete mClassifier;
   delete mGRefMultCorrUtil;
-  for(int iVz =0 ; iVz < 10 ; ++iVz){
-    for(int iCentrality = 0 ; iCentrality < 9 ; ++iCentrality){
-      delete mPicoEventMixer[iVz][iCentrality];
-    }
-  }
+  for(int iCategory = 0 ; iCategory < mNCategories ; ++iCategory)
+    delete mPicoEventMixers[iCategory];
+  delete [] mPicoEventMixers;
+  delete mCategories;
   mOutputFileTree->Close();
 }
 // _________________________________________________________
@@ -52,15 +94,100 @@ bool StPicoMixedEventMaker::loadEventPlaneCorr(Int_t const run) {
     return false;
 }
 // _________________________________________________________
+bool StPicoMixedEventMaker::loadPools(TString const& fileName) {
+    std::ifstream in(fileName.Data(), std::ios::in | std::ios::binary);
+    if(!in.is_open()) {
+      LOG_WARN << "StPicoMixedEventMaker - no pool state " << fileName << ", starting with empty pools" << endm;
+      return false;
+    }
+
+    PoolStateHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if(!in.good() || memcmp(header.magic, poolStateMagic, sizeof(poolStateMagic)) != 0 ||
+       header.version != poolStateVersion || (int)header.nCategories != mNCategories) {
+      LOG_ERROR << "StPicoMixedEventMaker - incompatible pool state " << fileName << ", starting with empty pools" << endm;
+      return false;
+    }
+
+    int nEvents = 0;
+    int nFlushed = 0;
+    int category = -1;
+    in.read(reinterpret_cast<char*>(&category), sizeof(category));
+    while(in.good() && category >= 0) {
+      if(category >= mNCategories || !pool(category)->readPool(in, &nFlushed)) {
+	LOG_ERROR << "StPicoMixedEventMaker - corrupt pool state " << fileName << ", starting with empty pools" << endm;
+	for(int iCategory = 0 ; iCategory < mNCategories ; ++iCategory)
+	  if(mPicoEventMixers[iCategory]) mPicoEventMixers[iCategory]->setEventBuffer(mPicoEventMixers[iCategory]->bufferSize());
+	return false;
+      }
+      nEvents += mPicoEventMixers[category]->nBufferedEvents();
+      in.read(reinterpret_cast<char*>(&category), sizeof(category));
+    }
+    LOG_INFO << "StPicoMixedEventMaker - loaded " << nEvents << " buffered events in " << mNPools << " pools from " << fileName << endm;
+    if(nFlushed)
+      LOG_WARN << "StPicoMixedEventMaker - " << nFlushed << " events of pools deeper than the buffer were mixed and dropped on loading" << endm;
+    return true;
+}
+// _________________________________________________________
+bool StPicoMixedEventMaker::savePools(TString const& fileName) const {
+    std::ofstream out(fileName.Data(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!out.is_open()) {
+      LOG_ERROR << "StPicoMixedEventMaker - cannot write pool state " << fileName << endm;
+      return false;
+    }
+
+    PoolStateHeader header;
+    memcpy(header.magic, poolStateMagic, sizeof(poolStateMagic));
+    header.version = poolStateVersion;
+    header.nCategories = mNCategories;
+    header.reserved = 0;
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+    int nEvents = 0;
+    for(int iCategory = 0 ; iCategory < mNCategories ; ++iCategory){
+      if(!mPicoEventMixers[iCategory]) continue;
+      out.write(reinterpret_cast<char const*>(&iCategory), sizeof(iCategory));
+      mPicoEventMixers[iCategory]->writePool(out);
+      nEvents += mPicoEventMixers[iCategory]->nBufferedEvents();
+    }
+    int const end = -1;
+    out.write(reinterpret_cast<char const*>(&end), sizeof(end));
+    out.close();
+    LOG_INFO << "StPicoMixedEventMaker - saved " << nEvents << " buffered events to " << fileName << endm;
+    return !out.fail();
+}
+// _________________________________________________________
 Int_t StPicoMixedEventMaker::Init() {
     mOutputFileTree->cd();
-    for(int iVz =0 ; iVz < 10 ; ++iVz){
-      for(int iCentrality = 0 ; iCentrality < 9 ; ++iCentrality){
-	mPicoEventMixer[iVz][iCentrality] = new StPicoEventMixer(Form("Cent_%i_Vz_%i",iCentrality,iVz));
-	mPicoEventMixer[iVz][iCentrality]->setEventBuffer(10);
-      }
+    mNCategories = mCategories->nCategories();
+    mPicoEventMixers = new StPicoEventMixer*[mNCategories]();
+    LOG_INFO << "StPicoMixedEventMaker - " << mNCategories << " mixing categories, memory budget "
+	     << mMemoryBudget << " MB" << endm;
+    if(!mPoolStateInput.IsNull()) loadPools(mPoolStateInput);
+    if(!mTrackStoreFileName.IsNull()) {
+      mTrackStore = new StMixerTrackStore();
+      if(!mTrackStore->openForWriting(mTrackStoreFileName.Data())) return kStErr;
     }
     mGRefMultCorrUtil = new StRefMultCorr("grefmult");
+    if(!mClassifier) {
+      mClassifier = new StPicoEventClassifier(mGRefMultCorrUtil);
+      for(int ii = 0; ii < mxeCuts::nTrig; ++ii)
+	mClassifier->addTriggerId(mxeCuts::mTriggerId[ii]);
+      mClassifier->init();
+      mOwnClassifier = true;
+    }
+    // -- the workers create StMixerPairs and fill the pool histograms, ROOT must know about the threads
+    // -- before they start. Histograms are booked in pool() and merged in Finish() on this thread.
+    int const nWorkers = std::max(0, mNMixingThreads - 1);
+    if(nWorkers > 0) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+      ROOT::EnableThreadSafety();
+#else
+      TThread::Initialize();
+#endif
+    }
+    mScheduler = new StMixerScheduler(nWorkers);
+    LOG_INFO << "StPicoMixedEventMaker - mixing on " << nWorkers << " worker threads" << endm;
     // if(!LoadEventPlaneCorr(mRunId)){
     // LOG_WARN << "Event plane calculations unavalable! Skipping"<<endm;
     // return kStOk;
@@ -74,13 +201,69 @@ Int_t StPicoMixedEventMaker::Init() {
 
 // _________________________________________________________
 Int_t StPicoMixedEventMaker::Finish() {
+    mScheduler->waitAll();
+    if(!mPoolStateOutput.IsNull()) savePools(mPoolStateOutput);
+    if(mTrackStore) {
+      mTrackStore->close();
+      LOG_INFO << "StPicoMixedEventMaker - stored " << mTrackStore->nEvents() << " events in " << mTrackStoreFileName << endm;
+    }
     mOutputFileTree->cd();
-    for(int iVz =0 ; iVz < 10 ; ++iVz){
-      for(int iCentrality = 0 ; iCentrality < 9 ; ++iCentrality){
-	mPicoEventMixer[iVz][iCentrality]->finish();
-	//delete mPicoEventMixer[iVz][iCentrality];
-      }
+    StMixerHists allHists("All");
+    long long nEvents = 0;
+    long long nAllocations = 0;
+    long long nPairs = 0;
+    long long nAcceptedMixedEventPairs = 0;
+    double mixingTime = 0;
+    double mixingCpuTime = 0;
+    size_t nBytes = 0;
+    long long nDroppedTracks = 0;
+    long long nUnencodedTracks = 0;
+    long long nValidatedPairs = 0;
+    long long nMassMismatches = 0;
+    long long nSelectionMismatches = 0;
+    float maxMassDifference = 0;
+    StPicoEventMixer const* anyPool = NULL;
+    for(int iCategory = 0 ; iCategory < mNCategories ; ++iCategory){
+      StPicoEventMixer* const mixer = mPicoEventMixers[iCategory];
+      if(!mixer) continue;
+      anyPool = mixer;
+      mixer->finish();
+      allHists.add(mixer->hists());
+      nEvents += mixer->nEventsAdded();
+      nAllocations += mixer->nAllocations();
+      nPairs += mixer->nMixedPairs();
+      mixingTime += mixer->mixingTime();
+      nAcceptedMixedEventPairs += mixer->nAcceptedMixedEventPairs();
+      mixingCpuTime += mixer->mixingCpuTime();
+      nBytes += mixer->nBytes();
+      nDroppedTracks += mixer->nDroppedTracks();
+      nUnencodedTracks += mixer->nUnencodedTracks();
+      nValidatedPairs += mixer->nValidatedPairs();
+      nMassMismatches += mixer->nMassMismatches();
+      nSelectionMismatches += mixer->nSelectionMismatches();
+      maxMassDifference = std::max(maxMassDifference, mixer->maxMassDifference());
     }
+    allHists.closeFile();
+    LOG_INFO << "StPicoMixedEventMaker - buffered " << nEvents << " events, "
+	     << (nEvents ? (double)nAllocations/nEvents : 0.) << " allocations per event, "
+	     << nPairs << " pairs mixed in " << mixingTime << " s ("
+	     << (mixingTime > 0 ? nPairs/mixingTime : 0.) << " pairs/s), "
+	     << mScheduler->nWaits() << " waits for busy pools" << endm;
+    LOG_INFO << "StPicoMixedEventMaker - " << mNPools << " of " << mNCategories << " pools used, "
+	     << nBytes / 1024. / 1024. << " MB of buffered tracks" << endm;
+    LOG_INFO << "StPicoMixedEventMaker - " << mClassifier->nRuns() << " runs, " << mClassifier->nClassifications()
+	     << " events classified, " << mClassifier->nCacheHits() << " classifications reused" << endm;
+    if(mCompactTracks)
+      LOG_INFO << "StPicoMixedEventMaker - compact tracks: " << nDroppedTracks << " tracks out of the encoding range dropped, "
+	     << nUnencodedTracks << " kept as full tracks only by the validation" << endm;
+    if(nValidatedPairs)
+      LOG_INFO << "StPicoMixedEventMaker - compact track validation: " << nValidatedPairs << " pairs, "
+	     << nMassMismatches << " with |dm| > " << mxeCuts::compactMassTolerance << " GeV, max |dm| "
+	     << maxMassDifference << " GeV, " << nSelectionMismatches << " pair selection mismatches" << endm;
+    if(anyPool)
+      LOG_INFO << "StPicoMixedEventMaker - " << anyPool->strategy().name() << " mixing: "
+	     << nAcceptedMixedEventPairs << " accepted mixed-event pairs in " << mixingCpuTime << " CPU s ("
+	     << (mixingCpuTime > 0 ? nAcceptedMixedEventPairs/mixingCpuTime : 0.) << " pairs per CPU s)" << endm;
     return kStOK;
 }
 // _________________________________________________________
@@ -99,19 +282,15 @@ Int_t StPicoMixedEventMaker::Make() {
         LOG_WARN << "No picoDst ! Skipping! "<<endm;
         return kStWarn;
     }
-    // - GRefMultiplicty
-    if(!mGRefMultCorrUtil) {
-        LOG_WARN << " No mGRefMultCorrUtil! Skip! " << endl;
-        return kStWarn;
-    }
+    // - run, trigger and GRefMultiplicty centrality, cached per run and shared with the chain
+    mClassifier->classify(picoDst->event());
+    if(!mClassifier->isGoodRun() || !mClassifier->isGoodTrigger())
+      return kStOk;
     StThreeVectorF const pVtx = picoDst->event()->primaryVertex();
-    if( fabs(pVtx.z()) >=6.0 )
+    if( fabs(pVtx.z()) >= mxeCuts::maxVz )
       return kStOk;
-    mGRefMultCorrUtil->init(picoDst->event()->runId());
-    mGRefMultCorrUtil->initEvent(picoDst->event()->grefMult(),pVtx.z(),picoDst->event()->ZDCx()) ;
-    int const centrality  = mGRefMultCorrUtil->getCentralityBin9();
+    int const centrality  = mClassifier->centrality9();
     if(centrality < 0 || centrality >8 ) return kStOk;
-    int const vz_bin = (int)((6 +pVtx.z())/1.2) ;
     //     Bin       Centrality (16)   Centrality (9)
     //     -1           80-100%           80-100% // this one should be rejected in your centrality related analysis
     //     0            75-80%            70-80%
@@ -123,9 +302,22 @@ Int_t StPicoMixedEventMaker::Make() {
     //     6            45-50%            10-20%
     //     7            40-45%             5-10%
     //     8            35-40%             0- 5%
+    int const category = categorize(picoDst, centrality);
+    if(category < 0) return kStOk;
 
-    if( mPicoEventMixer[vz_bin][centrality] -> addPicoEvent(picoDst) ==  true )
-      mPicoEventMixer[vz_bin][centrality]->mixEvents();
+    // the pool may still be mixing its previous buffer on a worker thread
+    StPicoEventMixer* const mixer = pool(category);
+    mScheduler->wait(mixer);
+    long long const nEventsAdded = mixer->nEventsAdded();
+    bool const mix = mixer->addPicoEvent(picoDst);
+    if( mixer->nEventsAdded() > nEventsAdded ) {
+      mEventBytes += mixer->newestEvent().nBytes();
+      ++mNEventsMeasured;
+      if( mTrackStore )
+	mTrackStore->write(centrality, mixer->newestEvent());
+    }
+    if( mix )
+      mScheduler->submit(mixer);
 
     return kStOk;
 }
@@ -134,9 +326,68 @@ Int_t StPicoMixedEventMaker::SetCategories() {
     return kStOk;
 }
 // _________________________________________________________
-int StPicoMixedEventMaker::categorize(StPicoDst const * picoDst ) {
-    StThreeVectorF pVertex = (picoDst->event())->primaryVertex();
-    if( fabs(pVertex.z())>6.0 ) return -99;
-    int bin = -6.0 + (pVertex.z()+6.0)/1.2;
-    return bin;
+void StPicoMixedEventMaker::setCategoryAxis(int const axis, int const nBins, float const min, float const max) {
+    if(axis < 0 || axis >= StMixerCategories::kNAxes) {
+      LOG_ERROR << "StPicoMixedEventMaker - no category axis " << axis << endm;
+      return;
+    }
+    mCategories->setAxis(axis, nBins, min, max);
+}
+// _________________________________________________________
+int StPicoMixedEventMaker::categorize(StPicoDst const * picoDst, int const centrality) {
+    float values[StMixerCategories::kNAxes];
+    values[StMixerCategories::kVz] = picoDst->event()->primaryVertex().z();
+    values[StMixerCategories::kCentrality] = centrality;
+    values[StMixerCategories::kEventPlane] = mCategories->usesAxis(StMixerCategories::kEventPlane) ? eventPlane(picoDst) : 0;
+    values[StMixerCategories::kMultiplicity] = picoDst->event()->grefMult();
+    return mCategories->category(values);
+}
+// _________________________________________________________
+float StPicoMixedEventMaker::eventPlane(StPicoDst const * picoDst) const {
+    // uncorrected second order event plane in [0, pi) from the primary tracks
+    float qx = 0;
+    float qy = 0;
+    int const nTracks = picoDst->numberOfTracks();
+    for(int iTrk = 0; iTrk < nTracks; ++iTrk) {
+      StThreeVectorF const mom = picoDst->track(iTrk)->pMom();
+      float const pt = mom.perp();
+      if(pt < 0.15 || pt > 2. || fabs(mom.pseudoRapidity()) > 1.) continue;
+      qx += pt * cos(2. * mom.phi());
+      qy += pt * sin(2. * mom.phi());
+    }
+    float psi = 0.5 * atan2(qy, qx);
+    if(psi < 0) psi += M_PI;
+    return psi;
+}
+// _________________________________________________________
+int StPicoMixedEventMaker::bufferDepth() const {
+    if(mMemoryBudget <= 0) return mxeCuts::eventBuffer;
+
+    double const eventBytes = mNEventsMeasured ? mEventBytes / mNEventsMeasured : mxeCuts::eventBytesEstimate;
+    int const depth = (int)(mMemoryBudget * 1024. * 1024. / (std::max(mNPools, 1) * eventBytes));
+    return std::max(mxeCuts::minEventBuffer, std::min(mxeCuts::eventBuffer, depth));
+}
+// _________________________________________________________
+StPicoEventMixer* StPicoMixedEventMaker::pool(int const category) {
+    if(!mPicoEventMixers[category]) {
+      ++mNPools;
+      int const depth = bufferDepth();
+      if(mMemoryBudget > 0) shrinkPools(depth);
+      StPicoEventMixer* const mixer = new StPicoEventMixer(mCategories->name(category).Data());
+      mixer->setCompactTracks(mCompactTracks, mValidateCompactTracks);
+      mixer->setEventBuffer(depth);
+      mixer->setMixingStrategy(StMixerStrategy::create(mMixingStrategy, mNMostRecent));
+      mPicoEventMixers[category] = mixer;
+    }
+    return mPicoEventMixers[category];
+}
+// _________________________________________________________
+void StPicoMixedEventMaker::shrinkPools(int const depth) {
+    // -- the budget is shared by the live pools, deeper ones are cut to the new depth
+    for(int iCategory = 0 ; iCategory < mNCategories ; ++iCategory){
+      StPicoEventMixer* const mixer = mPicoEventMixers[iCategory];
+      if(!mixer || mixer->bufferSize() <= depth) continue;
+      if(mScheduler) mScheduler->wait(mixer);
+      mixer->shrinkEventBuffer(depth);
+    }
 }
@@ -8,7 +8,25 @@
  *  Base class for Mixed Event cosntructions
  *  Template implemented for D0 recosntruction. User should use a 
  *  Mixer per category in Event Mixing and define event buffer size (10 by default).
+ *  Categories are set with setCategoryAxis() (StMixerCategories: vz,
+ *  centrality, event plane, multiplicity), a pool is created when its
+ *  category sees its first event. With setMemoryBudget() the buffer
+ *  depth is sized so the pools created so far fit the budget, older
+ *  pools give up their oldest events when a new pool needs room.
  *  For different decays changes must be made to StPicoEventMixer class
+ *  Full buffers are mixed inline in Make() by default. With
+ *  setMixingThreads(n > 1) they are mixed on n - 1 worker threads
+ *  while the chain keeps reading.
+ *  Buffered events which were not mixed yet can be written to a pool
+ *  state file at Finish() and loaded by the next job of the same run
+ *  range at Init(), see setPoolStateFiles().
+ *  setTrackStoreFile() additionally writes every buffered event to a
+ *  StMixerTrackStore for offline mixing with StOfflineEventMixer.
+ *  Run quality, trigger and centrality come from a StPicoEventClassifier,
+ *  which caches the per-run calibration and can be shared with the
+ *  other StPicoMixedEventMakers of the chain, see setEventClassifier().
+ *  setCompactTracks() buffers quantized tracks (see StMixerTrackBlock),
+ *  with a memory budget the pools get deeper.
  * 
  *
  * **************************************************
@@ -32,8 +50,12 @@ class StPicoDstMaker;
 class StPicoEvent;
 class StPicoTrack;
 class StRefMultCorr;
+class StPicoEventClassifier;
 
 class StPicoEventMixer;
+class StMixerScheduler;
+class StMixerTrackStore;
+class StMixerCategories;
 
 class StPicoMixedEventMaker : public StMaker 
 {
@@ -48,26 +70,74 @@ class StPicoMixedEventMaker : public StMaker
     virtual void  Clear(Option_t* opt="");
 
     Int_t SetCategories();
+    // axis is one of StMixerCategories::axis: 0 vz, 1 centrality bin, 2 event plane, 3 grefMult
+    void setCategoryAxis(int axis, int nBins, float min, float max);
+    // MB of buffered tracks, 0 for mxeCuts::eventBuffer events per pool
+    void setMemoryBudget(double megabytes);
+    // threads which mix, including the chain thread, 1 mixes inline
+    void setMixingThreads(int n);
+    // strategy is one of mxeCuts::mixingStrategy, see StMixerStrategy
+    void setMixingStrategy(int strategy, int nMostRecent = 8);
+    // empty names disable loading or saving
+    void setPoolStateFiles(char const* inputFileName, char const* outputFileName);
+    void setTrackStoreFile(char const* fileName);
+    // shared with other mixed event makers, not owned; by default the maker classifies with mxeCuts triggers
+    void setEventClassifier(StPicoEventClassifier* classifier);
+    // validate also keeps the full tracks and compares the pairs
+    void setCompactTracks(bool compact, bool validate = false);
 
  private:
-    int categorize(StPicoDst const*);
+    int categorize(StPicoDst const*, int centrality);
+    float eventPlane(StPicoDst const*) const;
+    StPicoEventMixer* pool(int category);
+    int bufferDepth() const;
+    void shrinkPools(int depth);
     StPicoDst*      mPicoDst;
     StPicoDstMaker* mPicoDstMaker;      
     StPicoEvent*    mPicoEvent;         
     StRefMultCorr* mGRefMultCorrUtil;
+    StPicoEventClassifier* mClassifier;
+    bool            mOwnClassifier;
 
-    StPicoEventMixer* mPicoEventMixer[10][9];
+    StMixerCategories* mCategories;
+    StPicoEventMixer** mPicoEventMixers; //! [nCategories], created on first use
+    int             mNCategories;
+    int             mNPools;
+    double          mMemoryBudget; // MB
+    double          mEventBytes;   // sum over measured events
+    long long       mNEventsMeasured;
+    StMixerScheduler* mScheduler;
+    StMixerTrackStore* mTrackStore;
+    int             mNMixingThreads;
+    int             mMixingStrategy;
+    int             mNMostRecent;
+    bool            mCompactTracks;
+    bool            mValidateCompactTracks;
 
     TString         mOuputFileBaseName; 
     TString         mInputFileName;     
+    TString         mPoolStateInput;
+    TString         mPoolStateOutput;
+    TString         mTrackStoreFileName;
 
     int             mEventCounter;
 
     bool loadEventPlaneCorr(int const runId);
+    bool loadPools(TString const& fileName);
+    bool savePools(TString const& fileName) const;
                                         
     TTree*          mTree;
     TFile*          mOutputFileTree; 
 
     ClassDef(StPicoMixedEventMaker, 0)
 };
+inline void StPicoMixedEventMaker::setMixingThreads(int n) { mNMixingThreads = n; }
+inline void StPicoMixedEventMaker::setMemoryBudget(double megabytes) { mMemoryBudget = megabytes; }
+inline void StPicoMixedEventMaker::setPoolStateFiles(char const* inputFileName, char const* outputFileName)
+{ mPoolStateInput = inputFileName; mPoolStateOutput = outputFileName; }
+inline void StPicoMixedEventMaker::setTrackStoreFile(char const* fileName) { mTrackStoreFileName = fileName; }
+inline void StPicoMixedEventMaker::setEventClassifier(StPicoEventClassifier* classifier) { mClassifier = classifier; }
+inline void StPicoMixedEventMaker::setCompactTracks(bool compact, bool validate)
+{ mCompactTracks = compact; mValidateCompactTracks = validate; }
+inline void StPicoMixedEventMaker::setMixingStrategy(int strategy, int nMostRecent) { mMixingStrategy = strategy; mNMostRecent = nMostRecent; }
 #endif
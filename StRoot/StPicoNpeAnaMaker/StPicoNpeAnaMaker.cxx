@@ -1,26 +1,18 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <cmath>
 
 #include "TFile.h"
-#include "TClonesArray.h"
-#include "TTree.h"
+#include "TList.h"
 
 #include "StPicoDstMaker/StPicoDstMaker.h"
 #include "StPicoDstMaker/StPicoDst.h"
 #include "StPicoDstMaker/StPicoEvent.h"
-#include "StPicoDstMaker/StPicoTrack.h"
-#include "StPicoDstMaker/StPicoEmcPidTraits.h"
-#include "StPicoDstMaker/StPicoBTofPidTraits.h"
 #include "StPicoNpeEventMaker/StPicoNpeEvent.h"
-#include "StPicoNpeEventMaker/StElectronPair.h"
-#include "StBTofUtil/tofPathLength.hh"
-#include "phys_constants.h"
-#include "SystemOfUnits.h"
+#include "StPicoCutsBase/StPicoChainReader.h"
 
+#include "StPicoNpeAnalysis.h"
 #include "StPicoNpeAnaMaker.h"
-#include "StCuts.h"
 
 
 ClassImp(StPicoNpeAnaMaker)
@@ -28,8 +20,10 @@ ClassImp(StPicoNpeAnaMaker)
 StPicoNpeAnaMaker::StPicoNpeAnaMaker(char const * name,char const * inputFilesList,
                                      char const * outName, StPicoDstMaker* picoDstMaker):
 StMaker(name),mPicoDstMaker(picoDstMaker),mPicoNpeEvent(NULL), mOutFileName(outName), mInputFileList(inputFilesList),
-mOutputFile(NULL), mChain(NULL), mEventCounter(0)
-{}
+mOutputFile(NULL), mChain(NULL), mChainReader(NULL), mEventCounter(0), mAnalysis(NULL)
+{
+    mChainReader = new StPicoChainReader("picoNpe");
+}
 
 Int_t StPicoNpeAnaMaker::Init()
 {
@@ -53,58 +47,63 @@ Int_t StPicoNpeAnaMaker::Init()
     }
     mChain->GetBranch("npeEvent")->SetAutoDelete(kFALSE);
     mChain->SetBranchAddress("npeEvent", &mPicoNpeEvent);
+    mChainReader->init(mChain);
     
     mOutputFile = new TFile(mOutFileName.Data(), "RECREATE");
     mOutputFile->cd();
     
-    // -------------- USER VARIABLES -------------------------
-
-    
-    
-    
+    mAnalysis = new StPicoNpeAnalysis();
+    mAnalysis->init();
     
     return kStOK;
 }
 //-----------------------------------------------------------------------------
 StPicoNpeAnaMaker::~StPicoNpeAnaMaker()
 {
-    /*  */
+    delete mAnalysis;
+    delete mChainReader;
 }
 //-----------------------------------------------------------------------------
 Int_t StPicoNpeAnaMaker::Finish()
 {
+    mChainReader->printStats();
+
     LOG_INFO << " StPicoNpeAnaMaker - writing data and closing output file " <<endm;
     mOutputFile->cd();
-    // --------------- USER HISTOGRAM WRITE --------------------
+    mAnalysis->outputList()->Write();
     
-    
-    
-
     mOutputFile->Close();
     
     return kStOK;
 }
 //-----------------------------------------------------------------------------
+void StPicoNpeAnaMaker::readNextEvent()
+{
+    mChainReader->getEntry(mEventCounter++);
+}
+//-----------------------------------------------------------------------------
 Int_t StPicoNpeAnaMaker::Make()
 {
     readNextEvent();
     
-    if (!mPicoDstMaker)
+    // without a picoDst the tracks are read from the StPicoDaughterTrack snapshots
+    // of the picoNpe files, see StPicoNpeEventMaker::setStoreDaughterTracks()
+    StPicoDst const* picoDst = mPicoDstMaker ? mPicoDstMaker->picoDst() : NULL;
+    
+    if (mPicoDstMaker && !picoDst)
     {
-        LOG_WARN << " StPicoNpeAnaMaker - No PicoDstMaker! Skip! " << endm;
+        LOG_WARN << "StPicoNpeAnaMaker - No PicoDst! Skip! " << endm;
         return kStWarn;
     }
     
-    StPicoDst const* picoDst = mPicoDstMaker->picoDst();
-    
-    if (!picoDst)
+    if (!picoDst && mPicoNpeEvent->nElectronPair() > 0 && mPicoNpeEvent->nDaughterTracks() == 0)
     {
-        LOG_WARN << "StPicoNpeAnaMaker - No PicoDst! Skip! " << endm;
-        return kStWarn;
+        LOG_ERROR << "StPicoNpeAnaMaker - No PicoDstMaker and no daughter tracks in the picoNpe file. ABORT!" << endm;
+        return kStFatal;
     }
     
-    if(mPicoNpeEvent->runId() != picoDst->event()->runId() ||
-       mPicoNpeEvent->eventId() != picoDst->event()->eventId())
+    if(picoDst && (mPicoNpeEvent->runId() != picoDst->event()->runId() ||
+       mPicoNpeEvent->eventId() != picoDst->event()->eventId()))
     {
         LOG_ERROR <<" StPicoNpeAnaMaker - !!!!!!!!!!!! ATTENTION !!!!!!!!!!!!!"<<endm;
         LOG_ERROR <<" StPicoNpeAnaMaker - SOMETHING TERRIBLE JUST HAPPENED. StPicoEvent and StPicoNpeEvent are not in sync."<<endm;
@@ -112,32 +111,7 @@ Int_t StPicoNpeAnaMaker::Make()
     }
     
     
-    TClonesArray const * aElectronPair = mPicoNpeEvent->electronPairArray();
-    for (int idx = 0; idx < aElectronPair->GetEntries(); ++idx)
-    {
-        // this is an example of how to get the ElectronPair pairs and their corresponsing tracks
-        StElectronPair const* epair = (StElectronPair*)aElectronPair->At(idx);
-        if(!isGoodPair(epair)) continue;
-        
-        StPicoTrack const* electron = picoDst->track(epair->electronIdx());
-        StPicoTrack const* partner = picoDst->track(epair->partnerIdx());
-        
-        // -------------- USER ANALYSIS -------------------------
-        
-    }
+    mAnalysis->analyze(mPicoNpeEvent, picoDst);
     
     return kStOK;
 }
-//-----------------------------------------------------------------------------
-bool StPicoNpeAnaMaker::isGoodPair(StElectronPair const* const epair) const
-{
-    if(!epair) return false;
-    
-    StPicoTrack const* electron = mPicoDstMaker->picoDst()->track(epair->electronIdx());
-    StPicoTrack const* partner = mPicoDstMaker->picoDst()->track(epair->partnerIdx());
-    
-    return epair->pairMass() < anaCuts::pairMass &&
-    epair->pairDca() < anaCuts::pairDca
-    ;
-}
-
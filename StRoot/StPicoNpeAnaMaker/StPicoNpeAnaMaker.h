@@ -5,7 +5,17 @@
  *  A Maker to read a StPicoEvent and StPicoNpeEvent
  *  simultaneously and do analysis. 
  *
- *  Please write your analysis in the ::Make() function.
+ *  Please write your analysis in StPicoNpeAnalysis::analyze(),
+ *  it is run event by event by this maker, or file by file
+ *  on worker threads by StPicoFileParallelDriver, see
+ *  runPicoNpeAnaParallel.C.
+ *
+ *  picoDstMaker can be NULL for picoNpe files with daughter
+ *  track snapshots (StPicoNpeEventMaker::setStoreDaughterTracks),
+ *  the electrons and partners are then StPicoDaughterTracks.
+ *
+ *  The TTreeCache and the branches read from the picoNpe
+ *  files are set up with chainReader() before Init().
  *
  *  Authors:  Xin Dong        (xdong@lbl.gov)
  *            Michael Lomnitz (mrlomnitz@lbl.gov)
@@ -29,6 +39,8 @@ class StElectronTrack;
 class StElectronPair;
 class StPicoDstMaker;
 class StPicoTrack;
+class StPicoChainReader;
+class StPicoNpeAnalysis;
 
 class StPicoNpeAnaMaker : public StMaker
 {
@@ -42,13 +54,12 @@ class StPicoNpeAnaMaker : public StMaker
     virtual Int_t Finish();
 
     int getEntries() const;
+    StPicoChainReader* chainReader() const;
 
     
   private:
     StPicoNpeAnaMaker() {}
     void readNextEvent();
-
-    bool isGoodPair(StElectronPair const*) const;
     
     StPicoDstMaker* mPicoDstMaker;
     StPicoNpeEvent* mPicoNpeEvent;
@@ -57,16 +68,11 @@ class StPicoNpeAnaMaker : public StMaker
     TString mInputFileList;
     TFile* mOutputFile;
     TChain* mChain;
+    StPicoChainReader* mChainReader;
     int mEventCounter;
 
-    
-    // -------------- USER variables -------------------------
-    // add your member variables here. 
-    // Remember that ntuples size can be really big, use histograms where appropriate
-    
-    
-    
-    
+    StPicoNpeAnalysis* mAnalysis;
+
     ClassDef(StPicoNpeAnaMaker, 0)
 };
 
@@ -75,9 +81,9 @@ inline int StPicoNpeAnaMaker::getEntries() const
   return mChain? mChain->GetEntries() : 0;
 }
 
-inline void StPicoNpeAnaMaker::readNextEvent()
+inline StPicoChainReader* StPicoNpeAnaMaker::chainReader() const
 {
-  mChain->GetEntry(mEventCounter++);
+  return mChainReader;
 }
 
 #endif
@@ -0,0 +1,138 @@
+#include "TChain.h"
+#include "TList.h"
+#include "TClonesArray.h"
+
+#include "StPicoDstMaker/StPicoDst.h"
+#include "StPicoDstMaker/StPicoEvent.h"
+#include "StPicoDstMaker/StPicoTrack.h"
+#include "StPicoDstMaker/StPicoBTofPidTraits.h"
+#include "StPicoNpeEventMaker/StPicoNpeEvent.h"
+#include "StPicoNpeEventMaker/StElectronPair.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
+#include "StPicoCutsBase/StPicoChainReader.h"
+
+#include "StPicoNpeAnalysis.h"
+#include "StCuts.h"
+
+ClassImp(StPicoNpeAnalysis)
+
+//-----------------------------------------------------------------------------
+StPicoNpeAnalysis::StPicoNpeAnalysis(char const* name) : StPicoFileAnalysis(name)
+{}
+//-----------------------------------------------------------------------------
+StPicoFileAnalysis* StPicoNpeAnalysis::clone() const
+{
+    StPicoNpeAnalysis* analysis = new StPicoNpeAnalysis(mName.Data());
+    analysis->copyConfiguration(*this);
+
+    // -------------- USER configuration -------------------------
+
+    return analysis;
+}
+//-----------------------------------------------------------------------------
+void StPicoNpeAnalysis::initAnalysis()
+{
+    // -------------- USER VARIABLES -------------------------
+    // e.g. mOutList->Add(new TH1F(...));
+
+}
+//-----------------------------------------------------------------------------
+bool StPicoNpeAnalysis::processFile(char const* fileName)
+{
+    // constructed before the file is opened, it adds the read rule of old electron pairs
+    StPicoNpeEvent* picoNpeEvent = new StPicoNpeEvent();
+
+    TChain chain("T");
+    if (!chain.Add(fileName, 0) || !chain.GetBranch("npeEvent"))
+    {
+        Error("StPicoNpeAnalysis::processFile", "no npeEvent branch in %s", fileName);
+        delete picoNpeEvent;
+        return false;
+    }
+
+    chain.GetBranch("npeEvent")->SetAutoDelete(kFALSE);
+    chain.SetBranchAddress("npeEvent", &picoNpeEvent);
+
+    // one file per chain, there is no next file to prefetch
+    StPicoChainReader reader(fileName);
+    reader.copySettings(*mChainReader);
+    reader.setPrefetchNextFile(false);
+    reader.init(&chain);
+
+    bool isGood = true;
+    Long64_t const nEntries = chain.GetEntries();
+    for (Long64_t iEvent = 0; iEvent < nEntries && isGood; ++iEvent)
+    {
+        if (reader.getEntry(iEvent) <= 0)
+        {
+            Error("StPicoNpeAnalysis::processFile", "could not read event %lld of %s", iEvent, fileName);
+            isGood = false;
+        }
+        else if (picoNpeEvent->nElectronPair() > 0 && picoNpeEvent->nDaughterTracks() == 0)
+        {
+            Error("StPicoNpeAnalysis::processFile", "no daughter tracks in %s, it needs the picoDst", fileName);
+            isGood = false;
+        }
+        else analyze(picoNpeEvent, NULL);
+    }
+
+    chain.ResetBranchAddresses();
+    delete picoNpeEvent;
+
+    return isGood;
+}
+//-----------------------------------------------------------------------------
+void StPicoNpeAnalysis::analyze(StPicoNpeEvent const* picoNpeEvent, StPicoDst const* picoDst)
+{
+    ++mNEvents;
+
+    TClonesArray const * aElectronPair = picoNpeEvent->electronPairArray();
+    for (int idx = 0; idx < aElectronPair->GetEntries(); ++idx)
+    {
+        // this is an example of how to get the ElectronPair pairs and their corresponsing tracks
+        StElectronPair const* epair = (StElectronPair*)aElectronPair->At(idx);
+        if(!isGoodPair(epair)) continue;
+
+        // the daughters have the same accessors with and without picoDst, e.g. electron.gPt(), partner.nSigmaElectron()
+        StPicoDaughterTrack electron;
+        StPicoDaughterTrack partner;
+        if (!daughterTrack(picoNpeEvent, picoDst, epair->electronIdx(), electron) ||
+            !daughterTrack(picoNpeEvent, picoDst, epair->partnerIdx(), partner)) continue;
+
+        // -------------- USER ANALYSIS -------------------------
+        // epair->conversionRadius(), epair->openingAngle() and epair->pairPt()
+        // are available without the tracks, the latter two are NaN for version 2 pairs
+
+    }
+}
+//-----------------------------------------------------------------------------
+bool StPicoNpeAnalysis::daughterTrack(StPicoNpeEvent const* picoNpeEvent, StPicoDst const* picoDst,
+                                      unsigned short const idx, StPicoDaughterTrack& daughter) const
+{
+    if (picoNpeEvent->nDaughterTracks())
+    {
+        StPicoDaughterTrack const* stored = picoNpeEvent->daughterTrack(idx);
+        if (!stored) return false;
+
+        daughter = *stored;
+        return true;
+    }
+
+    StPicoTrack const* trk = picoDst->track(idx);
+    if (!trk) return false;
+
+    StPicoBTofPidTraits const* tofPid = trk->bTofPidTraitsIndex() >= 0 ? picoDst->btofPidTraits(trk->bTofPidTraitsIndex()) : NULL;
+
+    StPicoEvent const* picoEvent = picoDst->event();
+    daughter = StPicoDaughterTrack(*trk, idx, picoEvent->primaryVertex(), picoEvent->bField(), tofPid);
+    return true;
+}
+//-----------------------------------------------------------------------------
+bool StPicoNpeAnalysis::isGoodPair(StElectronPair const* const epair) const
+{
+    if(!epair) return false;
+
+    return epair->pairMass() < anaCuts::pairMass &&
+    epair->pairDca() < anaCuts::pairDca
+    ;
+}
@@ -0,0 +1,60 @@
+#ifndef StPicoNpeAnalysis_h
+#define StPicoNpeAnalysis_h
+
+/* **************************************************
+ *  Analysis of StPicoNpeEvents, run event by event by
+ *  StPicoNpeAnaMaker or file by file on worker threads by
+ *  StPicoFileParallelDriver.
+ *
+ *  Please write your analysis in the ::analyze() function
+ *  and book your histograms in ::initAnalysis(), in
+ *  mOutList. Members added here are per worker, copy your
+ *  configuration in ::clone().
+ *
+ *  picoDst is NULL in ::analyze() for picoNpe files with
+ *  daughter track snapshots, which are the only ones
+ *  ::processFile() can read.
+ *
+ *  Authors:  **Kunsu OH        (kunsuoh@gmail.com)
+ *              Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ *
+ * **************************************************
+ */
+
+#include "StPicoCutsBase/StPicoFileAnalysis.h"
+
+class StPicoDst;
+class StPicoNpeEvent;
+class StElectronPair;
+class StPicoDaughterTrack;
+
+class StPicoNpeAnalysis : public StPicoFileAnalysis
+{
+public:
+    StPicoNpeAnalysis(char const* name = "picoNpeAnalysis");
+    virtual ~StPicoNpeAnalysis() {}
+
+    virtual StPicoFileAnalysis* clone() const;
+    virtual bool processFile(char const* fileName);
+
+    // -- one event, picoDst can be NULL
+    void analyze(StPicoNpeEvent const* picoNpeEvent, StPicoDst const* picoDst);
+
+protected:
+    virtual void initAnalysis();
+
+private:
+    bool isGoodPair(StElectronPair const*) const;
+
+    // daughter idx from the picoNpe snapshots, or built from the picoDst track if there are none
+    bool daughterTrack(StPicoNpeEvent const*, StPicoDst const*, unsigned short idx, StPicoDaughterTrack& daughter) const;
+
+    // -------------- USER variables -------------------------
+    // add your member variables here.
+    // Remember that ntuples size can be really big, use histograms where appropriate
+
+    ClassDef(StPicoNpeAnalysis, 0)
+};
+#endif
@@ -43,6 +43,9 @@ namespace cuts
     float const positionX = 200.;
     float const positionY = 200.;
     float const positionZ = 200.;
+
+    // electron pair prefilter, see StElectronPairPrefilter
+    float const prefilterMaxRadius = 300.; // cm, covers positionX and positionY
     
     // histograms electron pair cuts
     float const qaNHitsFit = 20;
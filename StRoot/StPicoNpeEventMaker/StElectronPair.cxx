@@ -1,8 +1,14 @@
 #include <limits>
 #include <cmath>
+#include <algorithm>
 
 #ifdef __ROOT__
 
+#include "TClass.h"
+#include "TVirtualObject.h"
+#include "TSchemaRule.h"
+#include "TSchemaRuleSet.h"
+
 #include "StLorentzVectorF.hh"
 #include "StThreeVectorF.hh"
 #include "StPhysicalHelixD.hh"
@@ -14,15 +20,23 @@
 
 ClassImp(StElectronPair)
 
+float const StElectronPair::massUnit = 1e-4;     // GeV
+float const StElectronPair::dcaUnit = 1e-3;      // cm
+float const StElectronPair::positionUnit = 1e-2; // cm
+float const StElectronPair::angleUnit = 1e-4;    // rad
+float const StElectronPair::ptUnit = 1e-3;       // GeV/c
+
 
 StElectronPair::StElectronPair():
 mElectronIdx(std::numeric_limits<unsigned short>::quiet_NaN()), 
 mPartnerIdx(std::numeric_limits<unsigned short>::quiet_NaN()),
 mMass(std::numeric_limits<unsigned short>::quiet_NaN()),
-mPairDca(std::numeric_limits<float>::quiet_NaN()),
-mPositionX(std::numeric_limits<float>::quiet_NaN()),
-mPositionY(std::numeric_limits<float>::quiet_NaN()),
-mPositionZ(std::numeric_limits<float>::quiet_NaN())
+mPairDca(std::numeric_limits<unsigned short>::max()),
+mPositionX(0), mPositionY(0), mPositionZ(0),
+mConversionRadius(0),
+mOpeningAngle(std::numeric_limits<unsigned short>::max()),
+mPairPt(std::numeric_limits<unsigned short>::max()),
+mRawPairDca(std::numeric_limits<float>::quiet_NaN())
 {
 }
 //------------------------------------
@@ -32,7 +46,11 @@ mMass(t->mMass),
 mPairDca(t->mPairDca),
 mPositionX(t->mPositionX),
 mPositionY(t->mPositionY),
-mPositionZ(t->mPositionZ)
+mPositionZ(t->mPositionZ),
+mConversionRadius(t->mConversionRadius),
+mOpeningAngle(t->mOpeningAngle),
+mPairPt(t->mPairPt),
+mRawPairDca(t->mRawPairDca)
 {
 }
 //------------------------------------
@@ -40,10 +58,12 @@ StElectronPair::StElectronPair(StPicoTrack const * const electron, StPicoTrack c
                                unsigned short const electronIdx, unsigned short const partnerIdx, float const bField) :
 mElectronIdx(electronIdx), mPartnerIdx(partnerIdx),
 mMass(std::numeric_limits<unsigned short>::quiet_NaN()),
-mPairDca(std::numeric_limits<float>::quiet_NaN()),
-mPositionX(std::numeric_limits<float>::quiet_NaN()),
-mPositionY(std::numeric_limits<float>::quiet_NaN()),
-mPositionZ(std::numeric_limits<float>::quiet_NaN())
+mPairDca(std::numeric_limits<unsigned short>::max()),
+mPositionX(0), mPositionY(0), mPositionZ(0),
+mConversionRadius(0),
+mOpeningAngle(std::numeric_limits<unsigned short>::max()),
+mPairPt(std::numeric_limits<unsigned short>::max()),
+mRawPairDca(std::numeric_limits<float>::quiet_NaN())
 {
     if ((!electron || !partner) || (electron->id() == partner->id()))
     {
@@ -63,7 +83,8 @@ mPositionZ(std::numeric_limits<float>::quiet_NaN())
     
     // calculate DCA of partner to electron at their DCA
     StThreeVectorD VectorDca = kAtDcaToPartner - pAtDcaToElectron;
-    mPairDca = static_cast<float>(VectorDca.mag());
+    mRawPairDca = VectorDca.mag();
+    mPairDca = toUnsignedFixed(mRawPairDca, dcaUnit);
     
     // calculate Lorentz vector of electron-partner pair
     StThreeVectorF const electronMomAtDca = electronHelix.momentumAt(ss.first, bField * kilogauss);
@@ -73,15 +94,87 @@ mPositionZ(std::numeric_limits<float>::quiet_NaN())
     StLorentzVectorF const partnerFourMom(partnerMomAtDca, partnerMomAtDca.massHypothesis(M_ELECTRON));
     StLorentzVectorF const epairFourMom = electronFourMom + partnerFourMom;
 
-    mMass = static_cast<unsigned int>(epairFourMom.m()*1000) < std::numeric_limits<unsigned short>::max() ?
-            static_cast<unsigned short>(epairFourMom.m()*1000) : std::numeric_limits<unsigned short>::quiet_NaN();
+    mMass = toUnsignedFixed(epairFourMom.m(), massUnit);
+
+    // max is reserved for pairs read from version 2
+    unsigned short const maxFixed = std::numeric_limits<unsigned short>::max() - 1;
+    mOpeningAngle = std::min(toUnsignedFixed(electronMomAtDca.angle(partnerMomAtDca), angleUnit), maxFixed);
+    mPairPt = std::min(toUnsignedFixed(epairFourMom.perp(), ptUnit), maxFixed);
     
     StThreeVectorD Position = (kAtDcaToPartner + pAtDcaToElectron)/2.0;
 
-    mPositionX = Position.x();
+    mPositionX = toSignedFixed(Position.x(), positionUnit);
+
+    mPositionY = toSignedFixed(Position.y(), positionUnit);
+
+    mPositionZ = toSignedFixed(Position.z(), positionUnit);
+
+    mConversionRadius = toUnsignedFixed(Position.perp(), positionUnit);
+}
+//------------------------------------
+void StElectronPair::addSchemaEvolution()
+{
+    // version 2 stored the mass in MeV and the pair dca and conversion position as floats,
+    // version 3 stored the pair dca in 1 um
+    static bool const added = addReadRule("sourceClass=\"StElectronPair\" version=\"[-2]\" "
+                                          "source=\"unsigned short mMass; float mPairDca; float mPositionX; float mPositionY; float mPositionZ\" "
+                                          "targetClass=\"StElectronPair\" "
+                                          "target=\"mMass, mPairDca, mPositionX, mPositionY, mPositionZ, mConversionRadius, mOpeningAngle, mPairPt\"",
+                                          &StElectronPair::readVersion2) &&
+                              addReadRule("sourceClass=\"StElectronPair\" version=\"[3]\" "
+                                          "source=\"unsigned short mPairDca\" "
+                                          "targetClass=\"StElectronPair\" target=\"mPairDca\"",
+                                          &StElectronPair::readVersion3);
+    (void)added;
+}
+//------------------------------------
+bool StElectronPair::addReadRule(char const* const ruleString, ReadFunction const function)
+{
+    ROOT::TSchemaRule* rule = new ROOT::TSchemaRule();
+    rule->SetFromRule(ruleString);
+    rule->SetReadFunctionPointer(function);
+
+    if (TClass::GetClass("StElectronPair")->GetSchemaRules(kTRUE)->AddRule(rule)) return true;
+
+    delete rule;
+    Error("StElectronPair::addSchemaEvolution", "could not add the read rule %s, the pairs will be read without conversion", ruleString);
+    return false;
+}
+//------------------------------------
+void StElectronPair::readVersion2(char* const target, TVirtualObject* const onfile)
+{
+    static Long_t const massOffset = onfile->GetClass()->GetDataMemberOffset("mMass");
+    static Long_t const pairDcaOffset = onfile->GetClass()->GetDataMemberOffset("mPairDca");
+    static Long_t const positionXOffset = onfile->GetClass()->GetDataMemberOffset("mPositionX");
+    static Long_t const positionYOffset = onfile->GetClass()->GetDataMemberOffset("mPositionY");
+    static Long_t const positionZOffset = onfile->GetClass()->GetDataMemberOffset("mPositionZ");
+
+    char const* const old = static_cast<char const*>(onfile->GetObject());
+    unsigned short const mass = *reinterpret_cast<unsigned short const*>(old + massOffset);
+    float const pairDca = *reinterpret_cast<float const*>(old + pairDcaOffset);
+    float const positionX = *reinterpret_cast<float const*>(old + positionXOffset);
+    float const positionY = *reinterpret_cast<float const*>(old + positionYOffset);
+    float const positionZ = *reinterpret_cast<float const*>(old + positionZOffset);
+
+    StElectronPair* const pair = reinterpret_cast<StElectronPair*>(target);
+    pair->mMass = toUnsignedFixed(mass * 1e-3, massUnit);
+    pair->mPairDca = pairDca == pairDca ? toUnsignedFixed(pairDca, dcaUnit) : std::numeric_limits<unsigned short>::max();
+    pair->mPositionX = toSignedFixed(positionX, positionUnit);
+    pair->mPositionY = toSignedFixed(positionY, positionUnit);
+    pair->mPositionZ = toSignedFixed(positionZ, positionUnit);
+    pair->mConversionRadius = toUnsignedFixed(sqrt(positionX * positionX + positionY * positionY), positionUnit);
+    pair->mOpeningAngle = std::numeric_limits<unsigned short>::max();
+    pair->mPairPt = std::numeric_limits<unsigned short>::max();
+}
+//------------------------------------
+void StElectronPair::readVersion3(char* const target, TVirtualObject* const onfile)
+{
+    static Long_t const pairDcaOffset = onfile->GetClass()->GetDataMemberOffset("mPairDca");
 
-    mPositionY = Position.y();
+    // 1 um, saturated values stay saturated
+    unsigned short const pairDca = *reinterpret_cast<unsigned short const*>(static_cast<char const*>(onfile->GetObject()) + pairDcaOffset);
 
-    mPositionZ = Position.z();
+    StElectronPair* const pair = reinterpret_cast<StElectronPair*>(target);
+    pair->mPairDca = pairDca == std::numeric_limits<unsigned short>::max() ? pairDca : toUnsignedFixed(pairDca * 1e-4, dcaUnit);
 }
 #endif // __ROOT__
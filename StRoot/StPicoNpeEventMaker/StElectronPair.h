@@ -7,6 +7,23 @@
  *  lorentz vector and topological decay parameters
  *  and storing them.
  *
+ *  Since version 3 all quantities are stored in fixed point,
+ *  values out of range are saturated:
+ *     mass               0.1 MeV      unsigned short
+ *     pair dca           10 um        unsigned short (1 um in version 3)
+ *     position x, y, z   100 um       short
+ *     conversion radius  100 um       unsigned short
+ *     opening angle      1e-4 rad     unsigned short
+ *     pair pt            1 MeV        unsigned short
+ *  Version 2 and 3 pairs are converted on read by the
+ *  schema evolution rules added by ::addSchemaEvolution(),
+ *  version 2 pairs have no opening angle and pair pt (NaN).
+ *  The rules are compiled in StElectronPair.cxx, not in a
+ *  LinkDef, so the dictionary is still generated by cons.
+ *
+ *  The dca range of 65 cm covers the pair dca cut of the
+ *  maker, which is applied to rawPairDca().
+ *
  *  Authors:  **Kunsu OH        (kunsuoh@gmail.com)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
  *
@@ -14,8 +31,12 @@
  * **************************************************
  */
 
+#include <limits>
+#include <cmath>
+
 #include "TObject.h"
 
+class TVirtualObject;
 class StPicoTrack;
 class StPicoEvent;
 
@@ -27,40 +48,90 @@ public:
     StElectronPair(StPicoTrack const * Electron, StPicoTrack const * Partner,
                    unsigned short electronIdx,unsigned short partnerIdx, float bField);
     ~StElectronPair() {}// please keep this non-virtual and NEVER inherit from this class
-    
+
     unsigned short   electronIdx() const;	// tagged electron idx
     unsigned short   partnerIdx() const;	// partner electron idx
     float pairMass()    const;                     // electron pair mass
     float pairDca() const;                  // DCA between tagged and partner
+    float rawPairDca() const;               // before the fixed point conversion, for the cuts of the maker, NaN if read from file
     float positionX() const;                // conversion position X
     float positionY() const;                // conversion position Y
     float positionZ() const;                // conversion position Z
+    float conversionRadius() const;         // transverse distance of the conversion position to the beam line
+    float openingAngle() const;             // between the momenta at the pair DCA, NaN before version 3
+    float pairPt() const;                   // NaN before version 3
+
+    // fixed point conversions
+    static unsigned short toUnsignedFixed(double value, double unit);
+    static short toSignedFixed(double value, double unit);
+
+    // adds the read rules of version 2 and 3 pairs, called by the StPicoNpeEvent constructor
+    // before any picoNpe file is read. Thread safe, the rule is added once.
+    static void addSchemaEvolution();
+
+    static float const massUnit;
+    static float const dcaUnit;
+    static float const positionUnit;
+    static float const angleUnit;
+    static float const ptUnit;
 
-    
-    
 private:
     // disable copy constructor and assignment operator by making them private (once C++11 is available in STAR you can use delete specifier instead)
     StElectronPair(StElectronPair const &);
     StElectronPair& operator=(StElectronPair const &);
-    
+
+    typedef void (*ReadFunction)(char*, TVirtualObject*);
+    static bool addReadRule(char const* rule, ReadFunction);
+
+    // convert the members read from version 2 and 3 pairs
+    static void readVersion2(char* target, TVirtualObject* onfile);
+    static void readVersion3(char* target, TVirtualObject* onfile);
+
     unsigned short mElectronIdx;    // index of electron track in StPicoDstEvent (2 Bytes)
     unsigned short mPartnerIdx;     // index of partner track in StPicoDstEvent (2 Bytes)
-    unsigned short mMass;           // mass * 1000 (2 Bytes)
-    float mPairDca;                 // pair dca (4 Bytes)
-    float mPositionX;               // conversion position x (4 Bytes)
-    float mPositionY;               // conversion position y (4 Bytes)
-    float mPositionZ;               // conversion position z (4 Bytes)
-    
-    ClassDef(StElectronPair,2)
+    unsigned short mMass;           // mass / massUnit (2 Bytes)
+    unsigned short mPairDca;        // pair dca / dcaUnit (2 Bytes)
+    short mPositionX;               // conversion position x / positionUnit (2 Bytes)
+    short mPositionY;               // conversion position y / positionUnit (2 Bytes)
+    short mPositionZ;               // conversion position z / positionUnit (2 Bytes)
+    unsigned short mConversionRadius; // conversion radius / positionUnit (2 Bytes)
+    unsigned short mOpeningAngle;   // opening angle / angleUnit, max if unknown (2 Bytes)
+    unsigned short mPairPt;         // pair pt / ptUnit, max if unknown (2 Bytes)
+    float mRawPairDca;              //! pair dca before the fixed point conversion
+
+    ClassDef(StElectronPair,4)
 };
 inline unsigned short   StElectronPair::electronIdx() const     { return mElectronIdx;                        }
 inline unsigned short   StElectronPair::partnerIdx() const      { return mPartnerIdx;                         }
-inline float StElectronPair::pairMass()    const                { return static_cast<float>(mMass/1000.);     }
-inline float StElectronPair::pairDca() const                    { return mPairDca;                            }
-inline float StElectronPair::positionX() const                  { return mPositionX;}
-inline float StElectronPair::positionY() const                  { return mPositionY;}
-inline float StElectronPair::positionZ() const                  { return mPositionZ;}
+inline float StElectronPair::pairMass()    const                { return mMass * massUnit;                    }
+inline float StElectronPair::pairDca() const                    { return mPairDca * dcaUnit;                  }
+inline float StElectronPair::rawPairDca() const                 { return mRawPairDca;                         }
+inline float StElectronPair::positionX() const                  { return mPositionX * positionUnit;}
+inline float StElectronPair::positionY() const                  { return mPositionY * positionUnit;}
+inline float StElectronPair::positionZ() const                  { return mPositionZ * positionUnit;}
+inline float StElectronPair::conversionRadius() const           { return mConversionRadius * positionUnit;}
+inline float StElectronPair::openingAngle() const
+{
+    return mOpeningAngle == std::numeric_limits<unsigned short>::max() ? std::numeric_limits<float>::quiet_NaN() : mOpeningAngle * angleUnit;
+}
+inline float StElectronPair::pairPt() const
+{
+    return mPairPt == std::numeric_limits<unsigned short>::max() ? std::numeric_limits<float>::quiet_NaN() : mPairPt * ptUnit;
+}
+
+inline unsigned short StElectronPair::toUnsignedFixed(double const value, double const unit)
+{
+    if (!(value > 0)) return 0;
+    double const n = floor(value / unit + 0.5);
+    return n < std::numeric_limits<unsigned short>::max() ? static_cast<unsigned short>(n) : std::numeric_limits<unsigned short>::max();
+}
+inline short StElectronPair::toSignedFixed(double const value, double const unit)
+{
+    if (value != value) return 0;
+    double const n = floor(value / unit + 0.5);
+    if (n <= std::numeric_limits<short>::min()) return std::numeric_limits<short>::min();
+    return n < std::numeric_limits<short>::max() ? static_cast<short>(n) : std::numeric_limits<short>::max();
+}
 
 #endif
 #endif
-
@@ -0,0 +1,120 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "StPhysicalHelixD.hh"
+#include "SystemOfUnits.h"
+#include "StPicoDstMaker/StPicoTrack.h"
+
+#include "StElectronPairPrefilter.h"
+
+//------------------------------------
+StElectronPairPrefilter::StElectronPairPrefilter(float const maxRadius, float const maxPairDca) :
+mMaxRadius(maxRadius), mMaxPairDca(maxPairDca), mPVtx(), mBField(0), mMinP(0), mMaxRotation(0)
+{
+}
+//------------------------------------
+void StElectronPairPrefilter::clear(StThreeVectorF const& pVtx, float const bField, int const nTracks)
+{
+    mPVtx = pVtx;
+    mBField = bField;
+    mSlots.assign(nTracks, -1);
+    mLines.clear();
+    mMinP = std::numeric_limits<float>::max();
+    mMaxRotation = 0;
+}
+//------------------------------------
+void StElectronPairPrefilter::addTrack(unsigned short const idx, StPicoTrack const& trk)
+{
+    if (mSlots[idx] >= 0) return;
+
+    StPhysicalHelixD helix = trk.dcaGeometry().helix();
+    helix.moveOrigin(helix.pathLength(mPVtx));
+
+    Line line;
+    line.origin = helix.origin();
+    StThreeVectorF const mom = helix.momentum(mBField * kilogauss);
+    line.p = mom.mag();
+    line.direction = mom / line.p;
+    line.theta = mom.theta();
+    line.phi = mom.phi();
+
+    // the pair DCA is at most this far from the origin in the transverse plane
+    float const chord = mMaxRadius + (line.origin - mPVtx).perp() + mMaxPairDca;
+    // radius of curvature, 2.99792458e-4 GeV/c per kG cm
+    float const radius = fabs(mBField) > 0 ? mom.perp() / (2.99792458e-4 * fabs(mBField)) : 0;
+
+    if (fabs(mBField) > 0 && chord < 2. * radius)
+    {
+        line.maxRotation = 2. * asin(chord / (2. * radius));
+        // the helix leaves its tangent by the sagitta transversely and lags it in z
+        float const dxy = radius * (1. - cos(line.maxRotation));
+        float const dz = radius * (line.maxRotation - sin(line.maxRotation)) * fabs(mom.z()) / mom.perp();
+        line.maxDeviation = sqrt(dxy * dxy + dz * dz);
+    }
+    else if (fabs(mBField) > 0)
+    {
+        line.maxRotation = M_PI;
+        line.maxDeviation = -1;
+    }
+    else
+    {
+        line.maxRotation = 0;
+        line.maxDeviation = 0;
+    }
+
+    mMinP = std::min(mMinP, line.p);
+    mMaxRotation = std::max(mMaxRotation, line.maxRotation);
+
+    mSlots[idx] = mLines.size();
+    mLines.push_back(line);
+}
+//------------------------------------
+bool StElectronPairPrefilter::reject(unsigned short const idx1, unsigned short const idx2, float const maxMass) const
+{
+    Line const& l1 = mLines[mSlots[idx1]];
+    Line const& l2 = mLines[mSlots[idx2]];
+
+    // -- mass: m^2 >= 2 p1 p2 (1 - cos(alpha)), with a margin for the stored mass precision
+    float const openingAtPVtx = atan2(l1.direction.cross(l2.direction).mag(), l1.direction.dot(l2.direction));
+    float const minOpening = std::max(fabs(l1.theta - l2.theta), openingAtPVtx - l1.maxRotation - l2.maxRotation);
+    if (minOpening > 0)
+    {
+        float const sinHalf = sin(0.5 * minOpening);
+        float const massCut = maxMass + 0.001;
+        if (4. * l1.p * l2.p * sinHalf * sinHalf >= massCut * massCut) return true;
+    }
+
+    // -- pair dca
+    if (l1.maxDeviation < 0 || l2.maxDeviation < 0) return false;
+
+    StThreeVectorF const w = l1.origin - l2.origin;
+    StThreeVectorF const n = l1.direction.cross(l2.direction);
+    float const nMag = n.mag();
+    float const lineDca = nMag > 1e-6 ? fabs(w.dot(n)) / nMag : w.cross(l1.direction).mag();
+
+    return lineDca - l1.maxDeviation - l2.maxDeviation >= mMaxPairDca;
+}
+//------------------------------------
+void StElectronPairPrefilter::partnerWindow(unsigned short const idx, float const maxMass,
+                                            float& thetaMin, float& thetaMax, float& dPhi) const
+{
+    Line const& l = mLines[mSlots[idx]];
+
+    // -- largest opening angle which passes the mass bound of reject(), for the softest partner
+    float const massCut = maxMass + 0.001;
+    float const x = massCut / (2. * sqrt(l.p * mMinP));
+    float const maxOpening = x < 1 ? 2. * asin(x) + 1e-4 : M_PI;
+
+    thetaMin = l.theta - maxOpening;
+    thetaMax = l.theta + maxOpening;
+
+    // -- sin^2(alpha/2) >= sin(theta1) sin(theta2) sin^2(dPhi/2) at the primary vertex
+    dPhi = M_PI;
+    float const maxOpeningAtPVtx = maxOpening + l.maxRotation + mMaxRotation;
+    if (maxOpeningAtPVtx >= M_PI || thetaMin <= 0 || thetaMax >= M_PI) return;
+
+    float const minSinTheta = sqrt(sin(l.theta) * std::min(sin(thetaMin), sin(thetaMax)));
+    float const sinHalf = sin(0.5 * maxOpeningAtPVtx);
+    if (sinHalf < minSinTheta) dPhi = 2. * asin(sinHalf / minSinTheta) + 1e-4;
+}
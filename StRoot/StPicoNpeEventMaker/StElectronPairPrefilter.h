@@ -0,0 +1,86 @@
+#ifndef StElectronPairPrefilter_hh
+#define StElectronPairPrefilter_hh
+
+/* **************************************************
+ *  Cheap rejection of electron pairs before the
+ *  helix-helix DCA of StElectronPair.
+ *
+ *  Tracks are stored once per event at their DCA to
+ *  the primary vertex. A pair is rejected if it can not
+ *  pass the pair mass or pair dca cuts, from
+ *  1) the polar angles: the opening angle at the pair
+ *     DCA is at least |theta1 - theta2|,
+ *  2) the opening angle at the primary vertex, less the
+ *     largest rotation of the momenta up to the pair DCA,
+ *  3) the DCA of the straight lines at the primary
+ *     vertex, less the largest deviation of the helices
+ *     from them.
+ *  2) and 3) assume the pair DCA within maxRadius of the
+ *  primary vertex in the transverse plane, and within the
+ *  first turn of the helices. The default maxRadius
+ *  covers the position cuts of the tree.
+ *
+ *  partnerWindow() gives the polar angle and azimuth
+ *  window outside of which every partner of an electron
+ *  is rejected, used by StElectronPartnerGrid.
+ *
+ *  Authors:    Kunsu OH        (kunsuoh@gmail.com)
+ *            **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ * **************************************************
+ */
+
+#include <vector>
+#include "StThreeVectorF.hh"
+
+class StPicoTrack;
+
+class StElectronPairPrefilter
+{
+public:
+    StElectronPairPrefilter(float maxRadius, float maxPairDca);
+
+    void clear(StThreeVectorF const& pVtx, float bField, int nTracks);
+    void addTrack(unsigned short idx, StPicoTrack const&);
+
+    // maxMass is the pair mass cut, idx are picoDst indices of added tracks
+    bool reject(unsigned short idx1, unsigned short idx2, float maxMass) const;
+
+    // momentum direction at the DCA to the primary vertex
+    float phi(unsigned short idx) const;
+    float theta(unsigned short idx) const;
+    // largest rotation of the momentum up to a pair DCA, pi if not constrained
+    float maxRotation(unsigned short idx) const;
+    float p(unsigned short idx) const;
+
+    // any partner outside theta in [thetaMin, thetaMax] or |phi - phi(idx)| > dPhi is rejected
+    void partnerWindow(unsigned short idx, float maxMass, float& thetaMin, float& thetaMax, float& dPhi) const;
+
+private:
+    struct Line
+    {
+        StThreeVectorF origin;
+        StThreeVectorF direction;
+        float p;
+        float theta;
+        float phi;
+        float maxRotation;
+        float maxDeviation; // of the helix from the line within maxRotation
+    };
+
+    float mMaxRadius;
+    float mMaxPairDca;
+    StThreeVectorF mPVtx;
+    float mBField;
+    std::vector<int> mSlots; // picoDst index -> mLines, -1 if not added
+    std::vector<Line> mLines;
+    float mMinP;           // of the added tracks
+    float mMaxRotation;
+};
+
+inline float StElectronPairPrefilter::phi(unsigned short idx) const         { return mLines[mSlots[idx]].phi; }
+inline float StElectronPairPrefilter::theta(unsigned short idx) const       { return mLines[mSlots[idx]].theta; }
+inline float StElectronPairPrefilter::maxRotation(unsigned short idx) const { return mLines[mSlots[idx]].maxRotation; }
+inline float StElectronPairPrefilter::p(unsigned short idx) const           { return mLines[mSlots[idx]].p; }
+#endif
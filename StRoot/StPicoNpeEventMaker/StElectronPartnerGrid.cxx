@@ -0,0 +1,72 @@
+#include <cmath>
+#include <algorithm>
+
+#include "StElectronPartnerGrid.h"
+
+//------------------------------------
+StElectronPartnerGrid::StElectronPartnerGrid(int const nEtaBins, float const etaMax, int const nPhiBins) :
+mNEtaBins(nEtaBins), mEtaMax(etaMax), mNPhiBins(nPhiBins),
+mEtaBinWidth(2. * etaMax / nEtaBins), mPhiBinWidth(2. * M_PI / nPhiBins),
+mBins(2 * nEtaBins * nPhiBins)
+{
+}
+//------------------------------------
+void StElectronPartnerGrid::clear()
+{
+    // keep the capacity of the bins
+    for (size_t i = 0; i < mBins.size(); ++i) mBins[i].clear();
+}
+//------------------------------------
+int StElectronPartnerGrid::etaBin(float const eta) const
+{
+    if (eta <= -mEtaMax) return 0;
+    if (eta >= mEtaMax) return mNEtaBins - 1;
+    return std::min(static_cast<int>((eta + mEtaMax) / mEtaBinWidth), mNEtaBins - 1);
+}
+//------------------------------------
+int StElectronPartnerGrid::phiBin(float const phi) const
+{
+    int const iPhi = static_cast<int>(floor((phi + M_PI) / mPhiBinWidth)) % mNPhiBins;
+    return iPhi < 0 ? iPhi + mNPhiBins : iPhi;
+}
+//------------------------------------
+void StElectronPartnerGrid::addPartner(unsigned short const partner, int const charge, float const eta, float const phi)
+{
+    mBins[bin(charge > 0 ? 1 : 0, etaBin(eta), phiBin(phi))].push_back(partner);
+}
+//------------------------------------
+void StElectronPartnerGrid::findPartners(float const etaMin, float const etaMax, float const phi, float const dPhi,
+                                         std::vector<unsigned short>& partners) const
+{
+    partners.clear();
+
+    int const iEtaMin = etaBin(etaMin);
+    int const iEtaMax = etaBin(etaMax);
+
+    // phi cells to visit, all of them if the window wraps around
+    int iPhiMin = 0;
+    int nPhi = mNPhiBins;
+    if (dPhi < M_PI)
+    {
+        iPhiMin = static_cast<int>(floor((phi - dPhi + M_PI) / mPhiBinWidth));
+        nPhi = std::min(static_cast<int>(floor((phi + dPhi + M_PI) / mPhiBinWidth)) - iPhiMin + 1, mNPhiBins);
+    }
+
+    for (int iCharge = 0; iCharge < 2; ++iCharge)
+    {
+        for (int iEta = iEtaMin; iEta <= iEtaMax; ++iEta)
+        {
+            for (int i = 0; i < nPhi; ++i)
+            {
+                int iPhi = (iPhiMin + i) % mNPhiBins;
+                if (iPhi < 0) iPhi += mNPhiBins;
+
+                std::vector<unsigned short> const& cell = mBins[bin(iCharge, iEta, iPhi)];
+                partners.insert(partners.end(), cell.begin(), cell.end());
+            }
+        }
+    }
+
+    // keep the order of the full loop over partners
+    std::sort(partners.begin(), partners.end());
+}
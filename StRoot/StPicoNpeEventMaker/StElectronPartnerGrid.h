@@ -0,0 +1,48 @@
+#ifndef StElectronPartnerGrid_hh
+#define StElectronPartnerGrid_hh
+
+/* **************************************************
+ *  Partner electrons of an event binned by charge and
+ *  momentum direction (eta, phi) at the primary vertex.
+ *
+ *  findPartners() returns the partners in the cells
+ *  overlapping an eta and phi window, e.g. the one of
+ *  StElectronPairPrefilter::partnerWindow(), in the order
+ *  they were added. Tracks beyond the eta range are kept
+ *  in the edge bins.
+ *
+ *  Authors:    Kunsu OH        (kunsuoh@gmail.com)
+ *            **Mustafa Mustafa (mmustafa@lbl.gov)
+ *
+ *  **Code Maintainer
+ * **************************************************
+ */
+
+#include <vector>
+
+class StElectronPartnerGrid
+{
+public:
+    StElectronPartnerGrid(int nEtaBins = 30, float etaMax = 1.5, int nPhiBins = 32);
+
+    void clear();
+    // partner is the index in the partners list of the event
+    void addPartner(unsigned short partner, int charge, float eta, float phi);
+
+    // partners of both charges with eta in [etaMin, etaMax] and |dphi| <= dPhi cells
+    void findPartners(float etaMin, float etaMax, float phi, float dPhi, std::vector<unsigned short>& partners) const;
+
+private:
+    int etaBin(float eta) const;
+    int phiBin(float phi) const;
+    int bin(int iCharge, int iEta, int iPhi) const;
+
+    int   mNEtaBins;
+    float mEtaMax;
+    int   mNPhiBins;
+    float mEtaBinWidth;
+    float mPhiBinWidth;
+    std::vector<std::vector<unsigned short> > mBins;
+};
+inline int StElectronPartnerGrid::bin(int iCharge, int iEta, int iPhi) const { return (iCharge * mNEtaBins + iEta) * mNPhiBins + iPhi; }
+#endif
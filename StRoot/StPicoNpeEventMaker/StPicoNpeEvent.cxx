@@ -1,19 +1,29 @@
 #include "StPicoDstMaker/StPicoEvent.h"
 #include "StPicoDstMaker/StPicoTrack.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
 
 #include "StPicoNpeEvent.h"
 #include "StElectronPair.h"
 
 ClassImp(StPicoNpeEvent)
 
-TClonesArray *StPicoNpeEvent::fgElectronPairArray = 0;
-
 //-----------------------------------------------------------------------
-StPicoNpeEvent::StPicoNpeEvent() : mRunId(-1), mEventId(-1), mNElectronPair(0), mNElectrons(0), mNPartners(0), mElectronPairArray(NULL)
+StPicoNpeEvent::StPicoNpeEvent() : mRunId(-1), mEventId(-1), mNElectronPair(0), mNElectrons(0), mNPartners(0), mNDaughterTracks(0),
+mElectronPairArray(NULL), mDaughterTrackArray(NULL)
 {
-    if (!fgElectronPairArray) fgElectronPairArray = new TClonesArray("StElectronPair");
-    mElectronPairArray = fgElectronPairArray;
+    // before any file is read, version 2 pairs need it
+    StElectronPair::addSchemaEvolution();
+
+    mElectronPairArray = new TClonesArray("StElectronPair");
+    mDaughterTrackArray = new TClonesArray("StPicoDaughterTrack");
+}
 
+//-----------------------------------------------------------------------
+StPicoNpeEvent::~StPicoNpeEvent()
+{
+    clear("C");
+    delete mElectronPairArray;
+    delete mDaughterTrackArray;
 }
 
 //-----------------------------------------------------------------------
@@ -28,11 +38,13 @@ void StPicoNpeEvent::addPicoEvent(StPicoEvent const & picoEvent)
 void StPicoNpeEvent::clear(char const *option)
 {
     mElectronPairArray->Clear(option);
+    mDaughterTrackArray->Clear(option);
     mRunId = -1;
     mEventId = -1;
     mNElectronPair = 0;
     mNElectrons = 0;
     mNPartners = 0;
+    mNDaughterTracks = 0;
 }
 //---------------------------------------------------------------------
 void StPicoNpeEvent::addElectronPair(StElectronPair const* t)
@@ -40,3 +52,14 @@ void StPicoNpeEvent::addElectronPair(StElectronPair const* t)
     TClonesArray &electronPairArray = *mElectronPairArray;
     new(electronPairArray[mNElectronPair++]) StElectronPair(t);
 }
+//---------------------------------------------------------------------
+void StPicoNpeEvent::addDaughterTrack(StPicoDaughterTrack const& t)
+{
+    TClonesArray &daughterTrackArray = *mDaughterTrackArray;
+    new(daughterTrackArray[mNDaughterTracks++]) StPicoDaughterTrack(t);
+}
+//---------------------------------------------------------------------
+StPicoDaughterTrack const* StPicoNpeEvent::daughterTrack(unsigned short const idx) const
+{
+    return StPicoDaughterTrack::find(mDaughterTrackArray, mNDaughterTracks, idx);
+}
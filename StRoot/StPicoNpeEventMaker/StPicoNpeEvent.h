@@ -5,6 +5,10 @@
  *  A specialized class for storing eventwise Npe
  *  candidates.
  *
+ *  Optionally holds a StPicoDaughterTrack snapshot of
+ *  every electron and partner used by the pairs, found by
+ *  daughterTrack(electronIdx()) and daughterTrack(partnerIdx()).
+ *
  *  Authors:  **Kunsu OH        (kunsuoh@gmail.com)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
  *
@@ -19,14 +23,17 @@ class StPicoEvent;
 
 #include "StElectronPair.h"
 
+class StPicoDaughterTrack;
+
 class StPicoNpeEvent : public TObject
 {
 public:
     StPicoNpeEvent();
-    ~StPicoNpeEvent(){ clear("C");}
+    ~StPicoNpeEvent();
     void    clear(char const *option = "");
     void    addPicoEvent(StPicoEvent const & picoEvent);
     void    addElectronPair(StElectronPair const*);
+    void    addDaughterTrack(StPicoDaughterTrack const&); // in increasing picoDst index
     void    nElectrons(int);
     void    nPartners(int);
     
@@ -36,6 +43,10 @@ public:
     int     nElectronPair()  const;
     int     nElectrons() const;
     int     nPartners() const;
+
+    TClonesArray const * daughterTrackArray() const;
+    int     nDaughterTracks() const;
+    StPicoDaughterTrack const* daughterTrack(unsigned short idx) const; // NULL if not stored
     
 private:
     // some variables below are kept in ROOT types to match the same ones in StPicoEvent
@@ -44,11 +55,16 @@ private:
     int   mNElectronPair;       // number of stored pairs
     int   mNElectrons;
     int   mNPartners;
+    int   mNDaughterTracks;
     
+    // owned by each event, the events of parallel readers must not share them
     TClonesArray*        mElectronPairArray;
-    static TClonesArray* fgElectronPairArray;
+    TClonesArray*        mDaughterTrackArray;
+
+    StPicoNpeEvent(StPicoNpeEvent const&);
+    StPicoNpeEvent& operator=(StPicoNpeEvent const&);
     
-    ClassDef(StPicoNpeEvent, 2)
+    ClassDef(StPicoNpeEvent, 3)
 };
 
 inline void StPicoNpeEvent::nElectrons(int n) { mNElectrons = n; }
@@ -58,6 +74,8 @@ inline TClonesArray const * StPicoNpeEvent::electronPairArray()   const { return
 inline int   StPicoNpeEvent::nElectronPair()  const { return mNElectronPair;}
 inline int   StPicoNpeEvent::nElectrons()  const { return mNElectrons;}
 inline int   StPicoNpeEvent::nPartners()  const { return mNPartners;}
+inline TClonesArray const * StPicoNpeEvent::daughterTrackArray() const { return mDaughterTrackArray;}
+inline int   StPicoNpeEvent::nDaughterTracks() const { return mNDaughterTracks;}
 inline Int_t StPicoNpeEvent::runId()   const { return mRunId; }
 inline Int_t StPicoNpeEvent::eventId() const { return mEventId; }
 #endif
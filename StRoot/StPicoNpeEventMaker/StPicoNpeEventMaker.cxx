@@ -1,5 +1,7 @@
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 
 #include "TTree.h"
 #include "TFile.h"
@@ -14,14 +16,31 @@
 #include "StPicoNpeEvent.h"
 #include "StPicoNpeEventMaker.h"
 #include "StPicoNpeHists.h"
+#include "StElectronPair.h"
+#include "StElectronPairPrefilter.h"
+#include "StElectronPartnerGrid.h"
+#include "StPicoCutsBase/StPicoDaughterTrack.h"
 #include "StCuts.h"
 
 ClassImp(StPicoNpeEventMaker)
 
+namespace
+{
+    float pseudoRapidity(float const theta)
+    {
+        if (theta <= 0) return std::numeric_limits<float>::max();
+        if (theta >= M_PI) return -std::numeric_limits<float>::max();
+        return -log(tan(0.5 * theta));
+    }
+}
+
 //-----------------------------------------------------------------------------
 StPicoNpeEventMaker::StPicoNpeEventMaker(char const* makerName, StPicoDstMaker* picoMaker, char const* fileBaseName)
 : StMaker(makerName), mPicoDstMaker(picoMaker), mPicoEvent(NULL), mPicoNpeHists(NULL),
-  mOutputFile(NULL), mTree(NULL), mPicoNpeEvent(NULL)
+  mOutputFile(NULL), mTree(NULL), mPicoNpeEvent(NULL),
+  mPrefilter(NULL), mPartnerGrid(NULL), mValidatePrefilter(false),
+  mNPairCandidates(0), mNPairsInWindow(0), mNPrefilterRejected(0), mNPrefilterLost(0),
+  mStoreDaughterTracks(false)
 {
     mPicoNpeEvent = new StPicoNpeEvent();
 
@@ -35,6 +54,8 @@ StPicoNpeEventMaker::StPicoNpeEventMaker(char const* makerName, StPicoDstMaker*
     mTree->Branch("npeEvent", "StPicoNpeEvent", &mPicoNpeEvent, BufSize, Split);
 
     mPicoNpeHists = new StPicoNpeHists(fileBaseName);
+    mPrefilter = new StElectronPairPrefilter(cuts::prefilterMaxRadius, cuts::pairDca);
+    mPartnerGrid = new StElectronPartnerGrid();
 }
 
 //-----------------------------------------------------------------------------
@@ -43,6 +64,8 @@ StPicoNpeEventMaker::~StPicoNpeEventMaker()
     /* mTree is owned by mOutputFile directory, it will be destructed once
      * the file is closed in ::Finish() */
     delete mPicoNpeHists;
+    delete mPrefilter;
+    delete mPartnerGrid;
 }
 
 //-----------------------------------------------------------------------------
@@ -58,6 +81,15 @@ Int_t StPicoNpeEventMaker::Finish()
     mOutputFile->Write();
     mOutputFile->Close();
     mPicoNpeHists->closeFile();
+
+    LOG_INFO << "StPicoNpeEventMaker - " << mNPairCandidates << " electron x partner combinations, "
+             << mNPairsInWindow << " in the partner windows, "
+             << mNPrefilterRejected << " of them rejected by the prefilter" << endm;
+    if (mValidatePrefilter)
+    {
+        if (mNPrefilterLost) LOG_WARN << "StPicoNpeEventMaker - prefilter lost " << mNPrefilterLost << " accepted pairs" << endm;
+        else LOG_INFO << "StPicoNpeEventMaker - prefilter validation: no accepted pair lost" << endm;
+    }
     return kStOK;
 }
 //-----------------------------------------------------------------------------
@@ -88,6 +120,8 @@ Int_t StPicoNpeEventMaker::Make()
     if (isGoodEvent())
     {
         UInt_t nTracks = picoDst->numberOfTracks();
+        float const bField = mPicoEvent->bField();
+        mPrefilter->clear(mPicoEvent->primaryVertex(), bField, nTracks);
 
         std::vector<unsigned short> idxPicoTaggedEs;
         std::vector<unsigned short> idxPicoPartnerEs;
@@ -104,14 +138,30 @@ Int_t StPicoNpeEventMaker::Make()
             if (isElectron(trk))
             {
                 idxPicoTaggedEs.push_back(iTrack);
+                mPrefilter->addTrack(iTrack, *trk);
             }
 
-            if (isPartnerElectron(trk)) idxPicoPartnerEs.push_back(iTrack);
+            if (isPartnerElectron(trk))
+            {
+                idxPicoPartnerEs.push_back(iTrack);
+                mPrefilter->addTrack(iTrack, *trk);
+            }
         } // .. end tracks loop
 
         mPicoNpeEvent->nElectrons(idxPicoTaggedEs.size());
         mPicoNpeEvent->nPartners(idxPicoPartnerEs.size());
 
+        // partners binned by charge and direction, a tagged electron only visits the cells it can pair with
+        mPartnerGrid->clear();
+        for (unsigned short ip = 0; ip < idxPicoPartnerEs.size(); ++ip)
+        {
+            unsigned short const idx = idxPicoPartnerEs[ip];
+            mPartnerGrid->addPartner(ip, picoDst->track(idx)->charge(),
+                                     pseudoRapidity(mPrefilter->theta(idx)), mPrefilter->phi(idx));
+        }
+        std::vector<unsigned short> partners;
+        std::vector<unsigned short> idxDaughters;
+
         // Both loops start from 0 for electrons pairs.
         // The reason is that we want to double count those pairs for which
         // both tracks end up as tagged electrons tracks in the inclusicve
@@ -119,27 +169,58 @@ Int_t StPicoNpeEventMaker::Make()
         // NPE = Inclusive - Photonic/eff
         // where Inclusive and Photonic are both single tracks counting
         // -- Mustafa
-
-        float const bField = mPicoEvent->bField();
+        // The partner grid keeps this, every partner in the window is visited in order.
 
         for (unsigned short ik = 0; ik < idxPicoTaggedEs.size(); ++ik)
         {
 
             StPicoTrack const * electron = picoDst->track(idxPicoTaggedEs[ik]);
+            // the loosest pair mass cut of isGoodElectronPair for this electron
+            float const maxPairMass = electron->gPt() > cuts::pairHighPt ? std::max(cuts::pairMass, cuts::pairMassHigh) : cuts::pairMass;
+
+            float thetaMin, thetaMax, dPhi;
+            mPrefilter->partnerWindow(idxPicoTaggedEs[ik], maxPairMass, thetaMin, thetaMax, dPhi);
+            mPartnerGrid->findPartners(pseudoRapidity(thetaMax), pseudoRapidity(thetaMin),
+                                       mPrefilter->phi(idxPicoTaggedEs[ik]), dPhi, partners);
+            mNPairCandidates += idxPicoPartnerEs.size();
+            mNPairsInWindow += partners.size();
+
+            // the validation visits all partners
+            unsigned short const nPartners = mValidatePrefilter ? idxPicoPartnerEs.size() : partners.size();
 
             // make electron pairs
-            for (unsigned short ip = 0; ip < idxPicoPartnerEs.size(); ++ip)
+            for (unsigned short i = 0; i < nPartners; ++i)
             {
+                unsigned short const ip = mValidatePrefilter ? i : partners[i];
 
                 if (idxPicoTaggedEs[ik] == idxPicoPartnerEs[ip]) continue;
 
                 StPicoTrack const * partner = picoDst->track(idxPicoPartnerEs[ip]);
 
+                bool const inWindow = !mValidatePrefilter || std::binary_search(partners.begin(), partners.end(), ip);
+                bool const rejected = inWindow && mPrefilter->reject(idxPicoTaggedEs[ik], idxPicoPartnerEs[ip], maxPairMass);
+                if (rejected) ++mNPrefilterRejected;
+
+                if (!inWindow || rejected)
+                {
+                    if (mValidatePrefilter)
+                    {
+                        StElectronPair rejectedPair(electron, partner, idxPicoTaggedEs[ik], idxPicoPartnerEs[ip], bField);
+                        if (isGoodElectronPair(rejectedPair, electron->gPt())) ++mNPrefilterLost;
+                    }
+                    continue;
+                }
+
                 StElectronPair electronPair(electron, partner, idxPicoTaggedEs[ik], idxPicoPartnerEs[ip], bField);
 
                 if (!isGoodElectronPair(electronPair, electron->gPt())) continue;
 
                 mPicoNpeEvent->addElectronPair(&electronPair);
+                if (mStoreDaughterTracks)
+                {
+                    idxDaughters.push_back(idxPicoTaggedEs[ik]);
+                    idxDaughters.push_back(idxPicoPartnerEs[ip]);
+                }
 
                 if(electron->charge() * partner->charge() <0) // fill histograms for unlike sign pairs only
                 {
@@ -150,6 +231,8 @@ Int_t StPicoNpeEventMaker::Make()
             } // .. end make electron pairs
         } // .. end of tagged e loop
 
+        if (mStoreDaughterTracks) addDaughterTracks(picoDst, idxDaughters);
+
         mPicoNpeHists->addEvent(*mPicoEvent,*mPicoNpeEvent,nHftTracks);
         idxPicoTaggedEs.clear();
         idxPicoPartnerEs.clear();
@@ -163,6 +246,24 @@ Int_t StPicoNpeEventMaker::Make()
     return kStOK;
 }
 
+//-----------------------------------------------------------------------------
+void StPicoNpeEventMaker::addDaughterTracks(StPicoDst const * const picoDst, std::vector<unsigned short>& idx)
+{
+    // one snapshot per daughter, in increasing track index for StPicoNpeEvent::daughterTrack()
+    std::sort(idx.begin(), idx.end());
+    idx.erase(std::unique(idx.begin(), idx.end()), idx.end());
+
+    StThreeVectorF const pVtx = mPicoEvent->primaryVertex();
+    float const bField = mPicoEvent->bField();
+
+    for (unsigned short i = 0; i < idx.size(); ++i)
+    {
+        StPicoTrack const* trk = picoDst->track(idx[i]);
+        StPicoBTofPidTraits const* tofPid = trk->bTofPidTraitsIndex() >= 0 ? picoDst->btofPidTraits(trk->bTofPidTraitsIndex()) : NULL;
+
+        mPicoNpeEvent->addDaughterTrack(StPicoDaughterTrack(*trk, idx[i], pVtx, bField, tofPid));
+    }
+}
 //-----------------------------------------------------------------------------
 bool StPicoNpeEventMaker::isGoodEvent() const
 {
@@ -195,7 +296,7 @@ bool StPicoNpeEventMaker::isGoodElectronPair(StElectronPair const & epair, float
 {
     return
     (epair.pairMass() < cuts::pairMass || (epair.pairMass() < cuts::pairMassHigh && pt > cuts::pairHighPt)) &&
-    epair.pairDca() < cuts::pairDca &&
+    epair.rawPairDca() < cuts::pairDca &&
     fabs(epair.positionX()) < cuts::positionX &&
     fabs(epair.positionY()) < cuts::positionY &&
     fabs(epair.positionZ()) < cuts::positionZ;
@@ -210,6 +311,6 @@ bool  StPicoNpeEventMaker::isGoodQaElectronPair(StElectronPair  const& epair, St
     electron.nSigmaElectron() < cuts::qaNSigmaElectronMax && electron.nSigmaElectron() > cuts::qaNSigmaElectronMin &&
     partner.nSigmaElectron() < cuts::qaNSigmaElectronMax && partner.nSigmaElectron() > cuts::qaNSigmaElectronMin &&
 
-    epair.pairDca() < cuts::qaPairDca &&
+    epair.rawPairDca() < cuts::qaPairDca &&
     epair.pairMass() < cuts::qaPairMass;
 }
@@ -5,6 +5,17 @@
  *  A Maker that reads StPicoEvents' and creates 
  *  StPicoNpeEvents and stores them.
  *
+ *  Electron pairs which can not pass the pair cuts are
+ *  rejected by StElectronPairPrefilter before the helix
+ *  DCA, partners outside the window of a tagged electron
+ *  are not visited (StElectronPartnerGrid). With
+ *  setPrefilterValidation(true) all pairs are built and
+ *  the accepted ones among the rejected are counted as lost.
+ *
+ *  With setStoreDaughterTracks(true) a StPicoDaughterTrack
+ *  snapshot of the electrons and partners of the stored
+ *  pairs is written to the StPicoNpeEvent.
+ *
  *  Authors:  **Kunsu OH        (kunsuoh@gmail.com)
  *            Mustafa Mustafa (mmustafa@lbl.gov)
  *
@@ -12,15 +23,21 @@
  * **************************************************
  */
 
+#include <vector>
+
 #include "StMaker.h"
 
 class TTree;
 class TFile;
 class StPicoDstMaker;
+class StPicoDst;
 class StPicoEvent;
 class StPicoTrack;
 class StPicoNpeEvent;
 class StPicoNpeHists;
+class StElectronPair;
+class StElectronPairPrefilter;
+class StElectronPartnerGrid;
 
 class StPicoNpeEventMaker : public StMaker 
 {
@@ -32,6 +49,9 @@ class StPicoNpeEventMaker : public StMaker
     virtual Int_t Make();
     virtual void  Clear(Option_t *opt="");
     virtual Int_t Finish();
+
+    void setPrefilterValidation(bool validate);
+    void setStoreDaughterTracks(bool store);
     
   private:
     bool  isGoodEvent() const;
@@ -40,6 +60,7 @@ class StPicoNpeEventMaker : public StMaker
     bool  isPartnerElectron(StPicoTrack const*) const;
     bool  isGoodElectronPair(StElectronPair const &, float) const;
     bool  isGoodQaElectronPair(StElectronPair const&, StPicoTrack const&,StPicoTrack const&) const;
+    void  addDaughterTracks(StPicoDst const*, std::vector<unsigned short>& idx);
 
     StPicoDstMaker* mPicoDstMaker;
     StPicoEvent*    mPicoEvent;
@@ -49,7 +70,19 @@ class StPicoNpeEventMaker : public StMaker
     TTree* mTree;
     StPicoNpeEvent* mPicoNpeEvent;
 
+    StElectronPairPrefilter* mPrefilter;
+    StElectronPartnerGrid* mPartnerGrid;
+    bool mValidatePrefilter;
+    long long mNPairCandidates;
+    long long mNPairsInWindow;
+    long long mNPrefilterRejected;
+    long long mNPrefilterLost;    // rejected pairs which pass the pair cuts
+    bool mStoreDaughterTracks;
+
     ClassDef(StPicoNpeEventMaker, 0)
 };
 
+inline void StPicoNpeEventMaker::setPrefilterValidation(bool validate) { mValidatePrefilter = validate; }
+inline void StPicoNpeEventMaker::setStoreDaughterTracks(bool store) { mStoreDaughterTracks = store; }
+
 #endif
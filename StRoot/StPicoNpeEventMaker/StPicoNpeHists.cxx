@@ -19,7 +19,7 @@ StPicoNpeHists::StPicoNpeHists(TString fileBaseName) : mPrescales(NULL), mOutFil
 mh1TotalEventsInRun(NULL), mh1TotalHftTracksInRun(NULL), mh1TotalGRefMultInRun(NULL),
 mh2InvariantMassVsPt(NULL)
 {
-    mPrescales = new StPicoPrescales(cuts::prescalesFilesDirectoryName);
+    mPrescales = StPicoPrescales::instance(cuts::prescalesFilesDirectoryName);
     
     mOutFile = new TFile(Form("%s.picoNpe.hists.root",fileBaseName.Data()),"RECREATE");
     
@@ -46,7 +46,7 @@ mh2InvariantMassVsPt(NULL)
 }
 StPicoNpeHists::~StPicoNpeHists()
 {
-    delete mPrescales;
+    // mPrescales is shared and owned by StPicoPrescales
     // note that histograms are owned by mOutFile. They will be destructed
     // when the file is closed.
 }
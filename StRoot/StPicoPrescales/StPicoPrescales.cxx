@@ -2,7 +2,14 @@
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <mutex>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "TH1F.h"
 
@@ -13,36 +20,155 @@ using namespace std;
 
 ClassImp(StPicoPrescales);
 
-StPicoPrescales::StPicoPrescales(string prescalesFilesDirectoryName): 
-  mPrescalesFilesDirectoryName(prescalesFilesDirectoryName)
+namespace
+{
+  // binary table layout:
+  //   BinaryTableHeader
+  //   unsigned int triggerIds[nTriggers]
+  //   unsigned int runs[nRuns]              (sorted)
+  //   float        prescales[nRuns*nTriggers]
+  char const binaryTableMagic[8] = {'P','I','C','O','P','R','S','C'};
+  unsigned int const binaryTableVersion = 3;
+
+  struct BinaryTableHeader
+  {
+    char magic[8];
+    unsigned int version;
+    unsigned int nTriggers;
+    unsigned int nRuns;
+    unsigned int reserved;
+    unsigned long long listsStamp; // see listsStamp()
+  };
+
+  // FNV-1a steps
+  void hashByte(unsigned long long& hash, unsigned char byte)
+  {
+    hash ^= byte;
+    hash *= 1099511628211ULL;
+  }
+
+  void hashValue(unsigned long long& hash, unsigned long long value)
+  {
+    for(int iByte = 0; iByte < 8; ++iByte) hashByte(hash, (value >> (8 * iByte)) & 0xff);
+  }
+
+  map<string, StPicoPrescales*>& sharedTables()
+  {
+    static map<string, StPicoPrescales*> tables;
+    return tables;
+  }
+
+  std::mutex& sharedTablesMutex()
+  {
+    static std::mutex m;
+    return m;
+  }
+}
+
+StPicoPrescales::StPicoPrescales(string prescalesFilesDirectoryName, bool useBinaryTable):
+  mPrescalesFilesDirectoryName(prescalesFilesDirectoryName),
+  mRuns(NULL), mPrescales(NULL), mNRuns(0), mMappedTable(NULL), mMappedSize(0)
 {
 
   mTriggersIds = PicoPrescalesConstants::triggerId;
   std::copy(PicoPrescalesConstants::triggerIdMtd.begin(),PicoPrescalesConstants::triggerIdMtd.end(),std::back_inserter(mTriggersIds));
 
-  for(size_t iTrg=0;iTrg<mTriggersIds.size();++iTrg)
+  if(!useBinaryTable || !mapBinaryTable(binaryTableName(mPrescalesFilesDirectoryName)))
   {
-    readList(iTrg);
+    map<unsigned int, vecPrescales> table;
+    for(size_t iTrg=0;iTrg<mTriggersIds.size();++iTrg)
+    {
+      readList(iTrg, table);
+    }
+
+    mRunsBuffer.reserve(table.size());
+    mPrescalesBuffer.reserve(table.size() * mTriggersIds.size());
+    for (map<unsigned int,vecPrescales>::const_iterator it = table.begin(); it != table.end(); ++it)
+    {
+      mRunsBuffer.push_back(it->first);
+      mPrescalesBuffer.insert(mPrescalesBuffer.end(), it->second.begin(), it->second.end());
+    }
+
+    mNRuns = mRunsBuffer.size();
+    mRuns = mRunsBuffer.empty() ? NULL : &mRunsBuffer[0];
+    mPrescales = mPrescalesBuffer.empty() ? NULL : &mPrescalesBuffer[0];
   }
- 
+
   cout<<"StPicoPrescales -  Trigger list: "<<endl;
   for(size_t iTrg=0;iTrg<mTriggersIds.size();++iTrg)
   {
     cout<<iTrg<<"  "<<mTriggersIds[iTrg]<<endl;
   }
+}
+//___________________________________________
+StPicoPrescales::~StPicoPrescales()
+{
+  if(mMappedTable) munmap(mMappedTable, mMappedSize);
+}
+//___________________________________________
+StPicoPrescales* StPicoPrescales::instance(string prescalesFilesDirectoryName)
+{
+  std::lock_guard<std::mutex> lock(sharedTablesMutex());
+
+  map<string, StPicoPrescales*>& tables = sharedTables();
+  map<string, StPicoPrescales*>::iterator it = tables.find(prescalesFilesDirectoryName);
+
+  if(it != tables.end()) return it->second;
+
+  StPicoPrescales* prescales = new StPicoPrescales(prescalesFilesDirectoryName);
+  tables[prescalesFilesDirectoryName] = prescales;
+  return prescales;
+}
+//___________________________________________
+string StPicoPrescales::binaryTableName(string prescalesFilesDirectoryName)
+{
+  return prescalesFilesDirectoryName + "/prescales.bin";
+}
+//___________________________________________
+string StPicoPrescales::listFileName(unsigned int trg) const
+{
+  stringstream st;
+  st << mTriggersIds[trg];
+  return mPrescalesFilesDirectoryName + "/" + st.str() + ".txt";
+}
+//___________________________________________
+bool StPicoPrescales::listsStamp(unsigned long long& stamp) const
+{
+  // hash of the contents of all text lists, a binary table compiled from other
+  // lists does not match. Copies and fresh checkouts of the same lists do.
+  // Hashing the bytes is much cheaper than parsing the lists.
+  stamp = 14695981039346656037ULL;
+
+  for(size_t iTrg=0;iTrg<mTriggersIds.size();++iTrg)
+  {
+    ifstream list(listFileName(iTrg).c_str(), ios::in | ios::binary);
+    if(!list.is_open()) return false;
+
+    hashValue(stamp, mTriggersIds[iTrg]);
+
+    unsigned long long nBytes = 0;
+    char buffer[65536];
+    while(list.read(buffer, sizeof(buffer)) || list.gcount() > 0)
+    {
+      streamsize const n = list.gcount();
+      for(streamsize i = 0; i < n; ++i) hashByte(stamp, buffer[i]);
+      nBytes += n;
+    }
+
+    if(list.bad()) return false;
+    hashValue(stamp, nBytes);
+  }
 
-   mLastQuery = mTable.end();
+  return true;
 }
 //___________________________________________
-void StPicoPrescales::readList(unsigned int trg)
+void StPicoPrescales::readList(unsigned int trg, map<unsigned int, vecPrescales>& table)
 {
-   stringstream st;
-   st << mTriggersIds[trg];
-   string listFileName = mPrescalesFilesDirectoryName + "/" + st.str() + ".txt";
-   cout << "StPicoPrescales - Reading prescale values for trigger " << mTriggersIds[trg] << " from list " << listFileName << endl;
+   string const fileName = listFileName(trg);
+   cout << "StPicoPrescales - Reading prescale values for trigger " << mTriggersIds[trg] << " from list " << fileName << endl;
 
    //Open list
-   ifstream runs(listFileName.c_str());
+   ifstream runs(fileName.c_str());
 
    if(runs.is_open())
    {
@@ -64,13 +190,13 @@ void StPicoPrescales::readList(unsigned int trg)
        runBuffer >> run;
        prescaleBuffer >> prescale;
 
-       map<unsigned int, vecPrescales>::iterator it = mTable.find(run);
+       map<unsigned int, vecPrescales>::iterator it = table.find(run);
 
-       if (it == mTable.end())
+       if (it == table.end())
        {
          vecPrescales vec(mTriggersIds.size(), -1);
          vec[trg] = prescale;
-         mTable.insert(pair<unsigned int, vecPrescales>(run, vec));
+         table.insert(pair<unsigned int, vecPrescales>(run, vec));
        }
        else
        {
@@ -85,87 +211,161 @@ void StPicoPrescales::readList(unsigned int trg)
    }
    else
    {
-     cout << "StPicoPrescales -- !!! Cannot find file !!! :" << listFileName << endl;
+     cout << "StPicoPrescales -- !!! Cannot find file !!! :" << fileName << endl;
      exit(EXIT_FAILURE);
    }
 
    runs.close();
 }
+//___________________________________________
+bool StPicoPrescales::mapBinaryTable(string fileName)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if(fd < 0) return false;
 
+  struct stat st;
+  if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(BinaryTableHeader))
+  {
+    close(fd);
+    return false;
+  }
+
+  size_t const size = st.st_size;
+  void* table = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if(table == MAP_FAILED) return false;
+
+  BinaryTableHeader const* header = static_cast<BinaryTableHeader const*>(table);
+  unsigned int const* triggerIds = reinterpret_cast<unsigned int const*>(header + 1);
+
+  size_t const expectedSize = sizeof(BinaryTableHeader) +
+                              sizeof(unsigned int) * (header->nTriggers + header->nRuns) +
+                              sizeof(float) * header->nRuns * header->nTriggers;
+
+  bool good = memcmp(header->magic, binaryTableMagic, sizeof(binaryTableMagic)) == 0 &&
+              header->version == binaryTableVersion &&
+              header->nTriggers == mTriggersIds.size() &&
+              size == expectedSize &&
+              std::equal(mTriggersIds.begin(), mTriggersIds.end(), triggerIds);
+
+  if(!good)
+  {
+    cout << "StPicoPrescales - binary table " << fileName << " does not match the trigger list. Reading text lists instead." << endl;
+    munmap(table, size);
+    return false;
+  }
+
+  unsigned long long stamp = 0;
+  if(!listsStamp(stamp) || stamp != header->listsStamp)
+  {
+    cout << "StPicoPrescales - binary table " << fileName << " was compiled from other text lists, rerun compilePicoPrescales.C. Reading text lists instead." << endl;
+    munmap(table, size);
+    return false;
+  }
+
+  cout << "StPicoPrescales - Mapping prescale values from binary table " << fileName << endl;
+
+  mMappedTable = table;
+  mMappedSize = size;
+  mNRuns = header->nRuns;
+  mRuns = triggerIds + header->nTriggers;
+  mPrescales = reinterpret_cast<float const*>(mRuns + mNRuns);
+
+  return true;
+}
+//___________________________________________
+bool StPicoPrescales::writeBinaryTable(string fileName) const
+{
+  ofstream out(fileName.c_str(), ios::out | ios::binary | ios::trunc);
+
+  if(!out.is_open())
+  {
+    cout << "StPicoPrescales -- !!! Cannot open file for writing !!! :" << fileName << endl;
+    return false;
+  }
+
+  BinaryTableHeader header;
+  if(!listsStamp(header.listsStamp))
+  {
+    cout << "StPicoPrescales -- !!! Cannot read the text lists in !!! :" << mPrescalesFilesDirectoryName << endl;
+    return false;
+  }
+
+  memcpy(header.magic, binaryTableMagic, sizeof(binaryTableMagic));
+  header.version = binaryTableVersion;
+  header.nTriggers = mTriggersIds.size();
+  header.nRuns = mNRuns;
+  header.reserved = 0;
+
+  out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+  out.write(reinterpret_cast<char const*>(&mTriggersIds[0]), sizeof(unsigned int) * mTriggersIds.size());
+  if(mNRuns)
+  {
+    out.write(reinterpret_cast<char const*>(mRuns), sizeof(unsigned int) * mNRuns);
+    out.write(reinterpret_cast<char const*>(mPrescales), sizeof(float) * mNRuns * mTriggersIds.size());
+  }
+  out.close();
+
+  cout << "StPicoPrescales - Wrote " << mNRuns << " runs x " << mTriggersIds.size() << " triggers to " << fileName << endl;
+
+  return !out.fail();
+}
 //__________________________________
-float StPicoPrescales::prescale(unsigned int run, unsigned int trg)
+int StPicoPrescales::findRun(unsigned int run) const
 {
-   if(trg > mTriggersIds.size())
+   // no cache of the last run, the shared table is queried from several threads
+   unsigned int const* it = std::lower_bound(mRuns, mRuns + mNRuns, run);
+
+   if (it == mRuns + mNRuns || *it != run) return -1;
+
+   return it - mRuns;
+}
+//__________________________________
+float StPicoPrescales::prescale(unsigned int run, unsigned int trg) const
+{
+   if(trg >= mTriggersIds.size())
    {
      cout << "StPicoPrescales requested triggers doesn't exist. See StTRIGGERS.h for triggers definition." << endl;
      return -1;
    }
 
-   if (mLastQuery != mTable.end() && run == mLastQuery->first) return mLastQuery->second.at(trg);
-   else
+   int const idx = findRun(run);
+
+   if (idx < 0)
    {
-      map<unsigned int, vecPrescales>::iterator it = mTable.find(run);
-
-      if (it != mTable.end())
-      {
-         mLastQuery = it;
-         return it->second.at(trg);
-      }
-      else
-      {
-         cout << "StPicoPrescales::GetPrescale: No prescale values available for run " << run << ". Skip it." << endl;
-         return -1;
-      }
+      cout << "StPicoPrescales::GetPrescale: No prescale values available for run " << run << ". Skip it." << endl;
+      return -1;
    }
-}
 
-//__________________________________
-int StPicoPrescales::numberOfRuns() const
-{
-   return mTable.size();
+   return mPrescales[idx * mTriggersIds.size() + trg];
 }
+
 //__________________________________
-void StPicoPrescales::fillPrescalesHist(TH1F* hist, unsigned int trg)
+void StPicoPrescales::fillPrescalesHist(TH1F* hist, unsigned int trg) const
 {
    if(!hist) return;
 
-   if(trg > mTriggersIds.size())
+   if(trg >= mTriggersIds.size())
    {
      cout << "StPicoPrescales requested triggers doesn't exist. See StTRIGGERS.h for triggers definition." << endl;
      return;
    }
 
-   for (map<unsigned int,vecPrescales>::iterator it = mTable.begin(); it != mTable.end(); ++it)
+   for (unsigned int iRun = 0; iRun < mNRuns; ++iRun)
    {
-      hist->Fill(std::distance(mTable.begin(), it), it->second.at(trg));
+      hist->Fill(iRun, mPrescales[iRun * mTriggersIds.size() + trg]);
    }
 }
 //___________________________________
-unsigned int StPicoPrescales::runIndex(unsigned int run)
+unsigned int StPicoPrescales::runIndex(unsigned int run) const
 {
-   if (mLastQuery != mTable.end() && run == mLastQuery->first) return std::distance(mTable.begin(), mLastQuery);
-   else
-   {
-      map<unsigned int, vecPrescales>::iterator it = mTable.find(run);
-      mLastQuery = it;
-      return std::distance(mTable.begin(), it);
-   }
+   int const idx = findRun(run);
+   return idx < 0 ? mNRuns : idx;
 }
 
 //___________________________________
-bool StPicoPrescales::runExists(unsigned int run)
+bool StPicoPrescales::runExists(unsigned int run) const
 {
-   if (mLastQuery != mTable.end() && run == mLastQuery->first) return true;
-   else
-   {
-      map<unsigned int, vecPrescales>::iterator it = mTable.find(run);
-
-      if (it != mTable.end())
-      {
-         mLastQuery = it;
-         return true;
-      }
-      else return false;
-   }
+   return findRun(run) >= 0;
 }
-
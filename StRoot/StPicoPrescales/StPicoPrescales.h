@@ -1,11 +1,22 @@
-/* 
- * This is a utility class which has a lookup table 
+/*
+ * This is a utility class which has a lookup table
  * of precsales for different triggers and runs.
  *
  * Table is constructed from lists. Constructor
- * expects to find lists for all triggers defined in 
+ * expects to find lists for all triggers defined in
  * StPicoDstMaker/StPicoConstants.cxx
  *
+ * If the lists directory contains a binary table
+ * (see writeBinaryTable() and macros/compilePicoPrescales.C)
+ * with the same trigger list, compiled from lists with the
+ * same contents, the table is mmap'ed read-only instead of
+ * parsing the text lists. A stale table is ignored and the
+ * text lists are read.
+ *
+ * Use StPicoPrescales::instance(dir) to share one table
+ * between all makers of the process. The table is read-only
+ * after construction, queries are safe from several threads.
+ *
  * Author: Mustafa Mustafa (mmustafa@lbl.gov)
  */
 
@@ -23,27 +34,48 @@ class TH1F;
 class StPicoPrescales : public TObject
 {
   public:
-    StPicoPrescales(std::string prescalesFilesDirectoryName);
-    virtual ~StPicoPrescales(){}
+    StPicoPrescales(std::string prescalesFilesDirectoryName, bool useBinaryTable = true);
+    virtual ~StPicoPrescales();
+
+    // shared, process wide, table for a given directory. Owned by StPicoPrescales, do not delete.
+    static StPicoPrescales* instance(std::string prescalesFilesDirectoryName);
+    static std::string binaryTableName(std::string prescalesFilesDirectoryName);
 
-    float prescale(unsigned int run,unsigned int trg);
-    unsigned int runIndex(unsigned int run);
-    bool runExists(unsigned int run);
+    float prescale(unsigned int run,unsigned int trg) const;
+    unsigned int runIndex(unsigned int run) const;
+    bool runExists(unsigned int run) const;
     int numberOfRuns() const;
-    void fillPrescalesHist(TH1F*,unsigned int trg);
+    void fillPrescalesHist(TH1F*,unsigned int trg) const;
+
+    bool writeBinaryTable(std::string fileName) const;
+    bool isMapped() const;
 
   private:
+    typedef std::vector<float> vecPrescales;
+
     std::string mPrescalesFilesDirectoryName;
     std::vector<unsigned int> mTriggersIds;
-    typedef std::vector<float> vecPrescales;
-    std::map<unsigned int,vecPrescales> mTable;
-    std::map<unsigned int,vecPrescales>::iterator mLastQuery;
 
-    void readList(unsigned int trg);
+    // table storage: either the buffers below or an mmap'ed binary table
+    std::vector<unsigned int> mRunsBuffer; //!
+    std::vector<float> mPrescalesBuffer;   //!
+    unsigned int const* mRuns;             //! sorted run numbers
+    float const* mPrescales;               //! [runIndex*nTriggers + trg]
+    unsigned int mNRuns;
+    void* mMappedTable;                    //!
+    size_t mMappedSize;                    //!
+
+    std::string listFileName(unsigned int trg) const;
+    bool listsStamp(unsigned long long& stamp) const;
+    void readList(unsigned int trg, std::map<unsigned int,vecPrescales>& table);
+    bool mapBinaryTable(std::string fileName);
+    int  findRun(unsigned int run) const;
 
-    ClassDef(StPicoPrescales,1)
+    ClassDef(StPicoPrescales,3)
 };
 
+inline int StPicoPrescales::numberOfRuns() const { return mNRuns; }
+inline bool StPicoPrescales::isMapped() const { return mMappedTable != NULL; }
+
 #endif
 #endif	/* StPRESCALES_H */
-